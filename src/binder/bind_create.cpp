@@ -32,6 +32,7 @@
 #include "binder/expressions/bound_constant.h"
 #include "binder/expressions/bound_star.h"
 #include "binder/expressions/bound_unary_op.h"
+#include "binder/statement/analyze_statement.h"
 #include "binder/statement/create_statement.h"
 #include "binder/statement/index_statement.h"
 #include "binder/statement/select_statement.h"
@@ -112,7 +113,33 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
     throw bustub::Exception("should have at least 1 column");
   }
 
-  return std::make_unique<CreateStatement>(std::move(table), std::move(columns));
+  auto format = TableFormat::ROW;
+  if (pg_stmt->options != nullptr) {
+    for (auto c = pg_stmt->options->head; c != nullptr; c = lnext(c)) {
+      auto def = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(c->data.ptr_value);
+      if (def->defname == nullptr || std::string(def->defname) != "storage" || def->arg == nullptr) {
+        throw NotImplementedException("only the storage option is supported");
+      }
+      // `storage = pax` is parsed as a type name, `storage = 'pax'` as a string.
+      std::string storage;
+      if (def->arg->type == duckdb_libpgquery::T_PGTypeName) {
+        auto type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(def->arg);
+        storage = reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str;
+      } else if (def->arg->type == duckdb_libpgquery::T_PGString) {
+        storage = reinterpret_cast<duckdb_libpgquery::PGValue *>(def->arg)->val.str;
+      }
+      storage = StringUtil::Lower(storage);
+      if (storage == "row") {
+        format = TableFormat::ROW;
+      } else if (storage == "pax") {
+        format = TableFormat::PAX;
+      } else {
+        throw bustub::Exception(fmt::format("unknown storage format: {}", storage));
+      }
+    }
+  }
+
+  return std::make_unique<CreateStatement>(std::move(table), std::move(columns), format);
 }
 
 auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement> {
@@ -132,4 +159,26 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
   return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
 }
 
+auto Binder::BindAnalyze(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<AnalyzeStatement> {
+  if ((stmt->options & duckdb_libpgquery::PG_VACOPT_VACUUM) != 0) {
+    throw NotImplementedException("VACUUM is not supported");
+  }
+  if (stmt->va_cols != nullptr) {
+    throw NotImplementedException("ANALYZE of some columns is not supported");
+  }
+
+  std::vector<std::unique_ptr<BoundBaseTableRef>> tables;
+  if (stmt->relation != nullptr) {
+    tables.emplace_back(BindBaseTableRef(stmt->relation->relname, std::nullopt));
+  } else {
+    for (auto &table_name : catalog_.GetTableNames()) {
+      // Names beginning with `__` are reserved for the system.
+      if (!StringUtil::StartsWith(table_name, "__")) {
+        tables.emplace_back(BindBaseTableRef(table_name, std::nullopt));
+      }
+    }
+  }
+  return std::make_unique<AnalyzeStatement>(std::move(tables));
+}
+
 }  // namespace bustub
@@ -0,0 +1,111 @@
+#include <cctype>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/binder.h"
+#include "binder/bound_expression.h"
+#include "binder/expressions/bound_constant.h"
+#include "binder/statement/prepare_statement.h"
+#include "common/exception.h"
+#include "common/util/string_util.h"
+
+namespace bustub {
+
+namespace {
+
+/**
+ * @return the text of the query in `PREPARE name [(types)] AS query`. The tokenizer cannot be used while the parse tree
+ * is alive, so the statement, which already parsed, is scanned by hand.
+ */
+auto PreparedQueryText(const std::string &statement) -> std::optional<std::string> {
+  size_t pos = 0;
+  auto skip_spaces = [&] {
+    while (pos < statement.size() && std::isspace(static_cast<unsigned char>(statement[pos])) != 0) {
+      pos++;
+    }
+  };
+  auto skip_keyword = [&](const std::string &keyword) {
+    skip_spaces();
+    if (StringUtil::Lower(statement.substr(pos, keyword.size())) != keyword) {
+      return false;
+    }
+    pos += keyword.size();
+    return true;
+  };
+
+  if (!skip_keyword("prepare")) {
+    return std::nullopt;
+  }
+  skip_spaces();
+  if (pos < statement.size() && statement[pos] == '"') {
+    pos = statement.find('"', pos + 1);
+    if (pos == std::string::npos) {
+      return std::nullopt;
+    }
+    pos++;
+  } else {
+    while (pos < statement.size() && (std::isalnum(static_cast<unsigned char>(statement[pos])) != 0 ||
+                                      statement[pos] == '_' || statement[pos] == '$')) {
+      pos++;
+    }
+  }
+  skip_spaces();
+  if (pos < statement.size() && statement[pos] == '(') {
+    for (int depth = 0; pos < statement.size(); pos++) {
+      depth += statement[pos] == '(' ? 1 : statement[pos] == ')' ? -1 : 0;
+      if (depth == 0) {
+        pos++;
+        break;
+      }
+    }
+  }
+  if (!skip_keyword("as")) {
+    return std::nullopt;
+  }
+  return statement.substr(pos);
+}
+
+}  // namespace
+
+auto Binder::BindPrepare(duckdb_libpgquery::PGPrepareStmt *stmt) -> std::unique_ptr<PrepareStatement> {
+  std::vector<TypeId> parameter_types;
+  if (stmt->argtypes != nullptr) {
+    for (auto node = stmt->argtypes->head; node != nullptr; node = node->next) {
+      auto *type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(node->data.ptr_value);
+      auto name =
+          std::string(reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str);
+      if (name == "int4") {
+        parameter_types.push_back(TypeId::INTEGER);
+      } else if (name == "varchar") {
+        parameter_types.push_back(TypeId::VARCHAR);
+      } else {
+        throw NotImplementedException(fmt::format("unsupported parameter type: {}", name));
+      }
+    }
+  }
+
+  // The query is kept as text, and bound on execution once the types of the parameters are known.
+  auto query = PreparedQueryText(statement_text_);
+  if (!query.has_value()) {
+    throw bustub::Exception("cannot find the query of the prepared statement");
+  }
+  return std::make_unique<PrepareStatement>(stmt->name, std::move(*query), std::move(parameter_types));
+}
+
+auto Binder::BindExecute(duckdb_libpgquery::PGExecuteStmt *stmt) -> std::unique_ptr<ExecuteStatement> {
+  std::vector<Value> parameters;
+  if (stmt->params != nullptr) {
+    for (const auto &expr : BindExpressionList(stmt->params)) {
+      if (expr->type_ != ExpressionType::CONSTANT) {
+        throw NotImplementedException("only constant parameters are supported");
+      }
+      parameters.push_back(dynamic_cast<const BoundConstant &>(*expr).val_);
+    }
+  }
+  return std::make_unique<ExecuteStatement>(stmt->name, std::move(parameters));
+}
+
+}  // namespace bustub
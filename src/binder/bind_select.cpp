@@ -14,7 +14,9 @@
 #include "binder/expressions/bound_column_ref.h"
 #include "binder/expressions/bound_constant.h"
 #include "binder/expressions/bound_func_call.h"
+#include "binder/expressions/bound_parameter.h"
 #include "binder/expressions/bound_star.h"
+#include "binder/expressions/bound_subquery_expr.h"
 #include "binder/expressions/bound_unary_op.h"
 #include "binder/statement/explain_statement.h"
 #include "binder/statement/select_statement.h"
@@ -467,6 +469,14 @@ auto Binder::BindConstant(duckdb_libpgquery::PGAConst *node) -> std::unique_ptr<
   throw bustub::Exception(fmt::format("unsupported pg value: {}", Binder::NodeTagToString(val.type)));
 }
 
+auto Binder::BindParamRef(duckdb_libpgquery::PGParamRef *node) -> std::unique_ptr<BoundExpression> {
+  BUSTUB_ASSERT(node, "nullptr");
+  if (node->number < 1 || static_cast<size_t>(node->number) > parameter_types_.size()) {
+    throw bustub::Exception(fmt::format("no value for parameter ${}", node->number));
+  }
+  return std::make_unique<BoundParameter>(node->number - 1, parameter_types_[node->number - 1]);
+}
+
 auto Binder::BindColumnRef(duckdb_libpgquery::PGColumnRef *node) -> std::unique_ptr<BoundExpression> {
   BUSTUB_ASSERT(node, "nullptr");
   auto fields = node->fields;
@@ -480,7 +490,28 @@ auto Binder::BindColumnRef(duckdb_libpgquery::PGColumnRef *node) -> std::unique_
       for (auto node = fields->head; node != nullptr; node = node->next) {
         column_names.emplace_back(reinterpret_cast<duckdb_libpgquery::PGValue *>(node->data.ptr_value)->val.str);
       }
-      return ResolveColumn(*scope_, column_names);
+      if (outer_scopes_.empty()) {
+        return ResolveColumn(*scope_, column_names);
+      }
+      // In a subquery, columns the subquery does not have are looked up in the enclosing queries, innermost first.
+      std::unique_ptr<BoundExpression> expr = nullptr;
+      if (scope_->type_ != TableReferenceType::EMPTY) {
+        expr = ResolveColumnInternal(*scope_, column_names);
+      }
+      for (auto i = outer_scopes_.size(); expr == nullptr && i > 0; i--) {
+        const auto *outer_scope = outer_scopes_[i - 1];
+        if (outer_scope != nullptr && outer_scope->type_ != TableReferenceType::EMPTY) {
+          expr = ResolveColumnInternal(*outer_scope, column_names);
+        }
+        if (expr != nullptr) {
+          // Every subquery between the column and the reference is correlated.
+          std::fill(correlated_.begin() + i - 1, correlated_.end(), true);
+        }
+      }
+      if (expr == nullptr) {
+        throw bustub::Exception(fmt::format("column {} not found", fmt::join(column_names, ".")));
+      }
+      return expr;
     }
     case duckdb_libpgquery::T_PGAStar: {
       return BindStar(reinterpret_cast<duckdb_libpgquery::PGAStar *>(head_node));
@@ -622,7 +653,7 @@ auto Binder::ResolveColumnRefFromSubqueryRef(const BoundSubqueryRef &subquery_re
     -> std::unique_ptr<BoundColumnRef> {
   // Firstly, try directly resolve the column name through schema
   std::unique_ptr<BoundColumnRef> direct_resolved_expr = BoundColumnRef::Prepend(
-      ResolveColumnRefFromSelectList(subquery_ref.select_list_name_, col_name), subquery_ref.alias_);
+      ResolveColumnRefFromSelectList(subquery_ref.select_list_name_, col_name), alias);
 
   std::unique_ptr<BoundColumnRef> strip_resolved_expr = nullptr;
 
@@ -632,7 +663,7 @@ auto Binder::ResolveColumnRefFromSubqueryRef(const BoundSubqueryRef &subquery_re
       auto strip_column_name = col_name;
       strip_column_name.erase(strip_column_name.begin());
       strip_resolved_expr = BoundColumnRef::Prepend(
-          ResolveColumnRefFromSelectList(subquery_ref.select_list_name_, strip_column_name), subquery_ref.alias_);
+          ResolveColumnRefFromSelectList(subquery_ref.select_list_name_, strip_column_name), alias);
     }
   }
 
@@ -783,6 +814,47 @@ auto Binder::BindBoolExpr(duckdb_libpgquery::PGBoolExpr *root) -> std::unique_pt
   UNREACHABLE("We should have handled all cases!");
 }
 
+auto Binder::BindSubLink(duckdb_libpgquery::PGSubLink *root) -> std::unique_ptr<BoundExpression> {
+  BUSTUB_ASSERT(root, "nullptr");
+  SubqueryType subquery_type;
+  std::unique_ptr<BoundExpression> arg = nullptr;
+  switch (root->subLinkType) {
+    case duckdb_libpgquery::PG_EXISTS_SUBLINK:
+      subquery_type = SubqueryType::EXISTS;
+      break;
+    case duckdb_libpgquery::PG_EXPR_SUBLINK:
+      subquery_type = SubqueryType::SCALAR;
+      break;
+    case duckdb_libpgquery::PG_ANY_SUBLINK: {
+      // `x IN (SELECT ...)` has no operator name, `x op ANY (SELECT ...)` has one.
+      if (root->operName != nullptr) {
+        auto op_name =
+            std::string(reinterpret_cast<duckdb_libpgquery::PGValue *>(root->operName->head->data.ptr_value)->val.str);
+        if (op_name != "=") {
+          throw NotImplementedException(fmt::format("{} ANY subquery is not supported", op_name));
+        }
+      }
+      subquery_type = SubqueryType::IN;
+      arg = BindExpression(root->testexpr);
+      break;
+    }
+    default:
+      throw NotImplementedException(fmt::format("subquery type {} not supported", static_cast<int>(root->subLinkType)));
+  }
+
+  outer_scopes_.push_back(scope_);
+  correlated_.push_back(false);
+  auto subquery = BindSelect(reinterpret_cast<duckdb_libpgquery::PGSelectStmt *>(root->subselect));
+  bool is_correlated = correlated_.back();
+  outer_scopes_.pop_back();
+  correlated_.pop_back();
+
+  if (subquery_type != SubqueryType::EXISTS && subquery->select_list_.size() != 1) {
+    throw bustub::Exception("subquery must return only one column");
+  }
+  return std::make_unique<BoundSubqueryExpr>(subquery_type, std::move(subquery), std::move(arg), is_correlated);
+}
+
 auto Binder::BindExpression(duckdb_libpgquery::PGNode *node) -> std::unique_ptr<BoundExpression> {
   BUSTUB_ASSERT(node, "nullptr");
   switch (node->type) {
@@ -790,6 +862,8 @@ auto Binder::BindExpression(duckdb_libpgquery::PGNode *node) -> std::unique_ptr<
       return BindColumnRef(reinterpret_cast<duckdb_libpgquery::PGColumnRef *>(node));
     case duckdb_libpgquery::T_PGAConst:
       return BindConstant(reinterpret_cast<duckdb_libpgquery::PGAConst *>(node));
+    case duckdb_libpgquery::T_PGParamRef:
+      return BindParamRef(reinterpret_cast<duckdb_libpgquery::PGParamRef *>(node));
     case duckdb_libpgquery::T_PGResTarget:
       return BindResTarget(reinterpret_cast<duckdb_libpgquery::PGResTarget *>(node));
     case duckdb_libpgquery::T_PGAStar:
@@ -800,6 +874,8 @@ auto Binder::BindExpression(duckdb_libpgquery::PGNode *node) -> std::unique_ptr<
       return BindAExpr(reinterpret_cast<duckdb_libpgquery::PGAExpr *>(node));
     case duckdb_libpgquery::T_PGBoolExpr:
       return BindBoolExpr(reinterpret_cast<duckdb_libpgquery::PGBoolExpr *>(node));
+    case duckdb_libpgquery::T_PGSubLink:
+      return BindSubLink(reinterpret_cast<duckdb_libpgquery::PGSubLink *>(node));
     default:
       break;
   }
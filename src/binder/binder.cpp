@@ -22,6 +22,7 @@
 
 #include <iostream>
 #include <unordered_set>
+#include <utility>
 
 #include "binder/binder.h"
 #include "binder/bound_statement.h"
@@ -42,7 +43,11 @@ namespace bustub {
 
 Binder::Binder(const Catalog &catalog) : catalog_(catalog) {}
 
+Binder::Binder(const Catalog &catalog, std::vector<TypeId> parameter_types)
+    : catalog_(catalog), parameter_types_(std::move(parameter_types)) {}
+
 void Binder::ParseAndSave(const std::string &query) {
+  query_ = query;
   parser_.Parse(query);
   if (!parser_.success) {
     LOG_INFO("Query failed to parse!");
@@ -1,6 +1,7 @@
 #include "binder/bound_order_by.h"
 #include "binder/expressions/bound_agg_call.h"
 #include "binder/expressions/bound_func_call.h"
+#include "binder/expressions/bound_subquery_expr.h"
 #include "binder/statement/select_statement.h"
 #include "binder/table_ref/bound_cte_ref.h"
 #include "binder/table_ref/bound_expression_list_ref.h"
@@ -20,6 +21,18 @@ auto BoundAggCall::ToString() const -> std::string {
   return fmt::format("{}({})", func_name_, args_);
 }
 
+auto BoundSubqueryExpr::ToString() const -> std::string {
+  auto subquery = StringUtil::IndentAllLines(subquery_->ToString(), 2, true);
+  switch (subquery_type_) {
+    case SubqueryType::EXISTS:
+      return fmt::format("exists({})", subquery);
+    case SubqueryType::IN:
+      return fmt::format("({} in {})", arg_, subquery);
+    default:
+      return fmt::format("({})", subquery);
+  }
+}
+
 auto BoundExpressionListRef::ToString() const -> std::string {
   return fmt::format("BoundExpressionListRef {{ identifier={}, values={} }}", identifier_, values_);
 }
@@ -0,0 +1,14 @@
+#include "binder/statement/analyze_statement.h"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+
+namespace bustub {
+
+AnalyzeStatement::AnalyzeStatement(std::vector<std::unique_ptr<BoundBaseTableRef>> tables)
+    : BoundStatement(StatementType::ANALYZE_STATEMENT), tables_(std::move(tables)) {}
+
+auto AnalyzeStatement::ToString() const -> std::string {
+  return fmt::format("BoundAnalyze {{ tables={} }}", tables_);
+}
+
+}  // namespace bustub
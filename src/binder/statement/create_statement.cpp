@@ -5,10 +5,16 @@
 
 namespace bustub {
 
-CreateStatement::CreateStatement(std::string table, std::vector<Column> columns)
-    : BoundStatement(StatementType::CREATE_STATEMENT), table_(std::move(table)), columns_(std::move(columns)) {}
+CreateStatement::CreateStatement(std::string table, std::vector<Column> columns, TableFormat format)
+    : BoundStatement(StatementType::CREATE_STATEMENT),
+      table_(std::move(table)),
+      columns_(std::move(columns)),
+      format_(format) {}
 
 auto CreateStatement::ToString() const -> std::string {
+  if (format_ == TableFormat::PAX) {
+    return fmt::format("BoundCreate {{\n  table={}\n  columns={}\n  storage=pax\n}}", table_, columns_);
+  }
   return fmt::format("BoundCreate {{\n  table={}\n  columns={}\n}}", table_, columns_);
 }
 
@@ -21,15 +21,19 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <string>
+#include <vector>
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
 #include "binder/bound_order_by.h"
 #include "binder/bound_statement.h"
+#include "binder/statement/analyze_statement.h"
 #include "binder/statement/create_statement.h"
 #include "binder/statement/delete_statement.h"
 #include "binder/statement/explain_statement.h"
 #include "binder/statement/index_statement.h"
 #include "binder/statement/insert_statement.h"
+#include "binder/statement/prepare_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/update_statement.h"
 #include "binder/table_ref/bound_base_table_ref.h"
@@ -42,6 +46,27 @@
 
 namespace bustub {
 
+namespace {
+
+auto RawStatementText(const std::string &query, const duckdb_libpgquery::PGRawStmt *raw_stmt) -> std::string {
+  if (raw_stmt->stmt_location < 0 || static_cast<size_t>(raw_stmt->stmt_location) > query.size()) {
+    return query;
+  }
+  return raw_stmt->stmt_len == 0 ? query.substr(raw_stmt->stmt_location)
+                                 : query.substr(raw_stmt->stmt_location, raw_stmt->stmt_len);
+}
+
+}  // namespace
+
+auto Binder::StatementTexts() const -> std::vector<std::string> {
+  std::vector<std::string> texts;
+  for (auto *stmt : statement_nodes_) {
+    BUSTUB_ASSERT(stmt->type == duckdb_libpgquery::T_PGRawStmt, "the parser returns raw statements");
+    texts.emplace_back(RawStatementText(query_, reinterpret_cast<duckdb_libpgquery::PGRawStmt *>(stmt)));
+  }
+  return texts;
+}
+
 void Binder::SaveParseTree(duckdb_libpgquery::PGList *tree) {
   std::vector<std::unique_ptr<BoundStatement>> statements;
   for (auto entry = tree->head; entry != nullptr; entry = entry->next) {
@@ -51,8 +76,11 @@ void Binder::SaveParseTree(duckdb_libpgquery::PGList *tree) {
 
 auto Binder::BindStatement(duckdb_libpgquery::PGNode *stmt) -> std::unique_ptr<BoundStatement> {
   switch (stmt->type) {
-    case duckdb_libpgquery::T_PGRawStmt:
-      return BindStatement(reinterpret_cast<duckdb_libpgquery::PGRawStmt *>(stmt)->stmt);
+    case duckdb_libpgquery::T_PGRawStmt: {
+      auto *raw_stmt = reinterpret_cast<duckdb_libpgquery::PGRawStmt *>(stmt);
+      statement_text_ = RawStatementText(query_, raw_stmt);
+      return BindStatement(raw_stmt->stmt);
+    }
     case duckdb_libpgquery::T_PGCreateStmt:
       return BindCreate(reinterpret_cast<duckdb_libpgquery::PGCreateStmt *>(stmt));
     case duckdb_libpgquery::T_PGInsertStmt:
@@ -67,10 +95,16 @@ auto Binder::BindStatement(duckdb_libpgquery::PGNode *stmt) -> std::unique_ptr<B
       return BindUpdate(reinterpret_cast<duckdb_libpgquery::PGUpdateStmt *>(stmt));
     case duckdb_libpgquery::T_PGIndexStmt:
       return BindIndex(reinterpret_cast<duckdb_libpgquery::PGIndexStmt *>(stmt));
+    case duckdb_libpgquery::T_PGVacuumStmt:
+      return BindAnalyze(reinterpret_cast<duckdb_libpgquery::PGVacuumStmt *>(stmt));
     case duckdb_libpgquery::T_PGVariableSetStmt:
       return BindVariableSet(reinterpret_cast<duckdb_libpgquery::PGVariableSetStmt *>(stmt));
     case duckdb_libpgquery::T_PGVariableShowStmt:
       return BindVariableShow(reinterpret_cast<duckdb_libpgquery::PGVariableShowStmt *>(stmt));
+    case duckdb_libpgquery::T_PGPrepareStmt:
+      return BindPrepare(reinterpret_cast<duckdb_libpgquery::PGPrepareStmt *>(stmt));
+    case duckdb_libpgquery::T_PGExecuteStmt:
+      return BindExecute(reinterpret_cast<duckdb_libpgquery::PGExecuteStmt *>(stmt));
     default:
       throw NotImplementedException(NodeTagToString(stmt->type));
   }
@@ -12,6 +12,8 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+
 #include "common/exception.h"
 #include "common/macros.h"
 #include "storage/page/page_guard.h"
@@ -38,31 +40,16 @@ BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager
 BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
 
 auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
-  auto lock = std::lock_guard<std::mutex>(latch_);
+  auto lock = std::unique_lock<std::mutex>(latch_);
   *page_id = AllocatePage();
-  Page *page = nullptr;
-  frame_id_t frame_id = -1;
-
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-    page = &pages_[frame_id];
-    BUSTUB_ASSERT(page->page_id_ == INVALID_PAGE_ID, "The page id of free frame is not INVALID_PAGE_ID");
-  } else if (replacer_->Size() > 0) {
-    replacer_->Evict(&frame_id);
-    BUSTUB_ASSERT(frame_id != -1, "Evict error");
-    page = &pages_[frame_id];
-    if (page->is_dirty_) {
-      disk_manager_->WritePage(page->page_id_, page->data_);
-      page->is_dirty_ = false;
-    }
-    page->ResetMemory();
-    page_table_.erase(page->page_id_);
-  } else {
+  frame_id_t frame_id = AcquireFrame(&lock);
+  if (frame_id == -1) {
     return nullptr;
   }
+  Page *page = &pages_[frame_id];
   page->page_id_ = *page_id;
   page->pin_count_ = 1;
+  page->rec_lsn_ = NextLSN();
   replacer_->RecordAccess(frame_id);
   page_table_.emplace(*page_id, frame_id);
 
@@ -70,41 +57,36 @@ auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
 }
 
 auto BufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type) -> Page * {
-  auto lock = std::lock_guard<std::mutex>(latch_);
+  auto lock = std::unique_lock<std::mutex>(latch_);
   frame_id_t frame_id = -1;
   Page *page = nullptr;
 
-  if (page_table_.count(page_id) != 0) {
-    frame_id = page_table_[page_id];
-    page = &pages_[frame_id];
-    ++(page->pin_count_);
-    replacer_->RecordAccess(frame_id, access_type);
-    return page;
-  }
-
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-    page = &pages_[frame_id];
-    BUSTUB_ASSERT(page->page_id_ == INVALID_PAGE_ID, "The page id of free frame is not INVALID_PAGE_ID");
-  } else if (replacer_->Size() > 0) {
-    replacer_->Evict(&frame_id);
-    BUSTUB_ASSERT(frame_id != -1, "Evict error");
-    page = &pages_[frame_id];
-    if (page->is_dirty_) {
-      disk_manager_->WritePage(page->page_id_, page->data_);
-      page->is_dirty_ = false;
+  if (page_table_.count(page_id) == 0) {
+    frame_id = AcquireFrame(&lock);
+    if (frame_id == -1) {
+      return nullptr;
     }
-    disk_manager_->ReadPage(page_id, page->data_);
-    page_table_.erase(page->page_id_);
-  } else {
-    return nullptr;
+    if (page_table_.count(page_id) == 0) {
+      page = &pages_[frame_id];
+      disk_manager_->ReadPage(page_id, page->data_);
+      page->page_id_ = page_id;
+      page->pin_count_ = 1;
+      page->rec_lsn_ = NextLSN();
+      replacer_->RecordAccess(frame_id, access_type);
+      page_table_.emplace(page_id, frame_id);
+      return page;
+    }
+    // Another thread read the page while the latch was released.
+    free_list_.push_back(frame_id);
   }
 
-  page->page_id_ = page_id;
-  page->pin_count_ = 1;
+  frame_id = page_table_[page_id];
+  page = &pages_[frame_id];
+  if (page->pin_count_ == 0 && !page->is_dirty_) {
+    page->rec_lsn_ = NextLSN();
+  }
+  ++(page->pin_count_);
   replacer_->RecordAccess(frame_id, access_type);
-  page_table_.emplace(page_id, frame_id);
   return page;
 }
 
@@ -121,7 +103,11 @@ auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, AccessType a
   }
 
   --(page->pin_count_);
-  page->is_dirty_ = is_dirty;
+  page->is_dirty_ = page->is_dirty_ || is_dirty;
+  if (is_dirty && log_manager_ != nullptr) {
+    // The changes made under this pin were logged before the page was unpinned.
+    page->page_lsn_ = log_manager_->GetNextLSN() - 1;
+  }
 
   if (page->pin_count_ == 0) {
     replacer_->SetEvictable(frame_id, true);
@@ -130,48 +116,68 @@ auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, AccessType a
 }
 
 auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
-  auto lock = std::lock_guard<std::mutex>(latch_);
-  if (page_table_.count(page_id) == 0) {
-    return false;
+  auto lock = std::unique_lock<std::mutex>(latch_);
+  while (true) {
+    if (page_table_.count(page_id) == 0) {
+      return false;
+    }
+    Page *page = &pages_[page_table_[page_id]];
+    BUSTUB_ASSERT(page_id == page->page_id_, "Page table and frame disagree on the page id");
+    if (auto lsn = UnflushedLSN(page); lsn != INVALID_LSN) {
+      ForceLog(&lock, lsn);
+      continue;
+    }
+    WritePageBack(page);
+    return true;
   }
-  frame_id_t frame_id = page_table_[page_id];
-  Page *page = &pages_[frame_id];
-
-  BUSTUB_ASSERT(page_id == page->page_id_, page_id != page->page_id_);
-  disk_manager_->WritePage(page_id, page->data_);
-  page->is_dirty_ = false;
-
-  return true;
 }
 
 void BufferPoolManager::FlushAllPages() {
-  auto lock = std::lock_guard<std::mutex>(latch_);
+  auto lock = std::unique_lock<std::mutex>(latch_);
+  // Force the log once up to the largest page LSN, again only for the pages changed while it was written.
+  while (true) {
+    lsn_t max_lsn = INVALID_LSN;
+    for (size_t i = 0; i < pool_size_; i++) {
+      if (pages_[i].page_id_ != INVALID_PAGE_ID) {
+        max_lsn = std::max(max_lsn, UnflushedLSN(&pages_[i]));
+      }
+    }
+    if (max_lsn == INVALID_LSN) {
+      break;
+    }
+    ForceLog(&lock, max_lsn);
+  }
   for (size_t i = 0; i < pool_size_; i++) {
     auto page = &pages_[i];
     if (page->page_id_ != INVALID_PAGE_ID) {
-      disk_manager_->WritePage(page->page_id_, page->data_);
-      page->is_dirty_ = false;
+      WritePageBack(page);
     }
   }
 }
 
 auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
-  auto lock = std::lock_guard<std::mutex>(latch_);
-  if (page_table_.count(page_id) == 0) {
-    return false;
-  }
-
-  frame_id_t frame_id = page_table_[page_id];
-  Page *page = &pages_[frame_id];
-
-  if (page->pin_count_ != 0) {
-    return false;
+  auto lock = std::unique_lock<std::mutex>(latch_);
+  frame_id_t frame_id = -1;
+  Page *page = nullptr;
+  while (true) {
+    if (page_table_.count(page_id) == 0) {
+      return false;
+    }
+    frame_id = page_table_[page_id];
+    page = &pages_[frame_id];
+    if (page->pin_count_ != 0) {
+      return false;
+    }
+    auto lsn = page->is_dirty_ ? UnflushedLSN(page) : INVALID_LSN;
+    if (lsn == INVALID_LSN) {
+      break;
+    }
+    ForceLog(&lock, lsn);
   }
 
   replacer_->Remove(frame_id);
   if (page->is_dirty_) {
-    disk_manager_->WritePage(page->page_id_, page->data_);
-    page->is_dirty_ = false;
+    WritePageBack(page);
   }
   page->ResetMemory();
   page_table_.erase(page_id);
@@ -179,6 +185,71 @@ auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
   return true;
 }
 
+auto BufferPoolManager::GetDirtyPageTable() -> std::vector<std::pair<page_id_t, lsn_t>> {
+  auto lock = std::lock_guard<std::mutex>(latch_);
+  std::vector<std::pair<page_id_t, lsn_t>> dirty_page_table;
+  for (size_t i = 0; i < pool_size_; i++) {
+    auto page = &pages_[i];
+    if (page->page_id_ != INVALID_PAGE_ID && page->is_dirty_) {
+      dirty_page_table.emplace_back(page->page_id_, page->rec_lsn_);
+    }
+  }
+  return dirty_page_table;
+}
+
+void BufferPoolManager::WritePageBack(Page *page) {
+  BUSTUB_ASSERT(UnflushedLSN(page) == INVALID_LSN, "The log must be flushed before the page is written back");
+  disk_manager_->WritePage(page->page_id_, page->data_);
+  page->is_dirty_ = false;
+  page->page_lsn_ = INVALID_LSN;
+}
+
+auto BufferPoolManager::UnflushedLSN(const Page *page) -> lsn_t {
+  if (!enable_logging || page->page_lsn_ == INVALID_LSN || page->page_lsn_ <= log_manager_->GetPersistentLSN()) {
+    return INVALID_LSN;
+  }
+  return page->page_lsn_;
+}
+
+void BufferPoolManager::ForceLog(std::unique_lock<std::mutex> *lock, lsn_t lsn) {
+  lock->unlock();
+  log_manager_->WaitForFlush(lsn);
+  lock->lock();
+}
+
+auto BufferPoolManager::AcquireFrame(std::unique_lock<std::mutex> *lock) -> frame_id_t {
+  while (true) {
+    frame_id_t frame_id = -1;
+    if (!free_list_.empty()) {
+      frame_id = free_list_.front();
+      free_list_.pop_front();
+      BUSTUB_ASSERT(pages_[frame_id].page_id_ == INVALID_PAGE_ID, "The page id of free frame is not INVALID_PAGE_ID");
+      return frame_id;
+    }
+    if (replacer_->Size() == 0) {
+      return -1;
+    }
+    replacer_->Evict(&frame_id);
+    BUSTUB_ASSERT(frame_id != -1, "Evict error");
+    Page *page = &pages_[frame_id];
+    if (page->is_dirty_) {
+      if (auto lsn = UnflushedLSN(page); lsn != INVALID_LSN) {
+        // Put the victim back, wait for the log without the latch, and choose a victim again: the pages may have
+        // been pinned or changed meanwhile.
+        replacer_->RecordAccess(frame_id);
+        replacer_->SetEvictable(frame_id, true);
+        ForceLog(lock, lsn);
+        continue;
+      }
+      WritePageBack(page);
+    }
+    page_table_.erase(page->page_id_);
+    page->ResetMemory();
+    page->page_id_ = INVALID_PAGE_ID;
+    return frame_id;
+  }
+}
+
 auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
 
 auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard {
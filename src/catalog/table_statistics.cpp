@@ -0,0 +1,268 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_statistics.cpp
+//
+// Identification: src/catalog/table_statistics.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "catalog/table_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string_view>
+#include <utility>
+
+#include "common/util/hash_util.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+namespace {
+
+/** The MurmurHash3 finalizer, every input bit affects every output bit. */
+auto Mix(uint64_t hash) -> uint64_t {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+/**
+ * HyperLogLog needs uniformly distributed hashes. HashUtil::HashBytes collides on small integers (it shifts by 5 bits
+ * per byte), so fixed-size values are hashed by their bits instead.
+ */
+auto SketchHash(const Value &value) -> uint64_t {
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      return Mix(value.GetAs<int8_t>());
+    case TypeId::SMALLINT:
+      return Mix(value.GetAs<int16_t>());
+    case TypeId::INTEGER:
+      return Mix(value.GetAs<int32_t>());
+    case TypeId::BIGINT:
+      return Mix(value.GetAs<int64_t>());
+    case TypeId::BOOLEAN:
+      return Mix(value.GetAs<int8_t>());
+    case TypeId::DECIMAL: {
+      auto raw = value.GetAs<double>();
+      uint64_t bits;
+      memcpy(&bits, &raw, sizeof(bits));
+      return Mix(bits);
+    }
+    case TypeId::TIMESTAMP:
+      return Mix(value.GetAs<uint64_t>());
+    case TypeId::VARCHAR:
+      return Mix(std::hash<std::string_view>{}(std::string_view(value.GetData(), value.GetLength())));
+    default:
+      return Mix(HashUtil::HashValue(&value));
+  }
+}
+
+auto Less(const Value &left, const Value &right) -> bool { return left.CompareLessThan(right) == CmpBool::CmpTrue; }
+
+/** @return the value as a double, for the types that can be interpolated */
+auto ToDouble(const Value &value) -> std::optional<double> {
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    case TypeId::BIGINT:
+      return value.GetAs<int64_t>();
+    case TypeId::DECIMAL:
+      return value.GetAs<double>();
+    case TypeId::TIMESTAMP:
+      return value.GetAs<uint64_t>();
+    default:
+      return std::nullopt;
+  }
+}
+
+}  // namespace
+
+void HyperLogLog::Add(const Value &value) {
+  auto hash = SketchHash(value);
+  auto idx = hash >> (64 - PRECISION);
+  auto rest = hash << PRECISION;
+  uint8_t rank = rest == 0 ? 64 - PRECISION + 1 : __builtin_clzll(rest) + 1;
+  registers_[idx] = std::max(registers_[idx], rank);
+}
+
+auto HyperLogLog::Estimate() const -> uint64_t {
+  double sum = 0;
+  uint32_t zeros = 0;
+  for (auto reg : registers_) {
+    sum += std::ldexp(1.0, -reg);
+    zeros += reg == 0 ? 1 : 0;
+  }
+  const double m = NUM_REGISTERS;
+  double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+  if (estimate <= 2.5 * m && zeros != 0) {
+    // Small cardinalities: linear counting is more accurate.
+    estimate = m * std::log(m / zeros);
+  }
+  return std::llround(estimate);
+}
+
+auto ColumnStatistics::FractionBelow(const Value &value) const -> double {
+  const auto &bounds = histogram_bounds_;
+  auto num_buckets = bounds.size() - 1;
+  if (!Less(bounds.front(), value)) {
+    return 0;
+  }
+  if (Less(bounds.back(), value)) {
+    return 1;
+  }
+  // bounds[i] < value <= bounds[i + 1], interpolate within bucket i.
+  for (size_t i = 0; i < num_buckets; i++) {
+    if (Less(bounds[i + 1], value)) {
+      continue;
+    }
+    double within = 0.5;
+    auto low = ToDouble(bounds[i]);
+    auto high = ToDouble(bounds[i + 1]);
+    auto val = ToDouble(value);
+    if (low.has_value() && high.has_value() && val.has_value() && *high > *low) {
+      within = (*val - *low) / (*high - *low);
+    }
+    return (i + within) / num_buckets;
+  }
+  return 1;
+}
+
+auto ColumnStatistics::EstimateSelectivity(ComparisonType comp_type, const Value &constant) const -> double {
+  if (constant.IsNull() || histogram_bounds_.empty()) {
+    return 0;
+  }
+  double non_null = 1 - null_fraction_;
+  bool in_range = !Less(constant, histogram_bounds_.front()) && !Less(histogram_bounds_.back(), constant);
+  double equal = in_range && distinct_count_ != 0 ? non_null / distinct_count_ : 0;
+  double below = FractionBelow(constant) * non_null;
+  double selectivity = 0;
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      selectivity = equal;
+      break;
+    case ComparisonType::NotEqual:
+      selectivity = non_null - equal;
+      break;
+    case ComparisonType::LessThan:
+      selectivity = below;
+      break;
+    case ComparisonType::LessThanOrEqual:
+      selectivity = below + equal;
+      break;
+    case ComparisonType::GreaterThan:
+      selectivity = non_null - below - equal;
+      break;
+    case ComparisonType::GreaterThanOrEqual:
+      selectivity = non_null - below;
+      break;
+  }
+  return std::clamp(selectivity, 0.0, 1.0);
+}
+
+auto TableStatistics::Analyze(TableHeap *table_heap, const Schema &schema, size_t sample_size) -> TableStatistics {
+  auto column_count = schema.GetColumnCount();
+  std::vector<HyperLogLog> sketches(column_count);
+  std::vector<std::vector<Value>> sample;
+  // A fixed seed keeps the statistics, and thus the plans, reproducible.
+  std::mt19937_64 rng(0);
+  std::vector<uint32_t> all_columns(column_count);
+  std::iota(all_columns.begin(), all_columns.end(), 0);
+
+  TableStatistics stats;
+  for (auto iter = table_heap->MakeIterator(); !iter.IsEnd(); ++iter) {
+    std::vector<Value> values;
+    if (table_heap->GetFormat() == TableFormat::ROW) {
+      auto view = iter.GetTupleView();
+      if (view.GetMeta().is_deleted_) {
+        continue;
+      }
+      values.reserve(column_count);
+      for (uint32_t i = 0; i < column_count; i++) {
+        values.emplace_back(view.GetValue(&schema, i));
+      }
+    } else {
+      auto [meta, row] = iter.GetValues(all_columns);
+      if (meta.is_deleted_) {
+        continue;
+      }
+      values = std::move(row);
+    }
+
+    stats.row_count_++;
+    for (uint32_t i = 0; i < column_count; i++) {
+      if (!values[i].IsNull()) {
+        sketches[i].Add(values[i]);
+      }
+    }
+    if (sample.size() < sample_size) {
+      sample.emplace_back(std::move(values));
+    } else {
+      auto slot = std::uniform_int_distribution<uint64_t>(0, stats.row_count_ - 1)(rng);
+      if (slot < sample_size) {
+        sample[slot] = std::move(values);
+      }
+    }
+  }
+
+  stats.columns_.resize(column_count);
+  for (uint32_t i = 0; i < column_count; i++) {
+    auto &column = stats.columns_[i];
+    std::vector<Value> non_null;
+    non_null.reserve(sample.size());
+    for (auto &row : sample) {
+      if (!row[i].IsNull()) {
+        non_null.emplace_back(std::move(row[i]));
+      }
+    }
+    if (non_null.empty()) {
+      column.null_fraction_ = sample.empty() ? 0 : 1;
+      continue;
+    }
+    column.null_fraction_ = 1 - static_cast<double>(non_null.size()) / sample.size();
+    column.distinct_count_ = std::min<uint64_t>(sketches[i].Estimate(), stats.row_count_);
+    column.distinct_count_ = std::max<uint64_t>(column.distinct_count_, 1);
+
+    std::sort(non_null.begin(), non_null.end(), Less);
+    auto num_buckets = std::min(STATISTICS_HISTOGRAM_BUCKETS, non_null.size());
+    for (size_t bucket = 0; bucket < num_buckets; bucket++) {
+      column.histogram_bounds_.emplace_back(non_null[bucket * non_null.size() / num_buckets]);
+    }
+    column.histogram_bounds_.emplace_back(non_null.back());
+  }
+  return stats;
+}
+
+auto TableStatistics::ToString(const Schema &schema) const -> std::string {
+  std::stringstream os;
+  os << "rows=" << row_count_;
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    const auto &column = columns_[i];
+    os << ", " << schema.GetColumn(i).GetName() << ": ndv=" << column.distinct_count_
+       << " nulls=" << column.null_fraction_;
+    if (!column.histogram_bounds_.empty()) {
+      os << " min=" << column.histogram_bounds_.front().ToString()
+         << " max=" << column.histogram_bounds_.back().ToString();
+    }
+  }
+  return os.str();
+}
+
+}  // namespace bustub
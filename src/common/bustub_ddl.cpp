@@ -9,6 +9,7 @@
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
 #include "binder/bound_statement.h"
+#include "binder/statement/analyze_statement.h"
 #include "binder/statement/create_statement.h"
 #include "binder/statement/explain_statement.h"
 #include "binder/statement/index_statement.h"
@@ -42,7 +43,7 @@ namespace bustub {
 
 void BustubInstance::HandleCreateStatement(Transaction *txn, const CreateStatement &stmt, ResultWriter &writer) {
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
-  auto info = catalog_->CreateTable(txn, stmt.table_, Schema(stmt.columns_));
+  auto info = catalog_->CreateTable(txn, stmt.table_, Schema(stmt.columns_), true, stmt.format_);
   l.unlock();
 
   if (info == nullptr) {
@@ -83,6 +84,33 @@ void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement
   WriteOneCell(fmt::format("Index created with id = {}", info->index_oid_), writer);
 }
 
+void BustubInstance::HandleAnalyzeStatement(Transaction *txn, const AnalyzeStatement &stmt, ResultWriter &writer) {
+  std::string output;
+  for (const auto &table : stmt.tables_) {
+    std::shared_lock<std::shared_mutex> l(catalog_lock_);
+    auto info = catalog_->GetTable(table->oid_);
+    l.unlock();
+    if (info == nullptr || info->table_ == nullptr) {
+      throw bustub::Exception(fmt::format("invalid table {}", table->table_));
+    }
+
+    // Scan without the catalog lock, only publishing the statistics needs it.
+    auto statistics =
+        std::make_shared<const TableStatistics>(TableStatistics::Analyze(info->table_.get(), info->schema_));
+
+    std::unique_lock<std::shared_mutex> ul(catalog_lock_);
+    info->statistics_ = statistics;
+    catalog_->BumpVersion();
+    ul.unlock();
+
+    if (!output.empty()) {
+      output += "\n";
+    }
+    output += fmt::format("{}: {}", table->table_, statistics->ToString(info->schema_));
+  }
+  WriteOneCell(output, writer);
+}
+
 void BustubInstance::HandleExplainStatement(Transaction *txn, const ExplainStatement &stmt, ResultWriter &writer) {
   std::string output;
 
@@ -134,6 +162,8 @@ void BustubInstance::HandleVariableShowStatement(Transaction *txn, const Variabl
 void BustubInstance::HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt,
                                                 ResultWriter &writer) {
   session_variables_[stmt.variable_] = stmt.value_;
+  // The optimizer reads the settings, the plans made with the old ones may no longer be valid.
+  plan_cache_.Clear();
 }
 
 }  // namespace bustub
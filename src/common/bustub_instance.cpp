@@ -6,9 +6,11 @@
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
 #include "binder/bound_statement.h"
+#include "binder/statement/analyze_statement.h"
 #include "binder/statement/create_statement.h"
 #include "binder/statement/explain_statement.h"
 #include "binder/statement/index_statement.h"
+#include "binder/statement/prepare_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "buffer/buffer_pool_manager.h"
@@ -25,6 +27,7 @@
 #include "execution/executor_context.h"
 #include "execution/executors/mock_scan_executor.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/parameter_value_expression.h"
 #include "execution/plans/abstract_plan.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
@@ -223,93 +226,249 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
     throw Exception(fmt::format("unsupported internal command: {}", sql));
   }
 
-  bool is_successful = true;
+  // A query executed before, maybe with other constants, reuses its plan. A query the plan cache cannot plan goes
+  // through the usual path, which also reports its errors.
+  if (auto query = ParameterizeQuery(sql); query.has_value()) {
+    std::vector<TypeId> parameter_types;
+    for (const auto &parameter : query->parameters_) {
+      parameter_types.push_back(parameter.GetTypeId());
+    }
+    auto cached = PlanCachedQuery(query->query_, parameter_types);
+    if (cached->plan_ != nullptr) {
+      return ExecutePlan(txn, OptimizeCachedPlan(*cached, query->parameters_), *cached->output_schema_,
+                         cached->is_modify_, query->parameters_, writer, std::move(check_options));
+    }
+  }
 
   std::shared_lock<std::shared_mutex> l(catalog_lock_);
-  bustub::Binder binder(*catalog_);
-  binder.ParseAndSave(sql);
+  auto binder = std::make_unique<bustub::Binder>(*catalog_);
+  binder->ParseAndSave(sql);
   l.unlock();
 
-  for (auto *stmt : binder.statement_nodes_) {
-    auto statement = binder.BindStatement(stmt);
+  if (binder->statement_nodes_.empty()) {
+    return true;
+  }
+  if (binder->statement_nodes_.size() > 1) {
+    // Run the statements one by one, so that each is bound after the ones before it ran.
+    auto statements = binder->StatementTexts();
+    binder.reset();
+    bool is_successful = true;
+    for (const auto &statement : statements) {
+      is_successful &= ExecuteSqlTxn(statement, writer, txn, check_options);
+    }
+    return is_successful;
+  }
+
+  // The parser keeps a single parse tree per thread, it is dropped before running a statement that may parse another
+  // one (EXECUTE).
+  auto statement = binder->BindStatement(binder->statement_nodes_[0]);
+  binder.reset();
+
+  bool is_delete = false;
+
+  switch (statement->type_) {
+    case StatementType::CREATE_STATEMENT: {
+      const auto &create_stmt = dynamic_cast<const CreateStatement &>(*statement);
+      HandleCreateStatement(txn, create_stmt, writer);
+      return true;
+    }
+    case StatementType::INDEX_STATEMENT: {
+      const auto &index_stmt = dynamic_cast<const IndexStatement &>(*statement);
+      HandleIndexStatement(txn, index_stmt, writer);
+      return true;
+    }
+    case StatementType::ANALYZE_STATEMENT: {
+      const auto &analyze_stmt = dynamic_cast<const AnalyzeStatement &>(*statement);
+      HandleAnalyzeStatement(txn, analyze_stmt, writer);
+      return true;
+    }
+    case StatementType::VARIABLE_SHOW_STATEMENT: {
+      const auto &show_stmt = dynamic_cast<const VariableShowStatement &>(*statement);
+      HandleVariableShowStatement(txn, show_stmt, writer);
+      return true;
+    }
+    case StatementType::VARIABLE_SET_STATEMENT: {
+      const auto &set_stmt = dynamic_cast<const VariableSetStatement &>(*statement);
+      HandleVariableSetStatement(txn, set_stmt, writer);
+      return true;
+    }
+    case StatementType::EXPLAIN_STATEMENT: {
+      const auto &explain_stmt = dynamic_cast<const ExplainStatement &>(*statement);
+      HandleExplainStatement(txn, explain_stmt, writer);
+      return true;
+    }
+    case StatementType::PREPARE_STATEMENT: {
+      const auto &prepare_stmt = dynamic_cast<const PrepareStatement &>(*statement);
+      HandlePrepareStatement(txn, prepare_stmt, writer);
+      return true;
+    }
+    case StatementType::EXECUTE_STATEMENT: {
+      const auto &execute_stmt = dynamic_cast<const ExecuteStatement &>(*statement);
+      return HandleExecuteStatement(txn, execute_stmt, writer, std::move(check_options));
+    }
+    case StatementType::DELETE_STATEMENT:
+    case StatementType::UPDATE_STATEMENT:
+      is_delete = true;
+    default:
+      break;
+  }
+
+  l.lock();
+
+  // Plan the query.
+  bustub::Planner planner(*catalog_);
+  planner.PlanQuery(*statement);
+
+  // Optimize the query.
+  bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
+  auto optimized_plan = optimizer.Optimize(planner.plan_);
+
+  l.unlock();
+
+  // Execute the query.
+  return ExecutePlan(txn, optimized_plan, planner.plan_->OutputSchema(), is_delete, {}, writer,
+                     std::move(check_options));
+}
+
+void BustubInstance::HandlePrepareStatement(Transaction *txn, const PrepareStatement &stmt, ResultWriter &writer) {
+  if (prepared_statements_.count(stmt.name_) != 0) {
+    throw Exception(fmt::format("prepared statement {} already exists", stmt.name_));
+  }
+  prepared_statements_.emplace(stmt.name_, stmt);
+}
+
+auto BustubInstance::HandleExecuteStatement(Transaction *txn, const ExecuteStatement &stmt, ResultWriter &writer,
+                                            std::shared_ptr<CheckOptions> check_options) -> bool {
+  auto it = prepared_statements_.find(stmt.name_);
+  if (it == prepared_statements_.end()) {
+    throw Exception(fmt::format("prepared statement {} does not exist", stmt.name_));
+  }
+  const auto &prepared = it->second;
+
+  auto parameters = stmt.parameters_;
+  if (!prepared.parameter_types_.empty()) {
+    if (parameters.size() != prepared.parameter_types_.size()) {
+      throw Exception(fmt::format("prepared statement {} takes {} parameters, {} given", stmt.name_,
+                                  prepared.parameter_types_.size(), parameters.size()));
+    }
+    for (size_t i = 0; i < parameters.size(); i++) {
+      parameters[i] = parameters[i].CastAs(prepared.parameter_types_[i]);
+    }
+  }
+  std::vector<TypeId> parameter_types;
+  for (const auto &parameter : parameters) {
+    parameter_types.push_back(parameter.GetTypeId());
+  }
+
+  auto cached = PlanCachedQuery(prepared.query_, parameter_types);
+  if (cached->plan_ == nullptr) {
+    throw Exception(cached->error_);
+  }
+  return ExecutePlan(txn, OptimizeCachedPlan(*cached, parameters), *cached->output_schema_, cached->is_modify_,
+                     parameters, writer, std::move(check_options));
+}
+
+auto BustubInstance::ExecutedPlan(const std::string &sql) -> AbstractPlanNodeRef {
+  auto query = ParameterizeQuery(sql);
+  if (!query.has_value()) {
+    return nullptr;
+  }
+  std::vector<TypeId> parameter_types;
+  for (const auto &parameter : query->parameters_) {
+    parameter_types.push_back(parameter.GetTypeId());
+  }
+  auto cached = PlanCachedQuery(query->query_, parameter_types);
+  return cached->plan_ == nullptr ? nullptr : OptimizeCachedPlan(*cached, query->parameters_);
+}
 
-    bool is_delete = false;
+auto BustubInstance::PlanCachedQuery(const std::string &query, const std::vector<TypeId> &parameter_types)
+    -> std::shared_ptr<const CachedPlan> {
+  std::shared_lock<std::shared_mutex> l(catalog_lock_);
+  auto catalog_version = catalog_->GetVersion();
+  if (auto cached = plan_cache_.Get(query, parameter_types, catalog_version); cached != nullptr) {
+    return cached;
+  }
 
+  auto cached = std::make_shared<CachedPlan>();
+  try {
+    bustub::Binder binder(*catalog_, parameter_types);
+    binder.ParseAndSave(query);
+    if (binder.statement_nodes_.size() != 1) {
+      throw Exception("expected a single statement");
+    }
+    auto statement = binder.BindStatement(binder.statement_nodes_[0]);
     switch (statement->type_) {
-      case StatementType::CREATE_STATEMENT: {
-        const auto &create_stmt = dynamic_cast<const CreateStatement &>(*statement);
-        HandleCreateStatement(txn, create_stmt, writer);
-        continue;
-      }
-      case StatementType::INDEX_STATEMENT: {
-        const auto &index_stmt = dynamic_cast<const IndexStatement &>(*statement);
-        HandleIndexStatement(txn, index_stmt, writer);
-        continue;
-      }
-      case StatementType::VARIABLE_SHOW_STATEMENT: {
-        const auto &show_stmt = dynamic_cast<const VariableShowStatement &>(*statement);
-        HandleVariableShowStatement(txn, show_stmt, writer);
-        continue;
-      }
-      case StatementType::VARIABLE_SET_STATEMENT: {
-        const auto &set_stmt = dynamic_cast<const VariableSetStatement &>(*statement);
-        HandleVariableSetStatement(txn, set_stmt, writer);
-        continue;
-      }
-      case StatementType::EXPLAIN_STATEMENT: {
-        const auto &explain_stmt = dynamic_cast<const ExplainStatement &>(*statement);
-        HandleExplainStatement(txn, explain_stmt, writer);
-        continue;
-      }
+      case StatementType::SELECT_STATEMENT:
+      case StatementType::INSERT_STATEMENT:
+        break;
       case StatementType::DELETE_STATEMENT:
       case StatementType::UPDATE_STATEMENT:
-        is_delete = true;
-      default:
+        cached->is_modify_ = true;
         break;
+      default:
+        throw NotImplementedException(fmt::format("cannot prepare a {} statement", statement->type_));
     }
 
-    std::shared_lock<std::shared_mutex> l(catalog_lock_);
-
-    // Plan the query.
     bustub::Planner planner(*catalog_);
     planner.PlanQuery(*statement);
-
-    // Optimize the query.
     bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
     auto optimized_plan = optimizer.Optimize(planner.plan_);
+    cached->plan_ = planner.plan_;
+    cached->generic_plan_ = optimizer.DependsOnParameters() ? nullptr : optimized_plan;
+    cached->output_schema_ = planner.plan_->output_schema_;
+  } catch (Exception &ex) {
+    // Remembered as well, so that a query that cannot be prepared is not planned again.
+    cached->plan_ = nullptr;
+    cached->generic_plan_ = nullptr;
+    cached->error_ = ex.what();
+  }
+  plan_cache_.Put(query, parameter_types, catalog_version, cached);
+  return cached;
+}
 
-    l.unlock();
-
-    // Execute the query.
-    auto exec_ctx = MakeExecutorContext(txn, is_delete);
-    if (check_options != nullptr) {
-      exec_ctx->InitCheckOptions(std::move(check_options));
-    }
-    std::vector<Tuple> result_set{};
-    is_successful &= execution_engine_->Execute(optimized_plan, &result_set, txn, exec_ctx.get());
+auto BustubInstance::OptimizeCachedPlan(const CachedPlan &cached, const std::vector<Value> &parameters)
+    -> AbstractPlanNodeRef {
+  if (cached.generic_plan_ != nullptr) {
+    return cached.generic_plan_;
+  }
+  // The optimizer reads the bound values as the constants of the query, the plan is the one EXPLAIN shows for it.
+  std::shared_lock<std::shared_mutex> l(catalog_lock_);
+  ParameterBinding binding(&parameters);
+  bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
+  return optimizer.Optimize(cached.plan_);
+}
 
-    // Return the result set as a vector of string.
-    auto schema = planner.plan_->OutputSchema();
+auto BustubInstance::ExecutePlan(Transaction *txn, const AbstractPlanNodeRef &plan, const Schema &output_schema,
+                                 bool is_modify, const std::vector<Value> &parameters, ResultWriter &writer,
+                                 std::shared_ptr<CheckOptions> check_options) -> bool {
+  auto exec_ctx = MakeExecutorContext(txn, is_modify);
+  if (check_options != nullptr) {
+    exec_ctx->InitCheckOptions(std::move(check_options));
+  }
+  std::vector<Tuple> result_set{};
+  bool is_successful;
+  {
+    ParameterBinding binding(&parameters);
+    is_successful = execution_engine_->Execute(plan, &result_set, txn, exec_ctx.get());
+  }
 
-    // Generate header for the result set.
-    writer.BeginTable(false);
-    writer.BeginHeader();
-    for (const auto &column : schema.GetColumns()) {
-      writer.WriteHeaderCell(column.GetName());
-    }
-    writer.EndHeader();
+  // Generate header for the result set.
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  for (const auto &column : output_schema.GetColumns()) {
+    writer.WriteHeaderCell(column.GetName());
+  }
+  writer.EndHeader();
 
-    // Transforming result set into strings.
-    for (const auto &tuple : result_set) {
-      writer.BeginRow();
-      for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
-        writer.WriteCell(tuple.GetValue(&schema, i).ToString());
-      }
-      writer.EndRow();
+  // Transforming result set into strings.
+  for (const auto &tuple : result_set) {
+    writer.BeginRow();
+    for (uint32_t i = 0; i < output_schema.GetColumnCount(); i++) {
+      writer.WriteCell(tuple.GetValue(&output_schema, i).ToString());
     }
-    writer.EndTable();
+    writer.EndRow();
   }
-
+  writer.EndTable();
   return is_successful;
 }
 
@@ -20,4 +20,8 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::atomic<size_t> lock_escalation_threshold(1000);
+
+std::chrono::milliseconds checkpoint_flush_interval = std::chrono::milliseconds(10);
+
 }  // namespace bustub
@@ -18,20 +18,503 @@
 
 namespace bustub {
 
-auto LockManager::LockTable(Transaction *txn, LockMode lock_mode, const table_oid_t &oid) -> bool { return true; }
+namespace {
 
-auto LockManager::UnlockTable(Transaction *txn, const table_oid_t &oid) -> bool { return true; }
+/** Aborts the transaction and throws, see [LOCK_NOTE] and [UNLOCK_NOTE]. */
+[[noreturn]] void AbortTransaction(Transaction *txn, AbortReason reason) {
+  txn->SetState(TransactionState::ABORTED);
+  throw TransactionAbortException(txn->GetTransactionId(), reason);
+}
+
+/** @return the request of the transaction in the queue, or end() if there is none */
+auto FindRequest(std::list<LockManager::LockRequest *> *request_queue, txn_id_t txn_id)
+    -> std::list<LockManager::LockRequest *>::iterator {
+  return std::find_if(request_queue->begin(), request_queue->end(),
+                      [txn_id](const LockManager::LockRequest *request) { return request->txn_id_ == txn_id; });
+}
+
+}  // namespace
+
+auto LockManager::LockTable(Transaction *txn, LockMode lock_mode, const table_oid_t &oid) -> bool {
+  if (!CanTxnTakeLock(txn, lock_mode)) {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> map_guard(table_lock_map_latch_);
+  auto &queue = table_lock_map_[oid];
+  if (queue == nullptr) {
+    queue = std::make_shared<LockRequestQueue>();
+  }
+  auto queue_holder = queue;
+  map_guard.unlock();
+
+  return AcquireLock(txn, queue_holder.get(), new LockRequest(txn->GetTransactionId(), lock_mode, oid));
+}
+
+auto LockManager::UnlockTable(Transaction *txn, const table_oid_t &oid) -> bool {
+  std::unique_lock<std::mutex> map_guard(table_lock_map_latch_);
+  auto it = table_lock_map_.find(oid);
+  if (it == table_lock_map_.end()) {
+    map_guard.unlock();
+    AbortTransaction(txn, AbortReason::ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD);
+  }
+  auto queue = it->second;
+  map_guard.unlock();
+
+  txn->LockTxn();
+  auto s_row_locks = txn->GetSharedRowLockSet()->find(oid);
+  auto x_row_locks = txn->GetExclusiveRowLockSet()->find(oid);
+  bool holds_row_locks = (s_row_locks != txn->GetSharedRowLockSet()->end() && !s_row_locks->second.empty()) ||
+                         (x_row_locks != txn->GetExclusiveRowLockSet()->end() && !x_row_locks->second.empty());
+  txn->UnlockTxn();
+  if (holds_row_locks) {
+    AbortTransaction(txn, AbortReason::TABLE_UNLOCKED_BEFORE_UNLOCKING_ROWS);
+  }
+
+  auto lock_mode = ReleaseLock(txn, queue.get());
+  if (!lock_mode.has_value()) {
+    AbortTransaction(txn, AbortReason::ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD);
+  }
+  UpdateTransactionState(txn, *lock_mode);
+
+  std::scoped_lock<std::mutex> escalated_guard(escalated_rows_latch_);
+  auto escalated = escalated_rows_.find(txn->GetTransactionId());
+  if (escalated != escalated_rows_.end()) {
+    escalated->second.erase(oid);
+    if (escalated->second.empty()) {
+      escalated_rows_.erase(escalated);
+    }
+  }
+  return true;
+}
 
 auto LockManager::LockRow(Transaction *txn, LockMode lock_mode, const table_oid_t &oid, const RID &rid) -> bool {
+  if (lock_mode != LockMode::SHARED && lock_mode != LockMode::EXCLUSIVE) {
+    AbortTransaction(txn, AbortReason::ATTEMPTED_INTENTION_LOCK_ON_ROW);
+  }
+  if (!CanTxnTakeLock(txn, lock_mode)) {
+    return false;
+  }
+  if (!CheckAppropriateLockOnTable(txn, oid, lock_mode)) {
+    AbortTransaction(txn, AbortReason::TABLE_LOCK_NOT_PRESENT);
+  }
+  if (CoverRowByEscalation(txn, oid, rid, lock_mode)) {
+    return true;
+  }
+
+  std::unique_lock<std::mutex> map_guard(row_lock_map_latch_);
+  auto &queue = row_lock_map_[rid];
+  if (queue == nullptr) {
+    queue = std::make_shared<LockRequestQueue>();
+  }
+  auto queue_holder = queue;
+  map_guard.unlock();
+
+  bool granted = AcquireLock(txn, queue_holder.get(), new LockRequest(txn->GetTransactionId(), lock_mode, oid, rid));
+  queue_holder.reset();
+  if (!granted) {
+    EraseRowQueueIfUnused(rid);
+    return false;
+  }
+  TryEscalate(txn, oid);
   return true;
 }
 
 auto LockManager::UnlockRow(Transaction *txn, const table_oid_t &oid, const RID &rid, bool force) -> bool {
+  std::unique_lock<std::mutex> map_guard(row_lock_map_latch_);
+  auto it = row_lock_map_.find(rid);
+  auto queue = it == row_lock_map_.end() ? nullptr : it->second;
+  map_guard.unlock();
+
+  auto lock_mode = queue == nullptr ? std::nullopt : ReleaseLock(txn, queue.get());
+  queue.reset();
+  if (lock_mode.has_value()) {
+    EraseRowQueueIfUnused(rid);
+  } else {
+    // The row lock may have been dropped by an escalation, the table lock still covers the row.
+    lock_mode = ReleaseEscalatedRow(txn, oid, rid);
+  }
+  if (!lock_mode.has_value()) {
+    AbortTransaction(txn, AbortReason::ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD);
+  }
+  if (!force) {
+    UpdateTransactionState(txn, *lock_mode);
+  }
   return true;
 }
 
 void LockManager::UnlockAll() {
-  // You probably want to unlock all table and txn locks here.
+  auto clear_queue = [](LockRequestQueue *queue) {
+    std::scoped_lock<std::mutex> guard(queue->latch_);
+    for (auto *request : queue->request_queue_) {
+      delete request;
+    }
+    queue->request_queue_.clear();
+  };
+  std::scoped_lock<std::mutex, std::mutex> guard(table_lock_map_latch_, row_lock_map_latch_);
+  for (auto &[oid, queue] : table_lock_map_) {
+    clear_queue(queue.get());
+  }
+  for (auto &[rid, queue] : row_lock_map_) {
+    clear_queue(queue.get());
+  }
+}
+
+auto LockManager::AreLocksCompatible(LockMode l1, LockMode l2) -> bool {
+  switch (l1) {
+    case LockMode::INTENTION_SHARED:
+      return l2 != LockMode::EXCLUSIVE;
+    case LockMode::INTENTION_EXCLUSIVE:
+      return l2 == LockMode::INTENTION_SHARED || l2 == LockMode::INTENTION_EXCLUSIVE;
+    case LockMode::SHARED:
+      return l2 == LockMode::INTENTION_SHARED || l2 == LockMode::SHARED;
+    case LockMode::SHARED_INTENTION_EXCLUSIVE:
+      return l2 == LockMode::INTENTION_SHARED;
+    case LockMode::EXCLUSIVE:
+      return false;
+  }
+  return false;
+}
+
+auto LockManager::CanTxnTakeLock(Transaction *txn, LockMode lock_mode) -> bool {
+  auto state = txn->GetState();
+  if (state == TransactionState::ABORTED || state == TransactionState::COMMITTED) {
+    return false;
+  }
+  bool is_shared = lock_mode == LockMode::SHARED || lock_mode == LockMode::INTENTION_SHARED ||
+                   lock_mode == LockMode::SHARED_INTENTION_EXCLUSIVE;
+  switch (txn->GetIsolationLevel()) {
+    case IsolationLevel::READ_UNCOMMITTED:
+      if (is_shared) {
+        AbortTransaction(txn, AbortReason::LOCK_SHARED_ON_READ_UNCOMMITTED);
+      }
+      if (state == TransactionState::SHRINKING) {
+        AbortTransaction(txn, AbortReason::LOCK_ON_SHRINKING);
+      }
+      break;
+    case IsolationLevel::READ_COMMITTED:
+      if (state == TransactionState::SHRINKING && lock_mode != LockMode::SHARED &&
+          lock_mode != LockMode::INTENTION_SHARED) {
+        AbortTransaction(txn, AbortReason::LOCK_ON_SHRINKING);
+      }
+      break;
+    case IsolationLevel::REPEATABLE_READ:
+      if (state == TransactionState::SHRINKING) {
+        AbortTransaction(txn, AbortReason::LOCK_ON_SHRINKING);
+      }
+      break;
+  }
+  return true;
+}
+
+void LockManager::GrantNewLocksIfPossible(LockRequestQueue *lock_request_queue) {
+  bool granted_any = false;
+  for (auto *request : lock_request_queue->request_queue_) {
+    if (request->granted_) {
+      continue;
+    }
+    // FIFO: stop at the first waiting request that conflicts with a granted one.
+    for (const auto *granted : lock_request_queue->request_queue_) {
+      if (granted->granted_ && !AreLocksCompatible(granted->lock_mode_, request->lock_mode_)) {
+        if (granted_any) {
+          lock_request_queue->cv_.notify_all();
+        }
+        return;
+      }
+    }
+    request->granted_ = true;
+    granted_any = true;
+  }
+  if (granted_any) {
+    lock_request_queue->cv_.notify_all();
+  }
+}
+
+auto LockManager::CanLockUpgrade(LockMode curr_lock_mode, LockMode requested_lock_mode) -> bool {
+  switch (curr_lock_mode) {
+    case LockMode::INTENTION_SHARED:
+      return requested_lock_mode != LockMode::INTENTION_SHARED;
+    case LockMode::SHARED:
+    case LockMode::INTENTION_EXCLUSIVE:
+      return requested_lock_mode == LockMode::EXCLUSIVE || requested_lock_mode == LockMode::SHARED_INTENTION_EXCLUSIVE;
+    case LockMode::SHARED_INTENTION_EXCLUSIVE:
+      return requested_lock_mode == LockMode::EXCLUSIVE;
+    case LockMode::EXCLUSIVE:
+      return false;
+  }
+  return false;
+}
+
+auto LockManager::CheckAppropriateLockOnTable(Transaction *txn, const table_oid_t &oid, LockMode row_lock_mode)
+    -> bool {
+  if (txn->IsTableExclusiveLocked(oid) || txn->IsTableIntentionExclusiveLocked(oid) ||
+      txn->IsTableSharedIntentionExclusiveLocked(oid)) {
+    return true;
+  }
+  return row_lock_mode == LockMode::SHARED &&
+         (txn->IsTableSharedLocked(oid) || txn->IsTableIntentionSharedLocked(oid));
+}
+
+auto LockManager::AcquireLock(Transaction *txn, LockRequestQueue *queue, LockRequest *request) -> bool {
+  std::unique_lock<std::mutex> guard(queue->latch_);
+  auto held = FindRequest(&queue->request_queue_, txn->GetTransactionId());
+  if (held != queue->request_queue_.end()) {
+    auto held_mode = (*held)->lock_mode_;
+    if (held_mode == request->lock_mode_) {
+      delete request;
+      return true;
+    }
+    if (queue->upgrading_ != INVALID_TXN_ID) {
+      delete request;
+      guard.unlock();
+      AbortTransaction(txn, AbortReason::UPGRADE_CONFLICT);
+    }
+    if (!CanLockUpgrade(held_mode, request->lock_mode_)) {
+      delete request;
+      guard.unlock();
+      AbortTransaction(txn, AbortReason::INCOMPATIBLE_UPGRADE);
+    }
+    UpdateLockSets(txn, **held, false);
+    delete *held;
+    queue->request_queue_.erase(held);
+    // The upgrade goes ahead of every waiting request.
+    auto first_waiting = std::find_if(queue->request_queue_.begin(), queue->request_queue_.end(),
+                                      [](const LockRequest *waiting) { return !waiting->granted_; });
+    queue->request_queue_.insert(first_waiting, request);
+    queue->upgrading_ = txn->GetTransactionId();
+  } else {
+    queue->request_queue_.push_back(request);
+  }
+
+  GrantNewLocksIfPossible(queue);
+  queue->cv_.wait(guard, [&] { return request->granted_ || txn->GetState() == TransactionState::ABORTED; });
+  if (queue->upgrading_ == txn->GetTransactionId()) {
+    queue->upgrading_ = INVALID_TXN_ID;
+  }
+  if (txn->GetState() == TransactionState::ABORTED) {
+    queue->request_queue_.remove(request);
+    delete request;
+    GrantNewLocksIfPossible(queue);
+    return false;
+  }
+  UpdateLockSets(txn, *request, true);
+  return true;
+}
+
+auto LockManager::ReleaseLock(Transaction *txn, LockRequestQueue *queue) -> std::optional<LockMode> {
+  std::scoped_lock<std::mutex> guard(queue->latch_);
+  auto held = FindRequest(&queue->request_queue_, txn->GetTransactionId());
+  if (held == queue->request_queue_.end() || !(*held)->granted_) {
+    return std::nullopt;
+  }
+  auto lock_mode = (*held)->lock_mode_;
+  UpdateLockSets(txn, **held, false);
+  delete *held;
+  queue->request_queue_.erase(held);
+  GrantNewLocksIfPossible(queue);
+  return lock_mode;
+}
+
+void LockManager::UpdateLockSets(Transaction *txn, const LockRequest &request, bool insert) {
+  txn->LockTxn();
+  bool is_row = request.rid_.GetPageId() != INVALID_PAGE_ID;
+  if (is_row) {
+    auto row_lock_set =
+        request.lock_mode_ == LockMode::SHARED ? txn->GetSharedRowLockSet() : txn->GetExclusiveRowLockSet();
+    if (insert) {
+      (*row_lock_set)[request.oid_].emplace(request.rid_);
+    } else {
+      (*row_lock_set)[request.oid_].erase(request.rid_);
+    }
+  } else {
+    std::shared_ptr<std::unordered_set<table_oid_t>> table_lock_set;
+    switch (request.lock_mode_) {
+      case LockMode::SHARED:
+        table_lock_set = txn->GetSharedTableLockSet();
+        break;
+      case LockMode::EXCLUSIVE:
+        table_lock_set = txn->GetExclusiveTableLockSet();
+        break;
+      case LockMode::INTENTION_SHARED:
+        table_lock_set = txn->GetIntentionSharedTableLockSet();
+        break;
+      case LockMode::INTENTION_EXCLUSIVE:
+        table_lock_set = txn->GetIntentionExclusiveTableLockSet();
+        break;
+      case LockMode::SHARED_INTENTION_EXCLUSIVE:
+        table_lock_set = txn->GetSharedIntentionExclusiveTableLockSet();
+        break;
+    }
+    if (insert) {
+      table_lock_set->emplace(request.oid_);
+    } else {
+      table_lock_set->erase(request.oid_);
+    }
+  }
+  txn->UnlockTxn();
+}
+
+void LockManager::UpdateTransactionState(Transaction *txn, LockMode released_lock_mode) {
+  if (txn->GetState() != TransactionState::GROWING) {
+    return;
+  }
+  if (released_lock_mode == LockMode::EXCLUSIVE ||
+      (released_lock_mode == LockMode::SHARED && txn->GetIsolationLevel() == IsolationLevel::REPEATABLE_READ)) {
+    txn->SetState(TransactionState::SHRINKING);
+  }
+}
+
+auto LockManager::CoverRowByEscalation(Transaction *txn, const table_oid_t &oid, const RID &rid,
+                                       LockMode row_lock_mode) -> bool {
+  bool covered = txn->IsTableExclusiveLocked(oid) ||
+                 (row_lock_mode == LockMode::SHARED &&
+                  (txn->IsTableSharedLocked(oid) || txn->IsTableSharedIntentionExclusiveLocked(oid)));
+  if (!covered) {
+    return false;
+  }
+  std::scoped_lock<std::mutex> guard(escalated_rows_latch_);
+  auto escalated = escalated_rows_.find(txn->GetTransactionId());
+  if (escalated == escalated_rows_.end()) {
+    return false;
+  }
+  auto rows = escalated->second.find(oid);
+  if (rows == escalated->second.end()) {
+    return false;
+  }
+  auto [row, inserted] = rows->second.emplace(rid, row_lock_mode);
+  if (!inserted && row_lock_mode == LockMode::EXCLUSIVE) {
+    row->second = LockMode::EXCLUSIVE;
+  }
+  return true;
+}
+
+auto LockManager::ReleaseEscalatedRow(Transaction *txn, const table_oid_t &oid, const RID &rid)
+    -> std::optional<LockMode> {
+  std::scoped_lock<std::mutex> guard(escalated_rows_latch_);
+  auto escalated = escalated_rows_.find(txn->GetTransactionId());
+  if (escalated == escalated_rows_.end()) {
+    return std::nullopt;
+  }
+  auto rows = escalated->second.find(oid);
+  if (rows == escalated->second.end()) {
+    return std::nullopt;
+  }
+  auto row = rows->second.find(rid);
+  if (row == rows->second.end()) {
+    return std::nullopt;
+  }
+  auto lock_mode = row->second;
+  rows->second.erase(row);
+  return lock_mode;
+}
+
+void LockManager::EraseRowQueueIfUnused(const RID &rid) {
+  std::scoped_lock<std::mutex> map_guard(row_lock_map_latch_);
+  auto it = row_lock_map_.find(rid);
+  // References to a queue are only taken under the map latch: when the map holds the only one, no request can be
+  // added to the queue before it is erased.
+  if (it == row_lock_map_.end() || it->second.use_count() != 1) {
+    return;
+  }
+  std::unique_lock<std::mutex> guard(it->second->latch_);
+  if (!it->second->request_queue_.empty()) {
+    return;
+  }
+  guard.unlock();
+  row_lock_map_.erase(it);
+}
+
+void LockManager::TryEscalate(Transaction *txn, const table_oid_t &oid) {
+  size_t threshold = lock_escalation_threshold.load();
+  if (threshold == 0) {
+    return;
+  }
+
+  std::vector<std::pair<RID, LockMode>> row_locks;
+  bool has_exclusive_row_locks = false;
+  txn->LockTxn();
+  auto s_row_locks = txn->GetSharedRowLockSet()->find(oid);
+  auto x_row_locks = txn->GetExclusiveRowLockSet()->find(oid);
+  size_t num_shared = s_row_locks == txn->GetSharedRowLockSet()->end() ? 0 : s_row_locks->second.size();
+  size_t num_exclusive = x_row_locks == txn->GetExclusiveRowLockSet()->end() ? 0 : x_row_locks->second.size();
+  if (num_shared + num_exclusive > threshold) {
+    row_locks.reserve(num_shared + num_exclusive);
+    if (num_shared > 0) {
+      for (const auto &rid : s_row_locks->second) {
+        row_locks.emplace_back(rid, LockMode::SHARED);
+      }
+    }
+    if (num_exclusive > 0) {
+      for (const auto &rid : x_row_locks->second) {
+        row_locks.emplace_back(rid, LockMode::EXCLUSIVE);
+      }
+      has_exclusive_row_locks = true;
+    }
+  }
+  txn->UnlockTxn();
+  if (row_locks.empty()) {
+    return;
+  }
+
+  LockMode target_mode;
+  if (has_exclusive_row_locks || txn->IsTableExclusiveLocked(oid)) {
+    target_mode = LockMode::EXCLUSIVE;
+  } else if (txn->IsTableIntentionSharedLocked(oid)) {
+    target_mode = LockMode::SHARED;
+  } else if (txn->IsTableIntentionExclusiveLocked(oid)) {
+    target_mode = LockMode::SHARED_INTENTION_EXCLUSIVE;
+  } else {
+    // S or SIX already covers the shared row locks.
+    target_mode = txn->IsTableSharedLocked(oid) ? LockMode::SHARED : LockMode::SHARED_INTENTION_EXCLUSIVE;
+  }
+  if (!TryUpgradeLockTable(txn, oid, target_mode)) {
+    return;
+  }
+
+  {
+    // The dropped row locks are remembered, so that unlocking one of them later is still valid.
+    std::scoped_lock<std::mutex> guard(escalated_rows_latch_);
+    auto &rows = escalated_rows_[txn->GetTransactionId()][oid];
+    for (const auto &[rid, lock_mode] : row_locks) {
+      rows.emplace(rid, lock_mode);
+    }
+  }
+  for (const auto &[rid, lock_mode] : row_locks) {
+    UnlockRow(txn, oid, rid, true);
+  }
+  escalation_count_++;
+  escalated_row_lock_count_ += row_locks.size();
+}
+
+auto LockManager::TryUpgradeLockTable(Transaction *txn, const table_oid_t &oid, LockMode lock_mode) -> bool {
+  std::unique_lock<std::mutex> map_guard(table_lock_map_latch_);
+  auto it = table_lock_map_.find(oid);
+  if (it == table_lock_map_.end()) {
+    return false;
+  }
+  auto queue = it->second;
+  map_guard.unlock();
+
+  std::scoped_lock<std::mutex> guard(queue->latch_);
+  auto held = FindRequest(&queue->request_queue_, txn->GetTransactionId());
+  if (held == queue->request_queue_.end() || !(*held)->granted_) {
+    return false;
+  }
+  if ((*held)->lock_mode_ == lock_mode) {
+    return true;
+  }
+  if (queue->upgrading_ != INVALID_TXN_ID || !CanLockUpgrade((*held)->lock_mode_, lock_mode)) {
+    return false;
+  }
+  for (const auto *request : queue->request_queue_) {
+    if (request != *held && request->granted_ && !AreLocksCompatible(request->lock_mode_, lock_mode)) {
+      return false;
+    }
+  }
+  UpdateLockSets(txn, **held, false);
+  (*held)->lock_mode_ = lock_mode;
+  UpdateLockSets(txn, **held, true);
+  return true;
 }
 
 void LockManager::AddEdge(txn_id_t t1, txn_id_t t2) {}
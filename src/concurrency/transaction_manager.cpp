@@ -23,9 +23,60 @@
 namespace bustub {
 
 void TransactionManager::Commit(Transaction *txn) {
-  // Release all the locks.
+  lsn_t commit_lsn = INVALID_LSN;
+  {
+    // Optimistic transactions validate and append their commit record as one step, so that no other optimistic
+    // transaction can commit a write to our read set in between.
+    std::unique_lock<std::mutex> commit_guard(commit_mutex_, std::defer_lock);
+    if (txn->IsOptimistic()) {
+      commit_guard.lock();
+      if (!ValidateReadSet(txn)) {
+        commit_guard.unlock();
+        Abort(txn);
+        throw TransactionAbortException(txn->GetTransactionId(), AbortReason::READ_VALIDATION_FAILED);
+      }
+    }
+
+    // Our writes are final now, clear the markers that tell validating readers they are in progress. This holds for
+    // every transaction, an optimistic reader must not mistake a committed pessimistic write for a running one.
+    // Our deletes can no longer be rolled back either, so the table pages may reclaim the space of those tuples.
+    for (const auto &write : *txn->GetWriteSet()) {
+      auto meta = write.table_heap_->GetTupleMeta(write.rid_);
+      bool changed = false;
+      if (meta.insert_txn_id_ == txn->GetTransactionId()) {
+        meta.insert_txn_id_ = INVALID_TXN_ID;
+        changed = true;
+      }
+      if (meta.is_deleted_ && !meta.delete_committed_ &&
+          (meta.delete_txn_id_ == txn->GetTransactionId() || meta.delete_txn_id_ == INVALID_TXN_ID)) {
+        meta.delete_txn_id_ = INVALID_TXN_ID;
+        meta.delete_committed_ = true;
+        changed = true;
+      } else if (meta.delete_txn_id_ == txn->GetTransactionId()) {
+        meta.delete_txn_id_ = INVALID_TXN_ID;
+        changed = true;
+      }
+      if (changed) {
+        write.table_heap_->UpdateTupleMeta(meta, write.rid_);
+      }
+    }
+
+    if (enable_logging) {
+      LogRecord record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::COMMIT);
+      commit_lsn = log_manager_->AppendLogRecord(&record);
+      txn->SetPrevLSN(commit_lsn);
+    }
+  }
+
+  // Early lock release: once the commit record is appended the transaction can no longer abort, so its locks are
+  // dropped before waiting for the log flush instead of being held across it. A transaction that reads our writes
+  // appends its own commit record after ours, and the log is flushed in LSN order, so it cannot be reported committed
+  // before our commit record is durable.
   ReleaseLocks(txn);
 
+  if (enable_logging) {
+    log_manager_->WaitForFlush(commit_lsn);
+  }
   txn->SetState(TransactionState::COMMITTED);
 }
 
@@ -37,6 +88,50 @@ void TransactionManager::Abort(Transaction *txn) {
   txn->SetState(TransactionState::ABORTED);
 }
 
+auto TransactionManager::ValidateReadSet(Transaction *txn) -> bool {
+  for (const auto &read : *txn->GetReadSet()) {
+    auto meta = read.table_heap_->GetTupleMeta(read.rid_);
+    if (meta.version_ != read.version_) {
+      return false;
+    }
+    // The version is unchanged, but the value we read may be the uncommitted write of another transaction.
+    for (auto writer : {meta.insert_txn_id_, meta.delete_txn_id_}) {
+      if (writer != INVALID_TXN_ID && writer != txn->GetTransactionId()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+auto TransactionManager::GetActiveTransactionTable() -> std::vector<std::pair<txn_id_t, lsn_t>> {
+  std::shared_lock<std::shared_mutex> l(txn_map_mutex_);
+  std::vector<std::pair<txn_id_t, lsn_t>> active_txn_table;
+  for (const auto &[txn_id, txn] : txn_map_) {
+    auto state = txn->GetState();
+    if (state == TransactionState::GROWING || state == TransactionState::SHRINKING) {
+      active_txn_table.emplace_back(txn_id, txn->GetPrevLSN());
+    }
+  }
+  return active_txn_table;
+}
+
+auto TransactionManager::GetOldestActiveLSN() -> lsn_t {
+  std::shared_lock<std::shared_mutex> l(txn_map_mutex_);
+  lsn_t oldest_lsn = INVALID_LSN;
+  for (const auto &[txn_id, txn] : txn_map_) {
+    auto state = txn->GetState();
+    if (state != TransactionState::GROWING && state != TransactionState::SHRINKING) {
+      continue;
+    }
+    auto first_lsn = txn->GetFirstLSN();
+    if (first_lsn != INVALID_LSN && (oldest_lsn == INVALID_LSN || first_lsn < oldest_lsn)) {
+      oldest_lsn = first_lsn;
+    }
+  }
+  return oldest_lsn;
+}
+
 void TransactionManager::BlockAllTransactions() { UNIMPLEMENTED("block is not supported now!"); }
 
 void TransactionManager::ResumeTransactions() { UNIMPLEMENTED("resume is not supported now!"); }
@@ -30,6 +30,7 @@
 #include "execution/executors/projection_executor.h"
 #include "execution/executors/seq_scan_executor.h"
 #include "execution/executors/sort_executor.h"
+#include "execution/executors/spool_executor.h"
 #include "execution/executors/topn_check_executor.h"
 #include "execution/executors/topn_executor.h"
 #include "execution/executors/update_executor.h"
@@ -38,6 +39,7 @@
 #include "execution/plans/mock_scan_plan.h"
 #include "execution/plans/projection_plan.h"
 #include "execution/plans/sort_plan.h"
+#include "execution/plans/spool_plan.h"
 #include "execution/plans/topn_plan.h"
 #include "execution/plans/values_plan.h"
 #include "storage/index/generic_key.h"
@@ -172,6 +174,13 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
       return std::make_unique<TopNExecutor>(exec_ctx, topn_plan, std::move(child));
     }
 
+      // Create a new spool executor
+    case PlanType::Spool: {
+      const auto *spool_plan = dynamic_cast<const SpoolPlanNode *>(plan.get());
+      auto child = ExecutorFactory::CreateExecutor(exec_ctx, spool_plan->GetChildPlan());
+      return std::make_unique<SpoolExecutor>(exec_ctx, spool_plan, std::move(child));
+    }
+
     default:
       UNREACHABLE("Unsupported plan type.");
   }
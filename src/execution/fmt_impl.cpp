@@ -8,6 +8,7 @@
 #include "execution/plans/abstract_plan.h"
 #include "execution/plans/aggregation_plan.h"
 #include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
 #include "execution/plans/limit_plan.h"
 #include "execution/plans/projection_plan.h"
 #include "execution/plans/sort_plan.h"
@@ -53,6 +54,29 @@ auto SortPlanNode::PlanNodeToString() const -> std::string {
   return fmt::format("Sort {{ order_bys={} }}", order_bys_);
 }
 
+auto IndexScanPlanNode::PlanNodeToString() const -> std::string {
+  std::string range;
+  if (!key_prefix_.empty()) {
+    range += fmt::format(", key_prefix={}", key_prefix_);
+  }
+  if (lower_.has_value() || upper_.has_value()) {
+    range += fmt::format(", range={}{}, {}{}", lower_.has_value() && lower_->inclusive_ ? "[" : "(",
+                         lower_.has_value() ? lower_->value_->ToString() : "-inf",
+                         upper_.has_value() ? upper_->value_->ToString() : "+inf",
+                         upper_.has_value() && upper_->inclusive_ ? "]" : ")");
+  }
+  if (filter_predicate_ != nullptr) {
+    range += fmt::format(", filter={}", filter_predicate_);
+  }
+  if (limit_.has_value()) {
+    range += fmt::format(", limit={}", *limit_);
+  }
+  if (index_only_) {
+    range += ", index_only=true";
+  }
+  return fmt::format("IndexScan {{ index_oid={}{} }}", index_oid_, range);
+}
+
 auto LimitPlanNode::PlanNodeToString() const -> std::string { return fmt::format("Limit {{ limit={} }}", limit_); }
 
 auto TopNPlanNode::PlanNodeToString() const -> std::string {
@@ -22,11 +22,15 @@ auto SeqScanPlanNode::InferScanSchema(const BoundBaseTableRef &table) -> Schema
   return Schema(schema);
 }
 
-auto NestedLoopJoinPlanNode::InferJoinSchema(const AbstractPlanNode &left, const AbstractPlanNode &right) -> Schema {
+auto NestedLoopJoinPlanNode::InferJoinSchema(const AbstractPlanNode &left, const AbstractPlanNode &right,
+                                             JoinType join_type) -> Schema {
   std::vector<Column> schema;
   for (const auto &column : left.OutputSchema().GetColumns()) {
     schema.emplace_back(column);
   }
+  if (join_type == JoinType::SEMI || join_type == JoinType::ANTI) {
+    return Schema(schema);
+  }
   for (const auto &column : right.OutputSchema().GetColumns()) {
     schema.emplace_back(column);
   }
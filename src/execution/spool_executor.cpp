@@ -0,0 +1,34 @@
+#include "execution/executors/spool_executor.h"
+
+namespace bustub {
+
+SpoolExecutor::SpoolExecutor(ExecutorContext *exec_ctx, const SpoolPlanNode *plan,
+                             std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void SpoolExecutor::Init() {
+  auto &spool = GetExecutorContext()->GetSpool(plan_->spool_id_);
+  if (!spool.materialized_) {
+    child_executor_->Init();
+    Tuple tuple{};
+    RID rid{};
+    while (child_executor_->Next(&tuple, &rid)) {
+      spool.tuples_.emplace_back(tuple, rid);
+    }
+    spool.materialized_ = true;
+  }
+  cursor_ = 0;
+}
+
+auto SpoolExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  const auto &tuples = GetExecutorContext()->GetSpool(plan_->spool_id_).tuples_;
+  if (cursor_ >= tuples.size()) {
+    return false;
+  }
+  *tuple = tuples[cursor_].first;
+  *rid = tuples[cursor_].second;
+  cursor_++;
+  return true;
+}
+
+}  // namespace bustub
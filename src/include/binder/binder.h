@@ -76,10 +76,13 @@ class BoundExpression;
 class BoundExpressionListRef;
 class BoundOrderBy;
 class BoundSubqueryRef;
+class AnalyzeStatement;
 class CreateStatement;
 class ExplainStatement;
 class IndexStatement;
 class DeleteStatement;
+class ExecuteStatement;
+class PrepareStatement;
 class UpdateStatement;
 
 /**
@@ -90,6 +93,9 @@ class Binder {
  public:
   explicit Binder(const Catalog &catalog);
 
+  /** Create a binder for queries with parameters `$1`, `$2`... of the given types. */
+  Binder(const Catalog &catalog, std::vector<TypeId> parameter_types);
+
   /** Attempts to parse a query into a series of SQL statements. The parsed statements
    * will be stored in the `statements_nodes_` variable.
    */
@@ -104,6 +110,9 @@ class Binder {
   /** Tokenize a query, returning the raw tokens together with their locations. */
   static auto Tokenize(const std::string &query) -> std::vector<SimplifiedToken>;
 
+  /** @return the text of each parsed statement, in order */
+  auto StatementTexts() const -> std::vector<std::string>;
+
   /** Transform a Postgres parse tree into a std::vector of SQL Statements. */
   void SaveParseTree(duckdb_libpgquery::PGList *tree);
 
@@ -143,6 +152,8 @@ class Binder {
 
   auto BindConstant(duckdb_libpgquery::PGAConst *node) -> std::unique_ptr<BoundExpression>;
 
+  auto BindParamRef(duckdb_libpgquery::PGParamRef *node) -> std::unique_ptr<BoundExpression>;
+
   auto BindColumnRef(duckdb_libpgquery::PGColumnRef *node) -> std::unique_ptr<BoundExpression>;
 
   auto BindResTarget(duckdb_libpgquery::PGResTarget *root) -> std::unique_ptr<BoundExpression>;
@@ -153,6 +164,8 @@ class Binder {
 
   auto BindAExpr(duckdb_libpgquery::PGAExpr *root) -> std::unique_ptr<BoundExpression>;
 
+  auto BindSubLink(duckdb_libpgquery::PGSubLink *root) -> std::unique_ptr<BoundExpression>;
+
   auto BindBoolExpr(duckdb_libpgquery::PGBoolExpr *root) -> std::unique_ptr<BoundExpression>;
 
   auto BindFrom(duckdb_libpgquery::PGList *list) -> std::unique_ptr<BoundTableRef>;
@@ -194,6 +207,8 @@ class Binder {
 
   auto BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement>;
 
+  auto BindAnalyze(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<AnalyzeStatement>;
+
   auto BindDelete(duckdb_libpgquery::PGDeleteStmt *stmt) -> std::unique_ptr<DeleteStatement>;
 
   auto BindUpdate(duckdb_libpgquery::PGUpdateStmt *stmt) -> std::unique_ptr<UpdateStatement>;
@@ -204,6 +219,10 @@ class Binder {
 
   auto BindVariableShow(duckdb_libpgquery::PGVariableShowStmt *stmt) -> std::unique_ptr<VariableShowStatement>;
 
+  auto BindPrepare(duckdb_libpgquery::PGPrepareStmt *stmt) -> std::unique_ptr<PrepareStatement>;
+
+  auto BindExecute(duckdb_libpgquery::PGExecuteStmt *stmt) -> std::unique_ptr<ExecuteStatement>;
+
   class ContextGuard {
    public:
     explicit ContextGuard(const BoundTableRef **scope, const CTEList **cte_scope) {
@@ -249,9 +268,22 @@ class Binder {
   /** The current scope for resolving tables in CTEs, used in binding tables */
   const CTEList *cte_scope_{nullptr};
 
+  /** The scopes of the queries enclosing the subquery being bound (innermost last), for correlated column refs */
+  std::vector<const BoundTableRef *> outer_scopes_;
+
+  /** Whether the subquery each of the outer scopes encloses reads its columns, or those of a scope around it */
+  std::vector<bool> correlated_;
+
   /** Sometimes we will need to assign a name to some unnamed items. This variable gives them a universal ID. */
   size_t universal_id_{0};
 
+  /** The types of the parameters `$1`, `$2`... the query may use. */
+  std::vector<TypeId> parameter_types_;
+
+  /** The text of the parsed query, and the part of it holding the statement being bound. */
+  std::string query_;
+  std::string statement_text_;
+
   duckdb::PostgresParser parser_;
 };
 
@@ -22,6 +22,8 @@ enum class ExpressionType : uint8_t {
   BINARY_OP = 9,  /**< Binary expression type. */
   ALIAS = 10,     /**< Alias expression type. */
   FUNC_CALL = 11, /**< Function call expression type. */
+  PARAMETER = 12, /**< Parameter expression type, e.g., `$1`. */
+  SUBQUERY = 13,  /**< Subquery expression type, e.g., `EXISTS (SELECT ...)`. */
 };
 
 /**
@@ -102,6 +104,12 @@ struct fmt::formatter<bustub::ExpressionType> : formatter<string_view> {
       case bustub::ExpressionType::FUNC_CALL:
         name = "FuncCall";
         break;
+      case bustub::ExpressionType::PARAMETER:
+        name = "Parameter";
+        break;
+      case bustub::ExpressionType::SUBQUERY:
+        name = "Subquery";
+        break;
     }
     return formatter<string_view>::format(name, ctx);
   }
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "binder/bound_expression.h"
+#include "fmt/format.h"
+#include "type/type_id.h"
+
+namespace bustub {
+
+class BoundExpression;
+
+/**
+ * A bound parameter of a prepared statement, e.g., `$1`. Its value is only known when the statement is executed.
+ */
+class BoundParameter : public BoundExpression {
+ public:
+  explicit BoundParameter(uint32_t param_idx, TypeId type)
+      : BoundExpression(ExpressionType::PARAMETER), param_idx_(param_idx), param_type_(type) {}
+
+  auto ToString() const -> std::string override { return fmt::format("${}", param_idx_ + 1); }
+
+  auto HasAggregation() const -> bool override { return false; }
+
+  /** The (0-based) index of the parameter. */
+  uint32_t param_idx_;
+
+  /** The type of the values the parameter takes. */
+  TypeId param_type_;
+};
+}  // namespace bustub
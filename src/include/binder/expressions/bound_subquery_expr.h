@@ -0,0 +1,55 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "binder/bound_expression.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+class SelectStatement;
+
+/**
+ * Kinds of subqueries in an expression.
+ */
+enum class SubqueryType : uint8_t {
+  INVALID = 0, /**< Invalid subquery type. */
+  SCALAR = 1,  /**< A subquery computing a single value, e.g., `(SELECT max(x) FROM t)`. */
+  EXISTS = 2,  /**< `EXISTS (SELECT ...)`. */
+  IN = 3,      /**< `x IN (SELECT ...)`, or `x = ANY (SELECT ...)`. */
+};
+
+/**
+ * A subquery in an expression, e.g., `EXISTS (SELECT * FROM t2 WHERE t2.y = t1.x)`. The subquery may reference the
+ * columns of the query it appears in (a correlated subquery).
+ */
+class BoundSubqueryExpr : public BoundExpression {
+ public:
+  explicit BoundSubqueryExpr(SubqueryType subquery_type, std::unique_ptr<SelectStatement> subquery,
+                             std::unique_ptr<BoundExpression> arg, bool is_correlated)
+      : BoundExpression(ExpressionType::SUBQUERY),
+        subquery_type_(subquery_type),
+        subquery_(std::move(subquery)),
+        arg_(std::move(arg)),
+        is_correlated_(is_correlated) {}
+
+  auto ToString() const -> std::string override;
+
+  auto HasAggregation() const -> bool override { return arg_ != nullptr && arg_->HasAggregation(); }
+
+  /** Kind of the subquery. */
+  SubqueryType subquery_type_;
+
+  /** The subquery. */
+  std::unique_ptr<SelectStatement> subquery_;
+
+  /** The left side of an IN subquery, nullptr for the other kinds. */
+  std::unique_ptr<BoundExpression> arg_;
+
+  /** Whether the subquery reads columns of the queries it is in. */
+  bool is_correlated_;
+};
+
+}  // namespace bustub
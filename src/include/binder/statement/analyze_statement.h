@@ -0,0 +1,29 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/analyze_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "binder/bound_statement.h"
+#include "binder/table_ref/bound_base_table_ref.h"
+
+namespace bustub {
+
+class AnalyzeStatement : public BoundStatement {
+ public:
+  explicit AnalyzeStatement(std::vector<std::unique_ptr<BoundBaseTableRef>> tables);
+
+  /** The tables to analyze, all the tables of the catalog for a bare `ANALYZE` */
+  std::vector<std::unique_ptr<BoundBaseTableRef>> tables_;
+
+  auto ToString() const -> std::string override;
+};
+
+}  // namespace bustub
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/prepare_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_statement.h"
+#include "common/enums/statement_type.h"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+#include "type/value.h"
+
+namespace bustub {
+
+class PrepareStatement : public BoundStatement {
+ public:
+  explicit PrepareStatement(std::string name, std::string query, std::vector<TypeId> parameter_types)
+      : BoundStatement(StatementType::PREPARE_STATEMENT),
+        name_(std::move(name)),
+        query_(std::move(query)),
+        parameter_types_(std::move(parameter_types)) {}
+
+  std::string name_;
+
+  /** The text of the prepared query, with parameters `$1`, `$2`... It is bound when executed. */
+  std::string query_;
+
+  /** The declared types of the parameters, empty if the types are taken from the values of each execution. */
+  std::vector<TypeId> parameter_types_;
+
+  auto ToString() const -> std::string override {
+    std::vector<std::string> types;
+    for (auto type : parameter_types_) {
+      types.emplace_back(Type::TypeIdToString(type));
+    }
+    return fmt::format("BoundPrepare {{ name={}, types={}, query={} }}", name_, types, query_);
+  }
+};
+
+class ExecuteStatement : public BoundStatement {
+ public:
+  explicit ExecuteStatement(std::string name, std::vector<Value> parameters)
+      : BoundStatement(StatementType::EXECUTE_STATEMENT), name_(std::move(name)), parameters_(std::move(parameters)) {}
+
+  std::string name_;
+
+  /** The values of the parameters `$1`, `$2`... */
+  std::vector<Value> parameters_;
+
+  auto ToString() const -> std::string override {
+    std::vector<std::string> parameters;
+    for (const auto &parameter : parameters_) {
+      parameters.emplace_back(parameter.ToString());
+    }
+    return fmt::format("BoundExecute {{ name={}, parameters={} }}", name_, parameters);
+  }
+};
+
+}  // namespace bustub
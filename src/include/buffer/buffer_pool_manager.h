@@ -16,6 +16,8 @@
 #include <memory>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "buffer/lru_k_replacer.h"
 #include "common/config.h"
@@ -172,6 +174,16 @@ class BufferPoolManager {
    */
   auto DeletePage(page_id_t page_id) -> bool;
 
+  /**
+   * @brief Take a snapshot of the dirty page table, used by fuzzy checkpoints.
+   *
+   * The recLSN of a dirty page is a lower bound on the LSN of the first log record that dirtied it, i.e. redo for
+   * this page never needs to start earlier than its recLSN.
+   *
+   * @return (page_id, recLSN) of every dirty page in the buffer pool
+   */
+  auto GetDirtyPageTable() -> std::vector<std::pair<page_id_t, lsn_t>>;
+
  private:
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
@@ -183,7 +195,7 @@ class BufferPoolManager {
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. Please ignore this for P1. */
-  LogManager *log_manager_ __attribute__((__unused__));
+  LogManager *log_manager_;
   /** Page table for keeping track of buffer pool pages. */
   std::unordered_map<page_id_t, frame_id_t> page_table_;
   /** Replacer to find unpinned pages for replacement. */
@@ -193,6 +205,37 @@ class BufferPoolManager {
   /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
   std::mutex latch_;
 
+  /** @brief Return the LSN that the next log record will get, or INVALID_LSN if logging is disabled. */
+  auto NextLSN() -> lsn_t { return log_manager_ == nullptr ? INVALID_LSN : log_manager_->GetNextLSN(); }
+
+  /**
+   * @brief Write a page to disk and mark it clean. The log must already be flushed up to the page LSN (see
+   * UnflushedLSN), so that no change reaches the disk before its log record (write-ahead logging). Caller should
+   * acquire the latch.
+   * @param page the page to write back
+   */
+  void WritePageBack(Page *page);
+
+  /**
+   * @brief Caller should acquire the latch.
+   * @return the LSN the log must be flushed up to before page can be written back, INVALID_LSN if it can be now
+   */
+  auto UnflushedLSN(const Page *page) -> lsn_t;
+
+  /**
+   * @brief Flush the log up to lsn with the latch released, so that no page access waits on the log write. The
+   * pages may have changed once the latch is held again.
+   * @param lock the held latch
+   */
+  void ForceLog(std::unique_lock<std::mutex> *lock, lsn_t lsn);
+
+  /**
+   * @brief Take a free frame, or evict a page to free one. Caller should acquire the latch, which is released while a
+   * dirty victim waits for the log.
+   * @return the frame, or -1 if every frame is pinned
+   */
+  auto AcquireFrame(std::unique_lock<std::mutex> *lock) -> frame_id_t;
+
   /**
    * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
    * @return the id of the allocated page
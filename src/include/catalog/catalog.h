@@ -20,6 +20,7 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "catalog/table_statistics.h"
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
@@ -56,6 +57,8 @@ struct TableInfo {
   std::unique_ptr<TableHeap> table_;
   /** The table OID */
   const table_oid_t oid_;
+  /** The statistics of the last ANALYZE of the table, null if it was never analyzed */
+  std::shared_ptr<const TableStatistics> statistics_;
 };
 
 /**
@@ -115,16 +118,26 @@ class Catalog {
   Catalog(BufferPoolManager *bpm, LockManager *lock_manager, LogManager *log_manager)
       : bpm_{bpm}, lock_manager_{lock_manager}, log_manager_{log_manager} {}
 
+  /**
+   * @return the version of the catalog, which changes with every table, index or statistics a plan may depend on. A
+   * cached plan is only valid for the version it was planned with.
+   */
+  auto GetVersion() const -> uint64_t { return version_.load(); }
+
+  /** Record a change that may affect plans without going through the catalog, e.g. new statistics of a table. */
+  void BumpVersion() { version_.fetch_add(1); }
+
   /**
    * Create a new table and return its metadata.
    * @param txn The transaction in which the table is being created
    * @param table_name The name of the new table, note that all tables beginning with `__` are reserved for the system.
    * @param schema The schema of the new table
    * @param create_table_heap whether to create a table heap for the new table
+   * @param format the page layout of the table heap
    * @return A (non-owning) pointer to the metadata for the table
    */
-  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true)
-      -> TableInfo * {
+  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true,
+                   TableFormat format = TableFormat::ROW) -> TableInfo * {
     if (table_names_.count(table_name) != 0) {
       return NULL_TABLE_INFO;
     }
@@ -136,7 +149,7 @@ class Catalog {
     // When create_table_heap == false, it means that we're running binder tests (where no txn will be provided) or
     // we are running shell without buffer pool. We don't need to create TableHeap in this case.
     if (create_table_heap) {
-      table = std::make_unique<TableHeap>(bpm_);
+      table = std::make_unique<TableHeap>(bpm_, schema, format);
     }
 
     // Fetch the table OID for the new table
@@ -150,6 +163,7 @@ class Catalog {
     tables_.emplace(table_oid, std::move(meta));
     table_names_.emplace(table_name, table_oid);
     index_names_.emplace(table_name, std::unordered_map<std::string, index_oid_t>{});
+    BumpVersion();
 
     return tmp;
   }
@@ -246,6 +260,7 @@ class Catalog {
     // Update internal tracking
     indexes_.emplace(index_oid, std::move(index_info));
     table_indexes.emplace(index_name, index_oid);
+    BumpVersion();
 
     return tmp;
   }
@@ -298,7 +313,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
@@ -333,7 +348,7 @@ class Catalog {
     return indexes;
   }
 
-  auto GetTableNames() -> std::vector<std::string> {
+  auto GetTableNames() const -> std::vector<std::string> {
     std::vector<std::string> result;
     for (const auto &x : table_names_) {
       result.push_back(x.first);
@@ -371,6 +386,9 @@ class Catalog {
 
   /** The next index identifier to be used. */
   std::atomic<index_oid_t> next_index_oid_{0};
+
+  /** The version of the catalog, see GetVersion(). */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_statistics.h
+//
+// Identification: src/include/catalog/table_statistics.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/comparison_expression.h"
+#include "type/value.h"
+
+namespace bustub {
+
+class TableHeap;
+
+/** The number of rows ANALYZE samples for histograms and null fractions. */
+static constexpr size_t STATISTICS_SAMPLE_SIZE = 10000;
+/** The number of buckets of an equi-depth histogram. */
+static constexpr size_t STATISTICS_HISTOGRAM_BUCKETS = 32;
+
+/**
+ * HyperLogLog sketch counting the distinct values of a column in one pass with a fixed amount of memory. With 2^10
+ * registers the standard error is about 3%.
+ */
+class HyperLogLog {
+ public:
+  static constexpr uint32_t PRECISION = 10;
+  static constexpr uint32_t NUM_REGISTERS = 1 << PRECISION;
+
+  HyperLogLog() : registers_(NUM_REGISTERS, 0) {}
+
+  /** Add a non-null value to the sketch. */
+  void Add(const Value &value);
+
+  /** @return the estimated number of distinct values added */
+  auto Estimate() const -> uint64_t;
+
+ private:
+  std::vector<uint8_t> registers_;
+};
+
+/**
+ * Statistics of one column. The histogram is equi-depth: every bucket holds about the same number of the non-null
+ * sampled values, and bounds_[i] is the smallest value of bucket i, the last bound being the maximum.
+ */
+struct ColumnStatistics {
+  /** The fraction of rows whose value is null. */
+  double null_fraction_{0};
+  /** The estimated number of distinct non-null values. */
+  uint64_t distinct_count_{0};
+  /** The histogram bounds, empty if no non-null value was sampled. */
+  std::vector<Value> histogram_bounds_;
+
+  /** @return the estimated fraction of rows for which (column comp_type constant) is true */
+  auto EstimateSelectivity(ComparisonType comp_type, const Value &constant) const -> double;
+
+ private:
+  /** @return the estimated fraction of the non-null values that are less than value */
+  auto FractionBelow(const Value &value) const -> double;
+};
+
+/**
+ * Statistics of a table, built by ANALYZE and kept in its TableInfo. The row count is the one at ANALYZE time; the
+ * table heap maintains the current one (TableHeap::GetRowCount).
+ */
+class TableStatistics {
+ public:
+  /**
+   * Build the statistics of a table in one pass over its heap. Every live row feeds the distinct value sketches, and
+   * a reservoir sample of sample_size rows feeds the histograms and null fractions.
+   */
+  static auto Analyze(TableHeap *table_heap, const Schema &schema, size_t sample_size = STATISTICS_SAMPLE_SIZE)
+      -> TableStatistics;
+
+  /** @return the number of live rows at ANALYZE time */
+  auto GetRowCount() const -> uint64_t { return row_count_; }
+
+  auto GetColumnStatistics(uint32_t column_idx) const -> const ColumnStatistics & { return columns_[column_idx]; }
+
+  auto ToString(const Schema &schema) const -> std::string;
+
+ private:
+  uint64_t row_count_{0};
+  std::vector<ColumnStatistics> columns_;
+};
+
+}  // namespace bustub
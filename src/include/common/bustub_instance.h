@@ -22,11 +22,13 @@
 #include <utility>
 #include <vector>
 
+#include "binder/statement/prepare_statement.h"
 #include "catalog/catalog.h"
 #include "common/config.h"
 #include "common/util/string_util.h"
 #include "execution/check_options.h"
 #include "libfort/lib/fort.hpp"
+#include "planner/plan_cache.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -42,6 +44,7 @@ class CheckpointManager;
 class Catalog;
 class ExecutionEngine;
 
+class AnalyzeStatement;
 class CreateStatement;
 class IndexStatement;
 class VariableSetStatement;
@@ -263,6 +266,15 @@ class BustubInstance {
   ExecutionEngine *execution_engine_;
   std::shared_mutex catalog_lock_;
 
+  /** The plans of the queries executed recently, see `ParameterizeQuery`. */
+  PlanCache plan_cache_;
+
+  /**
+   * @return the optimized plan ExecuteSql runs for a SELECT, INSERT, UPDATE or DELETE statement, through the plan
+   * cache; nullptr if the statement does not go through the plan cache or cannot be planned.
+   */
+  auto ExecutedPlan(const std::string &sql) -> AbstractPlanNodeRef;
+
   auto GetSessionVariable(const std::string &key) -> std::string {
     if (session_variables_.find(key) != session_variables_.end()) {
       return session_variables_[key];
@@ -283,11 +295,33 @@ class BustubInstance {
 
   void HandleCreateStatement(Transaction *txn, const CreateStatement &stmt, ResultWriter &writer);
   void HandleIndexStatement(Transaction *txn, const IndexStatement &stmt, ResultWriter &writer);
+  void HandleAnalyzeStatement(Transaction *txn, const AnalyzeStatement &stmt, ResultWriter &writer);
   void HandleExplainStatement(Transaction *txn, const ExplainStatement &stmt, ResultWriter &writer);
   void HandleVariableShowStatement(Transaction *txn, const VariableShowStatement &stmt, ResultWriter &writer);
   void HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt, ResultWriter &writer);
+  void HandlePrepareStatement(Transaction *txn, const PrepareStatement &stmt, ResultWriter &writer);
+  auto HandleExecuteStatement(Transaction *txn, const ExecuteStatement &stmt, ResultWriter &writer,
+                              std::shared_ptr<CheckOptions> check_options) -> bool;
+
+  /**
+   * Plan a query with parameters of the given types, or take its plan from the plan cache.
+   * @return the plan, or the error planning the query raised
+   */
+  auto PlanCachedQuery(const std::string &query, const std::vector<TypeId> &parameter_types)
+      -> std::shared_ptr<const CachedPlan>;
+
+  /** @return the generic plan of a cached query, or its custom plan for the values of the parameters */
+  auto OptimizeCachedPlan(const CachedPlan &cached, const std::vector<Value> &parameters) -> AbstractPlanNodeRef;
+
+  /** Execute an optimized plan with the given parameter values, and write its result set. */
+  auto ExecutePlan(Transaction *txn, const AbstractPlanNodeRef &plan, const Schema &output_schema, bool is_modify,
+                   const std::vector<Value> &parameters, ResultWriter &writer,
+                   std::shared_ptr<CheckOptions> check_options) -> bool;
 
   std::unordered_map<std::string, std::string> session_variables_;
+
+  /** The prepared statements of the session, by name. */
+  std::unordered_map<std::string, PrepareStatement> prepared_statements_;
 };
 
 }  // namespace bustub
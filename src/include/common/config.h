@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
 
 namespace bustub {
@@ -27,6 +28,15 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/**
+ * A transaction holding more than lock_escalation_threshold row locks on one table tries to escalate them to a single
+ * table lock. 0 disables escalation.
+ */
+extern std::atomic<size_t> lock_escalation_threshold;
+
+/** A fuzzy checkpoint flushes at most CHECKPOINT_FLUSH_BATCH dirty pages every checkpoint_flush_interval. */
+extern std::chrono::milliseconds checkpoint_flush_interval;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
@@ -36,6 +46,8 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int CHECKPOINT_FLUSH_BATCH = 8;  // dirty pages written per round of a fuzzy checkpoint
+static constexpr int PLAN_CACHE_SIZE = 256;       // plans kept by the plan cache of a bustub instance
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
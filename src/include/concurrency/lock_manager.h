@@ -17,6 +17,7 @@
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -173,6 +174,15 @@ class LockManager {
    * BOOK KEEPING:
    *    If a lock is granted to a transaction, lock manager should update its
    *    lock sets appropriately (check transaction.h)
+   *
+   *
+   * LOCK ESCALATION:
+   *    Once a transaction holds more than lock_escalation_threshold row locks on a table, LockRow() tries to replace
+   *    them with one table lock: IS -> S, IX -> SIX, or X if any of the row locks is exclusive. The upgrade is only
+   *    attempted if it can be granted right away, so escalation never blocks. On success the row locks are released,
+   *    and later row locks covered by the table lock are granted without touching the row lock map. The escalated
+   *    rows are only remembered in a per-transaction set, so that UnlockRow() accepts them; unlocking any other row
+   *    still aborts the transaction.
    */
 
   /**
@@ -274,6 +284,18 @@ class LockManager {
    */
   auto UnlockRow(Transaction *txn, const table_oid_t &oid, const RID &rid, bool force = false) -> bool;
 
+  /** @return the number of times row locks were escalated to a table lock */
+  auto GetEscalationCount() const -> uint64_t { return escalation_count_.load(); }
+
+  /** @return the number of row locks released by escalations */
+  auto GetEscalatedRowLockCount() const -> uint64_t { return escalated_row_lock_count_.load(); }
+
+  /** @return the number of rows with a lock request queue */
+  auto GetRowLockQueueCount() -> size_t {
+    std::scoped_lock<std::mutex> guard(row_lock_map_latch_);
+    return row_lock_map_.size();
+  }
+
   /*** Graph API ***/
 
   /**
@@ -307,7 +329,7 @@ class LockManager {
    */
   auto RunCycleDetection() -> void;
 
-  TransactionManager *txn_manager_;
+  TransactionManager *txn_manager_{nullptr};
 
  private:
   /** Spring 2023 */
@@ -319,6 +341,15 @@ class LockManager {
   void GrantNewLocksIfPossible(LockRequestQueue *lock_request_queue);
   auto CanLockUpgrade(LockMode curr_lock_mode, LockMode requested_lock_mode) -> bool;
   auto CheckAppropriateLockOnTable(Transaction *txn, const table_oid_t &oid, LockMode row_lock_mode) -> bool;
+  auto AcquireLock(Transaction *txn, LockRequestQueue *queue, LockRequest *request) -> bool;
+  auto ReleaseLock(Transaction *txn, LockRequestQueue *queue) -> std::optional<LockMode>;
+  void UpdateLockSets(Transaction *txn, const LockRequest &request, bool insert);
+  void UpdateTransactionState(Transaction *txn, LockMode released_lock_mode);
+  auto CoverRowByEscalation(Transaction *txn, const table_oid_t &oid, const RID &rid, LockMode row_lock_mode) -> bool;
+  auto ReleaseEscalatedRow(Transaction *txn, const table_oid_t &oid, const RID &rid) -> std::optional<LockMode>;
+  void EraseRowQueueIfUnused(const RID &rid);
+  void TryEscalate(Transaction *txn, const table_oid_t &oid);
+  auto TryUpgradeLockTable(Transaction *txn, const table_oid_t &oid, LockMode lock_mode) -> bool;
   auto FindCycle(txn_id_t source_txn, std::vector<txn_id_t> &path, std::unordered_set<txn_id_t> &on_path,
                  std::unordered_set<txn_id_t> &visited, txn_id_t *abort_txn_id) -> bool;
   void UnlockAll();
@@ -333,8 +364,16 @@ class LockManager {
   /** Coordination */
   std::mutex row_lock_map_latch_;
 
-  std::atomic<bool> enable_cycle_detection_;
-  std::thread *cycle_detection_thread_;
+  /** Rows covered by the table lock each transaction escalated to, by table, with the mode they were locked in */
+  std::unordered_map<txn_id_t, std::unordered_map<table_oid_t, std::unordered_map<RID, LockMode>>> escalated_rows_;
+  /** Coordination */
+  std::mutex escalated_rows_latch_;
+  /** Metrics */
+  std::atomic<uint64_t> escalation_count_{0};
+  std::atomic<uint64_t> escalated_row_lock_count_{0};
+
+  std::atomic<bool> enable_cycle_detection_{false};
+  std::thread *cycle_detection_thread_{nullptr};
   /** Waits-for graph representation. */
   std::unordered_map<txn_id_t, std::vector<txn_id_t>> waits_for_;
   std::mutex waits_for_latch_;
@@ -77,6 +77,22 @@ class TableWriteRecord {
   WType wtype_;
 };
 
+/**
+ * ReadRecord tracks a tuple read without a lock by an optimistic transaction.
+ */
+class TableReadRecord {
+ public:
+  // NOLINTNEXTLINE
+  TableReadRecord(table_oid_t tid, RID rid, TableHeap *table_heap, uint32_t version)
+      : tid_(tid), rid_(rid), table_heap_(table_heap), version_(version) {}
+
+  table_oid_t tid_;
+  RID rid_;
+  TableHeap *table_heap_;
+  /** The version of the tuple when it was read, see TupleMeta::version_. */
+  uint32_t version_;
+};
+
 /**
  * WriteRecord tracks information related to a write.
  */
@@ -119,7 +135,8 @@ enum class AbortReason {
   ATTEMPTED_INTENTION_LOCK_ON_ROW,
   TABLE_UNLOCKED_BEFORE_UNLOCKING_ROWS,
   INCOMPATIBLE_UPGRADE,
-  ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD
+  ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD,
+  READ_VALIDATION_FAILED
 };
 
 /**
@@ -155,6 +172,8 @@ class TransactionAbortException : public std::exception {
         return "Transaction " + std::to_string(txn_id_) + " aborted because attempted lock upgrade is incompatible\n";
       case AbortReason::ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD:
         return "Transaction " + std::to_string(txn_id_) + " aborted because attempted to unlock but no lock held \n";
+      case AbortReason::READ_VALIDATION_FAILED:
+        return "Transaction " + std::to_string(txn_id_) + " aborted because a tuple it read was changed\n";
     }
     // Todo: Should fail with unreachable.
     return "";
@@ -179,6 +198,7 @@ class Transaction {
         s_row_lock_set_{new std::unordered_map<table_oid_t, std::unordered_set<RID>>},
         x_row_lock_set_{new std::unordered_map<table_oid_t, std::unordered_set<RID>>} {
     // Initialize the sets that will be tracked.
+    table_read_set_ = std::make_shared<std::deque<TableReadRecord>>();
     table_write_set_ = std::make_shared<std::deque<TableWriteRecord>>();
     index_write_set_ = std::make_shared<std::deque<IndexWriteRecord>>();
     page_set_ = std::make_shared<std::deque<bustub::Page *>>();
@@ -198,6 +218,24 @@ class Transaction {
   /** @return the isolation level of this transaction */
   inline auto GetIsolationLevel() const -> IsolationLevel { return isolation_level_; }
 
+  /**
+   * @return true if the transaction reads optimistically: reads take no row locks, they are recorded in the read set
+   * and validated when the transaction commits. Only used with REPEATABLE_READ.
+   */
+  inline auto IsOptimistic() const -> bool { return optimistic_; }
+
+  /** Switch the transaction to optimistic reads, must be called before it reads anything. */
+  inline void SetOptimistic(bool optimistic) { optimistic_ = optimistic; }
+
+  /** @return the list of table read records of this transaction */
+  inline auto GetReadSet() -> std::shared_ptr<std::deque<TableReadRecord>> { return table_read_set_; }
+
+  /**
+   * Adds a tuple read record into the table read set.
+   * @param read_record read record to be added
+   */
+  inline void AppendTableReadRecord(const TableReadRecord &read_record) { table_read_set_->push_back(read_record); }
+
   /** @return the list of table write records of this transaction */
   inline auto GetWriteSet() -> std::shared_ptr<std::deque<TableWriteRecord>> { return table_write_set_; }
 
@@ -323,6 +361,15 @@ class Transaction {
    */
   inline void SetPrevLSN(lsn_t prev_lsn) { prev_lsn_ = prev_lsn; }
 
+  /** @return the LSN of the first record written by the transaction */
+  inline auto GetFirstLSN() -> lsn_t { return first_lsn_; }
+
+  /**
+   * Set the first LSN.
+   * @param first_lsn the lsn of the BEGIN record of this transaction
+   */
+  inline void SetFirstLSN(lsn_t first_lsn) { first_lsn_ = first_lsn; }
+
  private:
   /** The current transaction state. */
   TransactionState state_{TransactionState::GROWING};
@@ -333,12 +380,19 @@ class Transaction {
   /** The ID of this transaction. */
   txn_id_t txn_id_;
 
+  /** True if reads are validated at commit instead of locked. */
+  bool optimistic_{false};
+
+  /** The read set of an optimistic transaction. */
+  std::shared_ptr<std::deque<TableReadRecord>> table_read_set_;
   /** The undo set of table tuples. */
   std::shared_ptr<std::deque<TableWriteRecord>> table_write_set_;
   /** The undo set of indexes. */
   std::shared_ptr<std::deque<IndexWriteRecord>> index_write_set_;
   /** The LSN of the last record written by the transaction. */
   lsn_t prev_lsn_;
+  /** The LSN of the first record written by the transaction, undo never goes back further than this. */
+  lsn_t first_lsn_{INVALID_LSN};
 
   std::mutex latch_;
 
@@ -13,9 +13,12 @@
 #pragma once
 
 #include <atomic>
+#include <mutex>  // NOLINT
 #include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "concurrency/lock_manager.h"
@@ -51,6 +54,7 @@ class TransactionManager {
       LogRecord record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::BEGIN);
       lsn_t lsn = log_manager_->AppendLogRecord(&record);
       txn->SetPrevLSN(lsn);
+      txn->SetFirstLSN(lsn);
     }
 
     std::unique_lock<std::shared_mutex> l(txn_map_mutex_);
@@ -59,8 +63,14 @@ class TransactionManager {
   }
 
   /**
-   * Commits a transaction.
+   * Commits a transaction. With logging enabled, the locks are released as soon as the commit record is appended,
+   * and the call returns once the commit record is durable. An optimistic transaction first validates its read set;
+   * if a tuple it read has changed since, the transaction is aborted instead.
+   *
+   * Committing any transaction, optimistic or not, clears its id from the insert_txn_id_ and delete_txn_id_ of the
+   * tuples in its write set: a writer id left in a TupleMeta always marks a change that has not committed.
    * @param txn the transaction to commit
+   * @throws TransactionAbortException if the read set of an optimistic transaction fails validation
    */
   void Commit(Transaction *txn);
 
@@ -91,6 +101,19 @@ class TransactionManager {
     return res;
   }
 
+  /**
+   * Takes a snapshot of the active transaction table, used by fuzzy checkpoints. Transactions keep running while the
+   * snapshot is taken; only the transaction map latch is held.
+   * @return (txn_id, last lsn) of every transaction that has neither committed nor aborted
+   */
+  auto GetActiveTransactionTable() -> std::vector<std::pair<txn_id_t, lsn_t>>;
+
+  /**
+   * @return the smallest first LSN among the active transactions, i.e. the oldest log record undo may still need, or
+   * INVALID_LSN if there is no active transaction that has written a log record
+   */
+  auto GetOldestActiveLSN() -> lsn_t;
+
   /** Prevents all transactions from performing operations, used for checkpointing. */
   void BlockAllTransactions();
 
@@ -98,6 +121,17 @@ class TransactionManager {
   void ResumeTransactions();
 
  private:
+  /**
+   * Checks that no tuple in the read set of an optimistic transaction was changed, or is being changed, by another
+   * transaction since it was read. Must be called with commit_mutex_ held.
+   * @param txn the transaction to validate
+   * @return true if the read set is still valid
+   */
+  auto ValidateReadSet(Transaction *txn) -> bool;
+
+  /** Serializes read set validation with the commit record of the validated transaction. */
+  std::mutex commit_mutex_;
+
   /**
    * Releases all the locks held by the given transaction.
    * @param txn the transaction whose locks should be released
@@ -150,7 +184,7 @@ class TransactionManager {
 
   std::atomic<txn_id_t> next_txn_id_{0};
   LockManager *lock_manager_ __attribute__((__unused__));
-  LogManager *log_manager_ __attribute__((__unused__));
+  LogManager *log_manager_;
 };
 
 }  // namespace bustub
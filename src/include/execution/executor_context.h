@@ -14,6 +14,7 @@
 
 #include <deque>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -26,6 +27,17 @@
 
 namespace bustub {
 class AbstractExecutor;
+
+/**
+ * A Spool holds the output of a plan materialized once per query, read back by every spool executor with its id.
+ */
+struct Spool {
+  /** Whether the output has been materialized */
+  bool materialized_{false};
+  /** The materialized tuples, in the order the plan produced them */
+  std::vector<std::pair<Tuple, RID>> tuples_;
+};
+
 /**
  * ExecutorContext stores all the context necessary to run an executor.
  */
@@ -93,6 +105,9 @@ class ExecutorContext {
 
   auto IsDelete() const -> bool { return is_delete_; }
 
+  /** @return the spool with the id, empty until a spool executor materializes it */
+  auto GetSpool(uint32_t spool_id) -> Spool & { return spools_[spool_id]; }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -109,6 +124,8 @@ class ExecutorContext {
   /** The set of check options associated with this executor context */
   std::shared_ptr<CheckOptions> check_options_;
   bool is_delete_;
+  /** The spools materialized by the query, by id */
+  std::unordered_map<uint32_t, Spool> spools_;
 };
 
 }  // namespace bustub
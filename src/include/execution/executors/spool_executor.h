@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// spool_executor.h
+//
+// Identification: src/include/execution/executors/spool_executor.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/spool_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * The SpoolExecutor materializes the output of its child into the spool of the query the first time one of the
+ * executors of the spool is initialized, and reads it back with its own cursor.
+ */
+class SpoolExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new SpoolExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The spool plan to be executed
+   * @param child_executor The child executor, only executed if the spool is not materialized yet
+   */
+  SpoolExecutor(ExecutorContext *exec_ctx, const SpoolPlanNode *plan,
+                std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  /** Initialize the spool, materializing it if needed */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the spool.
+   * @param[out] tuple The next tuple produced by the spool
+   * @param[out] rid The next tuple RID produced by the spool
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /** @return The output schema for the spool plan */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
+
+ private:
+  /** The spool plan node to be executed */
+  const SpoolPlanNode *plan_;
+
+  /** The child executor from which tuples are obtained */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The position of the next tuple in the spool */
+  size_t cursor_{0};
+};
+}  // namespace bustub
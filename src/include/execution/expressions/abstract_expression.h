@@ -20,6 +20,7 @@
 #include "catalog/schema.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_view.h"
 
 #define BUSTUB_EXPR_CLONE_WITH_CHILDREN(cname)                                                                   \
   auto CloneWithChildren(std::vector<AbstractExpressionRef> children) const->std::unique_ptr<AbstractExpression> \
@@ -54,6 +55,16 @@ class AbstractExpression {
   /** @return The value obtained by evaluating the tuple with the given schema */
   virtual auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value = 0;
 
+  /**
+   * Evaluate a tuple in place on its page. The default implementation copies the tuple out of the page; expressions
+   * over columns, constants and comparisons override it to read the page directly.
+   * @return The value obtained by evaluating the tuple view with the given schema
+   */
+  virtual auto EvaluateView(const TupleView &view, const Schema &schema) const -> Value {
+    auto tuple = view.ToTuple();
+    return Evaluate(&tuple, schema);
+  }
+
   /**
    * Returns the value obtained by evaluating a JOIN.
    * @param left_tuple The left tuple
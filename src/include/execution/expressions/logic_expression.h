@@ -45,16 +45,18 @@ class LogicExpression : public AbstractExpression {
   }
 
   auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
-    Value lhs = GetChildAt(0)->Evaluate(tuple, schema);
-    Value rhs = GetChildAt(1)->Evaluate(tuple, schema);
-    return ValueFactory::GetBooleanValue(PerformComputation(lhs, rhs));
+    return Compute([&](const AbstractExpressionRef &child) { return child->Evaluate(tuple, schema); });
+  }
+
+  auto EvaluateView(const TupleView &view, const Schema &schema) const -> Value override {
+    return Compute([&](const AbstractExpressionRef &child) { return child->EvaluateView(view, schema); });
   }
 
   auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                     const Schema &right_schema) const -> Value override {
-    Value lhs = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
-    Value rhs = GetChildAt(1)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
-    return ValueFactory::GetBooleanValue(PerformComputation(lhs, rhs));
+    return Compute([&](const AbstractExpressionRef &child) {
+      return child->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
+    });
   }
 
   /** @return the string representation of the expression node and its children */
@@ -77,9 +79,22 @@ class LogicExpression : public AbstractExpression {
     return CmpBool::CmpFalse;
   }
 
-  auto PerformComputation(const Value &lhs, const Value &rhs) const -> CmpBool {
-    auto l = GetBoolAsCmpBool(lhs);
-    auto r = GetBoolAsCmpBool(rhs);
+  /**
+   * Evaluate the left side, and the right side only if the left one does not decide the result: `false AND x` is
+   * false and `true OR x` is true whatever x is. The optimizer puts the cheaper operand on the left.
+   */
+  template <typename EvaluateChild>
+  auto Compute(EvaluateChild &&evaluate_child) const -> Value {
+    auto l = GetBoolAsCmpBool(evaluate_child(GetChildAt(0)));
+    if ((logic_type_ == LogicType::And && l == CmpBool::CmpFalse) ||
+        (logic_type_ == LogicType::Or && l == CmpBool::CmpTrue)) {
+      return ValueFactory::GetBooleanValue(l);
+    }
+    auto r = GetBoolAsCmpBool(evaluate_child(GetChildAt(1)));
+    return ValueFactory::GetBooleanValue(PerformComputation(l, r));
+  }
+
+  auto PerformComputation(CmpBool l, CmpBool r) const -> CmpBool {
     switch (logic_type_) {
       case LogicType::And:
         if (l == CmpBool::CmpFalse || r == CmpBool::CmpFalse) {
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parameter_value_expression.h
+//
+// Identification: src/include/execution/expressions/parameter_value_expression.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "execution/expressions/abstract_expression.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+/**
+ * ParameterBinding binds the values of the parameters of a plan on the current thread for as long as it lives, so
+ * that a cached plan can be executed by several threads at once with different values.
+ */
+class ParameterBinding {
+ public:
+  explicit ParameterBinding(const std::vector<Value> *values) : previous_(current) { current = values; }
+
+  ~ParameterBinding() { current = previous_; }
+
+  DISALLOW_COPY_AND_MOVE(ParameterBinding);
+
+  /** @return the values bound on the current thread, nullptr if none */
+  static auto Current() -> const std::vector<Value> * { return current; }
+
+ private:
+  inline static thread_local const std::vector<Value> *current = nullptr;
+
+  const std::vector<Value> *previous_;
+};
+
+/**
+ * ParameterValueExpression represents a parameter `$n` of a prepared or cached plan. It evaluates to the value bound
+ * by the ParameterBinding of the execution.
+ */
+class ParameterValueExpression : public AbstractExpression {
+ public:
+  /** Creates a new parameter value expression for the parameter at the given (0-based) index. */
+  ParameterValueExpression(uint32_t param_idx, TypeId ret_type)
+      : AbstractExpression({}, ret_type), param_idx_(param_idx) {}
+
+  auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
+    const auto *values = ParameterBinding::Current();
+    if (values == nullptr || param_idx_ >= values->size()) {
+      throw Exception(fmt::format("no value bound for parameter ${}", param_idx_ + 1));
+    }
+    return (*values)[param_idx_];
+  }
+
+  auto EvaluateView(const TupleView &view, const Schema &schema) const -> Value override {
+    return Evaluate(nullptr, schema);
+  }
+
+  auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+                    const Schema &right_schema) const -> Value override {
+    return Evaluate(nullptr, left_schema);
+  }
+
+  /** @return the string representation of the plan node and its children */
+  auto ToString() const -> std::string override { return fmt::format("${}", param_idx_ + 1); }
+
+  BUSTUB_EXPR_CLONE_WITH_CHILDREN(ParameterValueExpression);
+
+  uint32_t param_idx_;
+};
+
+}  // namespace bustub
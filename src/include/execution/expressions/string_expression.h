@@ -44,30 +44,25 @@ class StringExpression : public AbstractExpression {
     }
   }
 
-  auto Lower(const std::string &val) const -> std::string {
-    std::string str;
-    for (const char &ch : val) {
-      str.push_back(std::tolower(ch));
-    }
-    return str;
+  /** Convert in place: the argument already is the copy the result is made of. */
+  auto Lower(std::string val) const -> std::string {
+    std::transform(val.begin(), val.end(), val.begin(), [](unsigned char ch) { return std::tolower(ch); });
+    return val;
   }
 
-  auto Upper(const std::string &val) const -> std::string {
-    std::string str;
-    for (const char &ch : val) {
-      str.push_back(std::toupper(ch));
-    }
-    return str;
+  auto Upper(std::string val) const -> std::string {
+    std::transform(val.begin(), val.end(), val.begin(), [](unsigned char ch) { return std::toupper(ch); });
+    return val;
   }
 
-  auto Compute(const std::string &val) const -> std::string {
+  auto Compute(std::string val) const -> std::string {
     // TODO(student): implement upper / lower.
     switch (expr_type_) {
       case bustub::StringExpressionType::Lower:
-        return Lower(val);
+        return Lower(std::move(val));
         break;
       case bustub::StringExpressionType::Upper:
-        return Upper(val);
+        return Upper(std::move(val));
         break;
       default:
         return {};
@@ -77,15 +72,19 @@ class StringExpression : public AbstractExpression {
 
   auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
     Value val = GetChildAt(0)->Evaluate(tuple, schema);
-    auto str = val.GetAs<char *>();
-    return ValueFactory::GetVarcharValue(Compute(str));
+    if (val.IsNull()) {
+      return ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+    }
+    return ValueFactory::GetVarcharValue(Compute(val.GetAs<char *>()));
   }
 
   auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                     const Schema &right_schema) const -> Value override {
     Value val = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
-    auto str = val.GetAs<char *>();
-    return ValueFactory::GetVarcharValue(Compute(str));
+    if (val.IsNull()) {
+      return ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+    }
+    return ValueFactory::GetVarcharValue(Compute(val.GetAs<char *>()));
   }
 
   /** @return the string representation of the expression node and its children */
@@ -12,16 +12,33 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "catalog/catalog.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
 
 namespace bustub {
+
+/** A bound of an index range scan on one key column. */
+struct IndexScanBound {
+  /** The bound value, an expression without column references. */
+  AbstractExpressionRef value_;
+  bool inclusive_;
+};
+
 /**
  * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
+ *
+ * Without a key range, the scan returns every tuple in key order. Otherwise, the keys scanned have their first
+ * columns equal to key_prefix_, and the next key column within [lower_, upper_] (a missing bound is unbounded). With
+ * every key column in the prefix, the scan is a point lookup.
+ *
+ * An index-only scan builds its tuples from the index keys, without fetching them from the table: its output schema
+ * (and the columns its filter predicate reads) is the key schema of the index.
  */
 class IndexScanPlanNode : public AbstractPlanNode {
  public:
@@ -33,6 +50,25 @@ class IndexScanPlanNode : public AbstractPlanNode {
   IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
       : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
 
+  /**
+   * Creates a new index scan plan node over a key range.
+   * @param output the output format of this scan plan node
+   * @param index_oid the identifier of the index to be scanned
+   * @param key_prefix the values of the leading key columns
+   * @param lower the lower bound of the key column after the prefix, if any
+   * @param upper the upper bound of the key column after the prefix, if any
+   * @param filter_predicate the predicate the key range does not cover, evaluated on every tuple, nullptr if none
+   */
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, std::vector<AbstractExpressionRef> key_prefix,
+                    std::optional<IndexScanBound> lower, std::optional<IndexScanBound> upper,
+                    AbstractExpressionRef filter_predicate)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        key_prefix_(std::move(key_prefix)),
+        lower_(std::move(lower)),
+        upper_(std::move(upper)),
+        filter_predicate_(std::move(filter_predicate)) {}
+
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
   /** @return the identifier of the table that should be scanned */
@@ -40,15 +76,26 @@ class IndexScanPlanNode : public AbstractPlanNode {
 
   BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(IndexScanPlanNode);
 
+  /** @return whether the scan covers a key range rather than the whole index */
+  auto HasKeyRange() const -> bool { return !key_prefix_.empty() || lower_.has_value() || upper_.has_value(); }
+
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** The values of the leading key columns. */
+  std::vector<AbstractExpressionRef> key_prefix_;
+  /** The bounds of the key column after the prefix. */
+  std::optional<IndexScanBound> lower_;
+  std::optional<IndexScanBound> upper_;
+  /** The predicate to evaluate on the tuples in the key range, nullptr if none. */
+  AbstractExpressionRef filter_predicate_;
+  /** The number of tuples (passing filter_predicate_) after which the scan may stop, if any, under a limit node. */
+  std::optional<size_t> limit_;
+  /** Whether the scan reads its tuples from the index keys. */
+  bool index_only_{false};
 
  protected:
-  auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
-  }
+  auto PlanNodeToString() const -> std::string override;
 };
 
 }  // namespace bustub
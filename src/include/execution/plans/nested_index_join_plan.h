@@ -30,6 +30,8 @@ namespace bustub {
  * NestedIndexJoinPlanNode is used to represent performing a nested index join between two tables
  * The outer table tuples are propagated using a child executor, but the inner table tuples should be
  * obtained using the outer table tuples as well as the index from the catalog.
+ * With index_only_, the inner tuples are built from the index keys without fetching them from the table, and the
+ * inner table schema is the key schema of the index.
  */
 class NestedIndexJoinPlanNode : public AbstractPlanNode {
  public:
@@ -81,10 +83,13 @@ class NestedIndexJoinPlanNode : public AbstractPlanNode {
   /** The join type */
   JoinType join_type_;
 
+  /** Whether the inner tuples are read from the index keys. */
+  bool index_only_{false};
+
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("NestedIndexJoin {{ type={}, key_predicate={}, index={}, index_table={} }}", join_type_,
-                       key_predicate_, index_name_, index_table_name_);
+    return fmt::format("NestedIndexJoin {{ type={}, key_predicate={}, index={}, index_table={}{} }}", join_type_,
+                       key_predicate_, index_name_, index_table_name_, index_only_ ? ", index_only=true" : "");
   }
 };
 }  // namespace bustub
@@ -57,7 +57,10 @@ class NestedLoopJoinPlanNode : public AbstractPlanNode {
   /** @return The right plan node of the nested loop join */
   auto GetRightPlan() const -> AbstractPlanNodeRef { return GetChildAt(1); }
 
-  static auto InferJoinSchema(const AbstractPlanNode &left, const AbstractPlanNode &right) -> Schema;
+  /** @return the output schema of a join: the left columns followed by the right ones, the left ones only for semi
+   * and anti joins */
+  static auto InferJoinSchema(const AbstractPlanNode &left, const AbstractPlanNode &right,
+                              JoinType join_type = JoinType::INNER) -> Schema;
 
   BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(NestedLoopJoinPlanNode);
 
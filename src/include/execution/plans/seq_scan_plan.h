@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -62,12 +63,19 @@ class SeqScanPlanNode : public AbstractPlanNode {
   */
   AbstractExpressionRef filter_predicate_;
 
+  /** The number of tuples (passing filter_predicate_) after which the scan may stop, if any, under a limit node. */
+  std::optional<size_t> limit_;
+
  protected:
   auto PlanNodeToString() const -> std::string override {
+    std::string options;
     if (filter_predicate_) {
-      return fmt::format("SeqScan {{ table={}, filter={} }}", table_name_, filter_predicate_);
+      options += fmt::format(", filter={}", filter_predicate_);
+    }
+    if (limit_.has_value()) {
+      options += fmt::format(", limit={}", *limit_);
     }
-    return fmt::format("SeqScan {{ table={} }}", table_name_);
+    return fmt::format("SeqScan {{ table={}{} }}", table_name_, options);
   }
 };
 
@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// spool_plan.h
+//
+// Identification: src/include/execution/plans/spool_plan.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "execution/plans/abstract_plan.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+/**
+ * The SpoolPlanNode materializes the output of its child once per query, and reads it back for every spool node with
+ * the same id, e.g. the references to a common table expression. The child of every such node is the same plan, only
+ * one of them is executed.
+ */
+class SpoolPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new SpoolPlanNode instance.
+   * @param output The output schema of this spool plan node
+   * @param child The child plan whose output is materialized
+   * @param spool_id The spool the output is materialized into, shared by the nodes reading the same plan
+   */
+  SpoolPlanNode(SchemaRef output, AbstractPlanNodeRef child, uint32_t spool_id)
+      : AbstractPlanNode(std::move(output), {std::move(child)}), spool_id_{spool_id} {}
+
+  /** @return The type of the plan node */
+  auto GetType() const -> PlanType override { return PlanType::Spool; }
+
+  /** @return The child plan node */
+  auto GetChildPlan() const -> AbstractPlanNodeRef {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Spool should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(SpoolPlanNode);
+
+  /** The spool the output of the child is materialized into */
+  uint32_t spool_id_;
+
+ protected:
+  auto PlanNodeToString() const -> std::string override { return fmt::format("Spool {{ id={} }}", spool_id_); }
+};
+
+}  // namespace bustub
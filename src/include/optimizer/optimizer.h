@@ -26,6 +26,14 @@ class Optimizer {
 
   auto OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @return whether the optimized plan depends on the values of its parameters. The parameters bound on the thread
+   * (see ParameterBinding) are simplified into constants, which the later rules use like the literals of the query:
+   * the plan is then only valid for these values. Unbound parameters are left as they are, but a value could have
+   * changed the choices of the rules as well.
+   */
+  auto DependsOnParameters() const -> bool { return depends_on_parameters_; }
+
  private:
   /**
    * @brief merge projections that do identical project.
@@ -53,6 +61,51 @@ class Optimizer {
    */
   auto OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief push the conjuncts of filters down to the lowest node that can evaluate them.
+   * Conjuncts go through projections (subqueries), sorts, inner joins, the preserved side of left joins, and
+   * aggregations when they only read group keys. Conjuncts over both sides of an inner nested loop join become part
+   * of its predicate, and the parts of a join predicate that read one side only move below the join.
+   */
+  auto OptimizePredicatePushdown(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief drop the columns no node above reads.
+   * Projections and aggregations compute only the columns used above them, and a projection over every scan keeps
+   * only the columns the query reads, so that joins, sorts and aggregations carry narrower tuples.
+   */
+  auto OptimizeColumnPruning(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief reorder the inner joins of a multi-way join by estimated cost.
+   * A tree of inner nested loop joins (and filters over them) is flattened into a join graph whose vertices are the
+   * relations below it and whose edges are the conjuncts of the join predicates. Conjuncts over a single relation are
+   * pushed down to it. The cheapest join tree is enumerated with DPccp for up to 10 relations, and built greedily for
+   * larger or disconnected graphs. Every join picks its algorithm (nested loop, hash or nested index join) and which
+   * side builds the hash table. A projection restores the original column order if the joins were reordered.
+   */
+  auto OptimizeJoinOrder(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief fold constants and simplify boolean logic in the expressions of the plan.
+   * Bound parameters become constants, and subtrees over constants are evaluated once at plan time. AND / OR drop
+   * their neutral operands, collapse to their absorbing ones, and order their operands for short-circuit evaluation:
+   * cheap operands likely to decide the result first, using the selectivities of the table statistics for a filter
+   * over a scan. A filter that is always true is removed, one that is never true becomes an empty values node.
+   */
+  auto OptimizeSimplifyExpressions(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /** @brief simplify an expression, see OptimizeSimplifyExpressions. table_name is the table of its columns, if any. */
+  auto SimplifyExpression(const AbstractExpressionRef &expr, const std::string &table_name) -> AbstractExpressionRef;
+
+  /**
+   * @brief evaluate the subexpressions repeated in a filter or a projection once per row.
+   * A projection below the node computes each repeated subexpression into a column, which the node reads instead,
+   * e.g. `lower(name)` in `lower(name) = 'x' OR lower(name) = 'y'`. A subexpression is only computed ahead when one of
+   * its occurrences is evaluated for every row, i.e. not only under the right operand of AND or OR.
+   */
+  auto OptimizeCommonSubexpressions(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /**
    * @brief eliminate always true filter
    */
@@ -79,10 +132,21 @@ class Optimizer {
   auto IsPredicateTrue(const AbstractExpressionRef &expr) -> bool;
 
   /**
-   * @brief optimize order by as index scan if there's an index on a table
+   * @brief optimize order by as index scan if there's an index on a table.
+   * A sort (ascending, on columns) over a scan, or a filter over a scan, is dropped when an index returns the rows in
+   * its order: a sequential scan becomes a scan of the whole index, and an index scan already returns its key range in
+   * key order, where the key columns it fixes do not matter.
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief optimize a filter over a sequential scan as an index scan over a key range.
+   * Equality conjuncts with constants on a prefix of the key columns of an index, and range conjuncts on the key column
+   * after it, bound the scan; the other conjuncts are evaluated on the fetched tuples. The index that keeps the fewest
+   * rows is used, and only if it keeps few enough for random fetches to beat reading the whole table.
+   */
+  auto OptimizeFilterAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /** @brief check if the index can be matched */
   auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
@@ -93,20 +157,45 @@ class Optimizer {
   auto OptimizeSortLimitAsTopN(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
   /**
-   * @brief get the estimated cardinality for a table based on the table name. Useful when join reordering. BusTub
-   * doesn't support statistics for now, so it's the only way for you to get the table size :(
+   * @brief push limits down to the scans, so that they stop after the rows the query returns.
+   * The limit node stays where it is and still enforces the limit; the scan only gets its limit as a hint to stop
+   * early. The hint goes through projections, and nested limits merge into the smallest one. A filter under a limit
+   * moves into the scan below it, which then stops after the limit of rows passing the filter. A limit over a sort is
+   * left for the top N rule.
+   */
+  auto OptimizeLimitPushdown(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief get the estimated cardinality for a table. Useful when join reordering. For a table of the catalog, this is
+   * the row count its heap maintains. Other tables (e.g. mock tables) are sized by their name suffix (`_1m`, `_1k`...).
    *
    * @param table_name
-   * @return std::optional<size_t>
+   * @return std::optional<size_t>, nullopt if nothing is known about the table
    */
   auto EstimatedCardinality(const std::string &table_name) -> std::optional<size_t>;
 
+  /**
+   * @brief get the estimated number of distinct values of a column, from the statistics of the last ANALYZE.
+   * @return std::optional<size_t>, nullopt if the table was never analyzed
+   */
+  auto EstimatedDistinctCount(const std::string &table_name, uint32_t col_idx) -> std::optional<size_t>;
+
+  /**
+   * @brief estimate the fraction of the rows of a table a predicate over its columns keeps. Comparisons of a column
+   * with a constant use the histograms and distinct counts of the last ANALYZE; without statistics, or for other
+   * predicates, the usual fixed guesses are used (1/10 for equality, 1/3 for anything else).
+   */
+  auto EstimateSelectivity(const std::string &table_name, const AbstractExpressionRef &predicate) -> double;
+
   /** Catalog will be used during the planning process. USERS SHOULD ENSURE IT OUTLIVES
    * OPTIMIZER, otherwise it's a dangling reference.
    */
   const Catalog &catalog_;
 
   const bool force_starter_rule_;
+
+  /** Whether an expression the rules simplify reads a parameter, see DependsOnParameters. */
+  bool depends_on_parameters_{false};
 };
 
 }  // namespace bustub
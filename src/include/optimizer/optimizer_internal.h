@@ -1,8 +1,33 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+
 namespace bustub {
 
 // Note: You can define your optimizer helper functions here
 void OptimizerHelperFunction();
 
+/** Maps the (tuple_idx, col_idx) of a column reference to the one it is rewritten to. */
+using ColumnMapping = std::function<std::pair<uint32_t, uint32_t>(uint32_t tuple_idx, uint32_t col_idx)>;
+
+/** @return a copy of the expression whose column references are rewritten by the mapping */
+auto MapColumns(const AbstractExpressionRef &expr, const ColumnMapping &mapping) -> AbstractExpressionRef;
+
+/** Append the col_idx of every column reference of the expression to columns. */
+void CollectColumns(const AbstractExpressionRef &expr, std::vector<uint32_t> *columns);
+
+/** @return the set of tuples (bit 0 for the left one, bit 1 for the right one) a join predicate reads */
+auto ReadTuples(const AbstractExpressionRef &expr) -> uint32_t;
+
+/** Append the conjuncts of an AND tree to conjuncts, leaving out those that are always true. */
+void SplitConjuncts(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *conjuncts);
+
+/** @return the AND of the conjuncts, true if there are none */
+auto MakeConjunction(const std::vector<AbstractExpressionRef> &conjuncts) -> AbstractExpressionRef;
+
 }  // namespace bustub
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "execution/plans/abstract_plan.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** A query whose literals were replaced by parameters. */
+struct ParameterizedQuery {
+  /** The text of the query, with `$1`, `$2`... in place of its literals. */
+  std::string query_;
+  /** The values of the literals. */
+  std::vector<Value> parameters_;
+};
+
+/**
+ * Replace the integer and string literals of a query by parameters, so that queries that only differ in their
+ * constants share a plan. Whitespace and comments are normalized away, and the literals the planner needs as constants
+ * (the counts of LIMIT and OFFSET) are kept.
+ * @return the parameterized query, nullopt if the text is not a single SELECT, INSERT, UPDATE or DELETE statement
+ */
+auto ParameterizeQuery(const std::string &sql) -> std::optional<ParameterizedQuery>;
+
+/**
+ * The plan of a query with parameters, or the error planning it raised. A plan the optimizer made with choices that
+ * depend on the values of the parameters (index ranges, selectivities, folded constants) is no generic plan: the
+ * query is optimized again for the values of each execution, a custom plan.
+ */
+struct CachedPlan {
+  /** The plan of the planner, before optimization; nullptr if planning failed. */
+  AbstractPlanNodeRef plan_;
+  /** The optimized plan for any values of the parameters, nullptr if there is none. */
+  AbstractPlanNodeRef generic_plan_;
+  /** The output schema of the planner, which names the columns of the result. */
+  SchemaRef output_schema_;
+  /** Whether the plan updates or deletes tuples. */
+  bool is_modify_{false};
+  /** The error raised planning the query. */
+  std::string error_;
+};
+
+/**
+ * PlanCache keeps the plans of the most recently used queries, keyed by the text of the query and the types of its
+ * parameters. A plan is only returned for the catalog version it was planned with; the entries of other versions are
+ * dropped when looked up.
+ */
+class PlanCache {
+ public:
+  explicit PlanCache(size_t capacity = PLAN_CACHE_SIZE) : capacity_(capacity) {}
+
+  /** @return the plan of the query for the catalog version, nullptr if there is none */
+  auto Get(const std::string &query, const std::vector<TypeId> &parameter_types, uint64_t catalog_version)
+      -> std::shared_ptr<const CachedPlan>;
+
+  /** Cache the plan of a query, evicting the least recently used plan if the cache is full. */
+  void Put(const std::string &query, const std::vector<TypeId> &parameter_types, uint64_t catalog_version,
+           std::shared_ptr<const CachedPlan> plan);
+
+  /** Drop every plan, e.g. when a setting the optimizer reads changes. */
+  void Clear();
+
+  /** @return the number of cached plans */
+  auto Size() -> size_t;
+
+ private:
+  struct Entry {
+    std::string key_;
+    uint64_t catalog_version_;
+    std::shared_ptr<const CachedPlan> plan_;
+  };
+
+  static auto MakeKey(const std::string &query, const std::vector<TypeId> &parameter_types) -> std::string;
+
+  size_t capacity_;
+  std::mutex latch_;
+  /** The entries, most recently used first. */
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+}  // namespace bustub
@@ -21,6 +21,7 @@ class BoundStatement;
 class SelectStatement;
 class DeleteStatement;
 class AbstractPlanNode;
+class SpoolPlanNode;
 class InsertStatement;
 class BoundExpression;
 class BoundTableRef;
@@ -36,6 +37,7 @@ class BoundExpressionListRef;
 class BoundAggCall;
 class BoundCTERef;
 class BoundFuncCall;
+class BoundSubqueryExpr;
 class ColumnValueExpression;
 
 /**
@@ -71,6 +73,11 @@ class PlannerContext {
    * CTE in scope.
    */
   const CTEList *cte_list_{nullptr};
+
+  /**
+   * The scalar subqueries planned as joins, and the name of the column holding their value in the output of the join.
+   */
+  std::unordered_map<const BoundSubqueryExpr *, std::string> scalar_subqueries_;
 };
 
 /**
@@ -101,14 +108,25 @@ class Planner {
 
   auto PlanSubquery(const BoundSubqueryRef &table_ref, const std::string &alias) -> AbstractPlanNodeRef;
 
+  /** @return a projection renaming the output columns of the plan of a subquery to the names under the alias */
+  auto RenameSubquery(AbstractPlanNodeRef plan, const BoundSubqueryRef &table_ref, const std::string &alias)
+      -> AbstractPlanNodeRef;
+
   auto PlanBaseTableRef(const BoundBaseTableRef &table_ref) -> AbstractPlanNodeRef;
 
   auto PlanCrossProductRef(const BoundCrossProductRef &table_ref) -> AbstractPlanNodeRef;
 
   auto PlanJoinRef(const BoundJoinRef &table_ref) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief Plan a reference to a CTE. The CTE is planned once, under a spool shared by all its references, so that
+   * it is computed once however many times it is referenced.
+   */
   auto PlanCTERef(const BoundCTERef &table_ref) -> AbstractPlanNodeRef;
 
+  /** @return the plan without the spools that have a single reader, which would only copy the rows */
+  auto InlineSingleReaderSpools(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   auto PlanExpressionListRef(const BoundExpressionListRef &table_ref) -> AbstractPlanNodeRef;
 
   void AddAggCallToContext(BoundExpression &expr);
@@ -128,7 +146,51 @@ class Planner {
   auto PlanConstant(const BoundConstant &expr, const std::vector<AbstractPlanNodeRef> &children)
       -> AbstractExpressionRef;
 
-  auto PlanSelectAgg(const SelectStatement &statement, AbstractPlanNodeRef child) -> AbstractPlanNodeRef;
+  /**
+   * @brief Plan the aggregation of a select statement over child.
+   * @param correlation_keys extra group keys over child, output before the select list. A correlated scalar subquery
+   * is grouped by the columns it is joined on.
+   */
+  auto PlanSelectAgg(const SelectStatement &statement, AbstractPlanNodeRef child,
+                     std::vector<AbstractExpressionRef> correlation_keys = {}) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief Plan the conjuncts of a WHERE clause over plan.
+   *
+   * `EXISTS` and `IN` subqueries become semi joins with the subquery, `NOT EXISTS` anti joins, and the other conjuncts
+   * a filter below them. A correlated subquery is decorrelated: the conjuncts of its WHERE clause that read the
+   * enclosing query become part of the join predicate, so that the join can be a hash join. `NOT IN` is rejected, see
+   * PlanSemiJoin.
+   */
+  auto PlanWhere(const std::vector<const BoundExpression *> &conjuncts, AbstractPlanNodeRef plan)
+      -> AbstractPlanNodeRef;
+
+  /** @brief Join plan with the scalar subqueries in expr, so that they can be planned as columns of its output. */
+  auto PlanScalarSubqueries(const BoundExpression &expr, AbstractPlanNodeRef plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief Plan an `EXISTS` or `IN` subquery as a semi join of plan with it, or a `NOT EXISTS` subquery as an anti
+   * join. `NOT IN` throws: it is false or NULL rather than true when the subquery returns a NULL or the argument is
+   * NULL, which an anti join does not express.
+   */
+  auto PlanSemiJoin(const BoundSubqueryExpr &expr, bool anti, AbstractPlanNodeRef plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief Plan a scalar subquery as a left join of plan with it. A correlated one is grouped by the columns of its
+   * equality conditions with plan, and joined on them.
+   */
+  auto PlanScalarSubquery(const BoundSubqueryExpr &expr, AbstractPlanNodeRef plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief Plan the FROM and WHERE clauses of a correlated subquery of a query planned as outer, leaving out the
+   * conjuncts of its WHERE clause that read the columns of outer.
+   * @return the plan, and the conjuncts left out
+   */
+  auto PlanCorrelatedSubquery(const SelectStatement &subquery, const AbstractPlanNodeRef &outer)
+      -> std::tuple<AbstractPlanNodeRef, std::vector<const BoundExpression *>>;
+
+  auto PlanSubqueryExpr(const BoundSubqueryExpr &expr, const std::vector<AbstractPlanNodeRef> &children)
+      -> AbstractExpressionRef;
 
   auto PlanAggCall(const BoundAggCall &agg_call, const std::vector<AbstractPlanNodeRef> &children)
       -> std::tuple<AggregationType, std::vector<AbstractExpressionRef>>;
@@ -184,6 +246,12 @@ class Planner {
 
   /** An id for all unnamed things */
   size_t universal_id_{0};
+
+  /** The spool every planned CTE is read from, by CTE */
+  std::unordered_map<const BoundSubqueryRef *, std::shared_ptr<const SpoolPlanNode>> cte_spools_;
+
+  /** The number of references to each spool, by spool id */
+  std::vector<size_t> spool_readers_;
 };
 
 static constexpr const char *const UNNAMED_COLUMN = "<unnamed>";
@@ -3,12 +3,13 @@
 #include <algorithm>
 #include <cstddef>
 #include <future>  // NOLINT
-#include <map>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -40,6 +41,41 @@ class MoveBlocked {
   std::future<int> wait_;
 };
 
+class TrieNode;
+
+// TrieChildren maps the next character of a key to the child TrieNode. Like the small nodes of an adaptive radix
+// tree, it keeps the keys sorted in one contiguous byte array next to an array of child pointers, instead of a
+// red-black tree with a heap node per child. Cloning a node on the copy-on-write path copies two small arrays, and a
+// lookup compares 16 keys at a time with SSE2 where available.
+class TrieChildren {
+ public:
+  TrieChildren() = default;
+
+  // Get the child for the given character, or nullptr if there is none.
+  auto Find(char key) const -> const std::shared_ptr<const TrieNode> *;
+
+  // Set the child for the given character, replacing any existing child.
+  void InsertOrAssign(char key, std::shared_ptr<const TrieNode> child);
+
+  // Remove the child for the given character. Returns false if there is none.
+  auto Erase(char key) -> bool;
+
+  auto Size() const -> size_t { return keys_.size(); }
+
+  auto Empty() const -> bool { return keys_.empty(); }
+
+  // The i-th character and child, in character order.
+  auto KeyAt(size_t i) const -> char { return keys_[i]; }
+  auto ChildAt(size_t i) const -> const std::shared_ptr<const TrieNode> & { return children_[i]; }
+
+ private:
+  // The index of the given character in keys_, or keys_.size() if it is not present.
+  auto IndexOf(char key) const -> size_t;
+
+  std::vector<char> keys_;
+  std::vector<std::shared_ptr<const TrieNode>> children_;
+};
+
 // A TrieNode is a node in a Trie.
 class TrieNode {
  public:
@@ -47,7 +83,7 @@ class TrieNode {
   TrieNode() = default;
 
   // Create a TrieNode with some children.
-  explicit TrieNode(std::map<char, std::shared_ptr<const TrieNode>> children) : children_(std::move(children)) {}
+  explicit TrieNode(TrieChildren children) : children_(std::move(children)) {}
 
   virtual ~TrieNode() = default;
 
@@ -58,10 +94,19 @@ class TrieNode {
   // contains a value or not.
   //
   // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
-  virtual auto Clone() const -> std::unique_ptr<TrieNode> { return std::make_unique<TrieNode>(children_); }
+  virtual auto Clone() const -> std::unique_ptr<TrieNode> {
+    auto node = std::make_unique<TrieNode>(children_);
+    node->prefix_ = prefix_;
+    return node;
+  }
+
+  // The children, where the key is the next character in the key, and the value is the next TrieNode.
+  TrieChildren children_;
 
-  // A map of children, where the key is the next character in the key, and the value is the next TrieNode.
-  std::map<char, std::shared_ptr<const TrieNode>> children_;
+  // The characters of the key that follow the one leading to this node from its parent (path compression). A chain
+  // of nodes with a single child and no value is stored as its last node, whose prefix_ holds the skipped characters.
+  // The prefix of the root is always empty.
+  std::string prefix_;
 
   // Indicates if the node is the terminal node.
   bool is_value_node_{false};
@@ -78,7 +123,7 @@ class TrieNodeWithValue : public TrieNode {
   explicit TrieNodeWithValue(std::shared_ptr<T> value) : value_(std::move(value)) { this->is_value_node_ = true; }
 
   // Create a trie node with children and a value.
-  TrieNodeWithValue(std::map<char, std::shared_ptr<const TrieNode>> children, std::shared_ptr<T> value)
+  TrieNodeWithValue(TrieChildren children, std::shared_ptr<T> value)
       : TrieNode(std::move(children)), value_(std::move(value)) {
     this->is_value_node_ = true;
   }
@@ -87,7 +132,9 @@ class TrieNodeWithValue : public TrieNode {
   //
   // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
   auto Clone() const -> std::unique_ptr<TrieNode> override {
-    return std::make_unique<TrieNodeWithValue<T>>(children_, value_);
+    auto node = std::make_unique<TrieNodeWithValue<T>>(children_, value_);
+    node->prefix_ = prefix_;
+    return node;
   }
 
   // The value associated with this trie node.
@@ -105,6 +152,26 @@ class Trie {
   // Create a new trie with the given root.
   explicit Trie(std::shared_ptr<const TrieNode> root) : root_(std::move(root)) {}
 
+  // Get the node reached by the key from the given node, or nullptr if there is none.
+  static auto FindNode(const TrieNode *node, std::string_view key) -> const TrieNode *;
+
+  // Get a writable version of a node: the node itself if it is in `fresh`, the set of nodes created by the current
+  // batch, or else a clone, which is added to `fresh`.
+  static auto Writable(const std::shared_ptr<const TrieNode> &node, std::unordered_set<const TrieNode *> *fresh)
+      -> std::shared_ptr<TrieNode>;
+
+  // Get a writable version of an existing child of a node being built by a batch, see Writable().
+  static auto CloneChildOnce(TrieNode *parent, char key, std::unordered_set<const TrieNode *> *fresh) -> TrieNode *;
+
+  // Put a value under the key, below a root in `fresh`. Splits the compressed path where the key leaves it.
+  template <class T>
+  static void PutValue(std::shared_ptr<TrieNode> *root, std::string_view key, std::shared_ptr<T> value,
+                       std::unordered_set<const TrieNode *> *fresh);
+
+  // Get the children of a node about to be replaced by a batch, moving them out if the node is in `fresh`.
+  static auto TakeChildren(const std::shared_ptr<const TrieNode> &node,
+                           const std::unordered_set<const TrieNode *> &fresh) -> TrieChildren;
+
  public:
   // Create an empty trie.
   Trie() = default;
@@ -124,6 +191,16 @@ class Trie {
   // Remove the key from the trie. If the key does not exist, return the original trie.
   // Otherwise, returns the new trie.
   auto Remove(std::string_view key) const -> Trie;
+
+  // Put a batch of key-value pairs into the trie, in order, so a later pair overwrites an earlier one with the same
+  // key. Every node is cloned at most once for the whole batch, so the upper levels shared by the keys are copied
+  // once instead of once per key. Returns the new trie.
+  template <class T>
+  auto PutBatch(std::vector<std::pair<std::string, T>> entries) const -> Trie;
+
+  // Remove a batch of keys from the trie, cloning every node at most once for the whole batch. Keys that do not exist
+  // are skipped. Returns the new trie, or the original trie if none of the keys exist.
+  auto RemoveBatch(const std::vector<std::string> &keys) const -> Trie;
 };
 
 }  // namespace bustub
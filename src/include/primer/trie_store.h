@@ -1,22 +1,93 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
 #include <optional>
-#include <shared_mutex>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "primer/trie.h"
 
 namespace bustub {
 
-// This class is used to guard the value returned by the trie. It holds a reference to the root so
-// that the reference to the value will not be invalidated.
+// EpochManager tracks which versions of a TrieStore readers may still be using. A reader pins the current epoch in
+// one of a fixed set of slots before it loads the root, and unpins it when it is done. A writer retires the version
+// it replaces with the epoch at the time of the swap, and frees it once every pinned epoch is newer. Readers
+// therefore never touch a reference count or a lock.
+class EpochManager {
+ public:
+  static constexpr size_t NUM_SLOTS = 64;
+  static constexpr uint64_t INACTIVE_EPOCH = UINT64_MAX;
+
+  // Pins the current epoch. Returns the slot used, or NUM_SLOTS if every slot is taken.
+  auto Enter() -> size_t;
+
+  // Unpins the epoch pinned in the given slot.
+  void Exit(size_t slot) { slots_[slot].epoch_.store(INACTIVE_EPOCH); }
+
+  // Starts a new epoch. Returns the epoch that just ended.
+  auto Advance() -> uint64_t { return global_epoch_.fetch_add(1); }
+
+  // Returns the oldest pinned epoch, or the current epoch if nothing is pinned.
+  auto OldestActiveEpoch() const -> uint64_t;
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> epoch_{INACTIVE_EPOCH};
+  };
+
+  std::atomic<uint64_t> global_epoch_{0};
+  std::array<Slot, NUM_SLOTS> slots_;
+};
+
+// EpochGuard keeps an epoch pinned for as long as it lives.
+class EpochGuard {
+ public:
+  EpochGuard() = default;
+  explicit EpochGuard(EpochManager *manager) : manager_(manager), slot_(manager->Enter()) {}
+  EpochGuard(EpochGuard &&that) noexcept : manager_(that.manager_), slot_(that.slot_) { that.manager_ = nullptr; }
+  EpochGuard(const EpochGuard &) = delete;
+  auto operator=(const EpochGuard &) -> EpochGuard & = delete;
+  auto operator=(EpochGuard &&that) noexcept -> EpochGuard & {
+    if (this != &that) {
+      Release();
+      manager_ = std::exchange(that.manager_, nullptr);
+      slot_ = that.slot_;
+    }
+    return *this;
+  }
+  ~EpochGuard() { Release(); }
+
+  // Whether an epoch is pinned. Pinning fails if every slot is taken.
+  auto IsPinned() const -> bool { return manager_ != nullptr && slot_ != EpochManager::NUM_SLOTS; }
+
+ private:
+  void Release() {
+    if (IsPinned()) {
+      manager_->Exit(slot_);
+    }
+    manager_ = nullptr;
+  }
+
+  EpochManager *manager_{nullptr};
+  size_t slot_{EpochManager::NUM_SLOTS};
+};
+
+// This class is used to guard the value returned by the trie. It either holds a reference to the root, or keeps an
+// epoch pinned, so that the reference to the value will not be invalidated.
 template <class T>
 class ValueGuard {
  public:
   ValueGuard(Trie root, const T &value) : root_(std::move(root)), value_(value) {}
+  ValueGuard(EpochGuard epoch, const T &value) : epoch_(std::move(epoch)), value_(value) {}
   auto operator*() const -> const T & { return value_; }
 
  private:
+  EpochGuard epoch_;
   Trie root_;
   const T &value_;
 };
@@ -26,6 +97,11 @@ class ValueGuard {
 // time.
 class TrieStore {
  public:
+  TrieStore() = default;
+  TrieStore(const TrieStore &) = delete;
+  auto operator=(const TrieStore &) -> TrieStore & = delete;
+  ~TrieStore();
+
   // This function returns a ValueGuard object that holds a reference to the value in the trie. If
   // the key does not exist in the trie, it will return std::nullopt.
   template <class T>
@@ -39,16 +115,34 @@ class TrieStore {
   // This function will remove the key-value pair from the trie.
   void Remove(std::string_view key);
 
+  // This function will insert a batch of key-value pairs into the trie, see `Trie::PutBatch`. The whole batch becomes
+  // visible to readers at once.
+  template <class T>
+  void PutBatch(std::vector<std::pair<std::string, T>> entries);
+
+  // This function will remove a batch of keys from the trie, see `Trie::RemoveBatch`.
+  void RemoveBatch(const std::vector<std::string> &keys);
+
  private:
-  // This mutex protects the root. Everytime you want to access the trie root or modify it, you
-  // will need to take this lock.
-  std::shared_mutex root_lock_;
+  // Replaces the root with a new version of the trie, and frees the retired versions no reader can still see. The
+  // caller must hold the write lock.
+  void PublishRoot(Trie root);
 
-  // This mutex sequences all writes operations and allows only one write operation at a time.
+  // This mutex sequences all writes operations and allows only one write operation at a time. Only writers replace
+  // the root, so a writer holding it may read the root directly.
   std::mutex write_lock_;
 
-  // Stores the current root for the trie.
-  Trie root_;
+  // Stores the current root for the trie. Readers load it with their epoch pinned.
+  std::atomic<Trie *> root_{new Trie()};
+
+  // The current version again, for the readers that find every epoch slot taken. Accessed with std::atomic_load and
+  // std::atomic_store only.
+  std::shared_ptr<const Trie> snapshot_{std::make_shared<const Trie>()};
+
+  // Replaced versions, with the epoch in which they were replaced. Protected by the write lock.
+  std::vector<std::pair<uint64_t, std::unique_ptr<Trie>>> retired_;
+
+  EpochManager epoch_manager_;
 };
 
 }  // namespace bustub
@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/transaction_manager.h"
 #include "recovery/log_manager.h"
@@ -19,7 +22,9 @@
 namespace bustub {
 
 /**
- * CheckpointManager creates consistent checkpoints by blocking all other transactions temporarily.
+ * CheckpointManager creates fuzzy checkpoints. Transactions keep running during a checkpoint: the checkpoint only
+ * snapshots the active transaction table and the dirty page table, and then writes the dirty pages back in small
+ * batches in the background.
  */
 class CheckpointManager {
  public:
@@ -31,13 +36,27 @@ class CheckpointManager {
 
   ~CheckpointManager() = default;
 
+  /**
+   * Log BEGIN_CHECKPOINT, snapshot the active transaction table and the dirty page table, and log them in an
+   * END_CHECKPOINT record.
+   */
   void BeginCheckpoint();
+
+  /**
+   * Write back the dirty pages captured by BeginCheckpoint() at a throttled rate, then truncate the log up to the
+   * oldest LSN recovery may still need.
+   */
   void EndCheckpoint();
 
  private:
-  TransactionManager *transaction_manager_ __attribute__((__unused__));
-  LogManager *log_manager_ __attribute__((__unused__));
-  BufferPoolManager *buffer_pool_manager_ __attribute__((__unused__));
+  TransactionManager *transaction_manager_;
+  LogManager *log_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+
+  /** LSN of the BEGIN_CHECKPOINT record of the running checkpoint. */
+  lsn_t begin_checkpoint_lsn_{INVALID_LSN};
+  /** Dirty page table captured by BeginCheckpoint(), written back by EndCheckpoint(). */
+  std::vector<std::pair<page_id_t, lsn_t>> dirty_page_table_;
 };
 
 }  // namespace bustub
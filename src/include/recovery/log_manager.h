@@ -35,6 +35,7 @@ class LogManager {
   }
 
   ~LogManager() {
+    StopFlushThread();
     delete[] log_buffer_;
     delete[] flush_buffer_;
     log_buffer_ = nullptr;
@@ -46,29 +47,66 @@ class LogManager {
 
   auto AppendLogRecord(LogRecord *log_record) -> lsn_t;
 
+  /** Force the log buffer to disk and wait until every record appended so far is persistent. */
+  void Flush();
+
+  /**
+   * Wait until the log record with the given lsn is persistent. Concurrent waiters are served by the same flush, so
+   * committing transactions share one disk write (group commit).
+   * @param lsn the lsn to wait for
+   */
+  void WaitForFlush(lsn_t lsn);
+
   inline auto GetNextLSN() -> lsn_t { return next_lsn_; }
   inline auto GetPersistentLSN() -> lsn_t { return persistent_lsn_; }
   inline void SetPersistentLSN(lsn_t lsn) { persistent_lsn_ = lsn; }
   inline auto GetLogBuffer() -> char * { return log_buffer_; }
 
+  /**
+   * Mark every log record with an LSN below `lsn` as no longer needed by recovery. Called at the end of a checkpoint
+   * with the minimum recLSN of the dirty pages and the oldest LSN of the active transactions.
+   */
+  inline void TruncateLog(lsn_t lsn) {
+    lsn_t truncated_lsn = truncated_lsn_;
+    while (lsn > truncated_lsn && !truncated_lsn_.compare_exchange_weak(truncated_lsn, lsn)) {
+    }
+  }
+  inline auto GetTruncatedLSN() -> lsn_t { return truncated_lsn_; }
+
  private:
-  // TODO(students): you may add your own member variables
+  /**
+   * Swap the log buffer with the flush buffer and write the latter to disk.
+   * @param lock the held latch_, released during the disk write if this is the flush thread
+   */
+  void SwapAndFlush(std::unique_lock<std::mutex> *lock);
 
   /** The atomic counter which records the next log sequence number. */
   std::atomic<lsn_t> next_lsn_;
   /** The log records before and including the persistent lsn have been written to disk. */
   std::atomic<lsn_t> persistent_lsn_;
+  /** The log records before the truncated lsn are no longer needed for recovery and may be discarded. */
+  std::atomic<lsn_t> truncated_lsn_{INVALID_LSN};
 
   char *log_buffer_;
   char *flush_buffer_;
-
+  /** Bytes used in the log buffer. */
+  int log_buffer_offset_{0};
+  /** LSN of the last record in the log buffer. */
+  lsn_t log_buffer_lsn_{INVALID_LSN};
+  /** True if someone is waiting for the log buffer to be flushed. */
+  bool flush_requested_{false};
+
+  /** Protects the log buffer, its offset and lsn, and the flush request. */
   std::mutex latch_;
 
-  std::thread *flush_thread_ __attribute__((__unused__));
+  std::thread *flush_thread_{nullptr};
 
+  /** Wakes up the flush thread. */
   std::condition_variable cv_;
+  /** Notified whenever a flush completes. */
+  std::condition_variable flushed_cv_;
 
-  DiskManager *disk_manager_ __attribute__((__unused__));
+  DiskManager *disk_manager_;
 };
 
 }  // namespace bustub
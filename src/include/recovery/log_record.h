@@ -14,6 +14,8 @@
 
 #include <cassert>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "storage/table/tuple.h"
@@ -32,31 +34,45 @@ enum class LogRecordType {
   ABORT,
   /** Creating a new page in the table heap. */
   NEWPAGE,
+  /** Start of a fuzzy checkpoint. */
+  BEGIN_CHECKPOINT,
+  /** End of a fuzzy checkpoint, carrying the active transaction table and the dirty page table. */
+  END_CHECKPOINT,
 };
 
 /**
  * For every write operation on the table page, you should write ahead a corresponding log record.
  *
- * For EACH log record, HEADER is like (5 fields in common, 20 bytes in total).
- *---------------------------------------------
- * | size | LSN | transID | prevLSN | LogType |
- *---------------------------------------------
+ * Log records are serialized in a compact format: every integer is a LEB128 varint, and signed fields that may be
+ * INVALID (txn ids, page ids, lsns) are zigzag encoded first, so small values take a single byte.
+ *
+ * For EACH log record, HEADER is like (5 fields in common, 5 to 16 bytes in total).
+ *------------------------------------------------------
+ * | size | LSN | transID | LSN - prevLSN | LogType (1) |
+ *------------------------------------------------------
+ * `size` is the length of the rest of the record. `LSN - prevLSN` is 0 if there is no prevLSN.
+ *
  * For insert type log record
- *---------------------------------------------------------------
- * | HEADER | tuple_rid | tuple_size | tuple_data(char[] array) |
- *---------------------------------------------------------------
+ *------------------------------------------------------------------------
+ * | HEADER | page_id | slot_num | tuple_size | tuple_data(char[] array) |
+ *------------------------------------------------------------------------
  * For delete type (including markdelete, rollbackdelete, applydelete)
- *----------------------------------------------------------------
- * | HEADER | tuple_rid | tuple_size | tuple_data(char[] array) |
- *---------------------------------------------------------------
- * For update type log record
- *-----------------------------------------------------------------------------------
- * | HEADER | tuple_rid | tuple_size | old_tuple_data | tuple_size | new_tuple_data |
- *-----------------------------------------------------------------------------------
+ *------------------------------------------------------------------------
+ * | HEADER | page_id | slot_num | tuple_size | tuple_data(char[] array) |
+ *------------------------------------------------------------------------
+ * For update type log record, only the byte range that differs between the old and the new tuple is logged. The
+ * record is physiological: redo and undo apply the delta to the tuple currently stored at the rid.
+ *---------------------------------------------------------------------------------------------------------
+ * | HEADER | page_id | slot_num | offset | old_size | old_bytes(char[] array) | new_size | new_bytes(...) |
+ *---------------------------------------------------------------------------------------------------------
  * For new page type log record
- *--------------------------
- * | HEADER | prev_page_id |
- *--------------------------
+ *------------------------------------
+ * | HEADER | prev_page_id | page_id |
+ *------------------------------------
+ * For end checkpoint type log record (begin checkpoint is HEADER only)
+ *-----------------------------------------------------------------------------------------
+ * | HEADER | num_txns | (txn_id, last_lsn) ... | num_dirty_pages | (page_id, rec_lsn) ... |
+ *-----------------------------------------------------------------------------------------
  */
 class LogRecord {
   friend class LogManager;
@@ -67,7 +83,7 @@ class LogRecord {
 
   // constructor for Transaction type(BEGIN/COMMIT/ABORT)
   LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type)
-      : size_(HEADER_SIZE), txn_id_(txn_id), prev_lsn_(prev_lsn), log_record_type_(log_record_type) {}
+      : txn_id_(txn_id), prev_lsn_(prev_lsn), log_record_type_(log_record_type) {}
 
   // constructor for INSERT/DELETE type
   LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, const RID &rid, const Tuple &tuple)
@@ -81,8 +97,6 @@ class LogRecord {
       delete_rid_ = rid;
       delete_tuple_ = tuple;
     }
-    // calculate log record size
-    size_ = HEADER_SIZE + sizeof(RID) + sizeof(int32_t) + tuple.GetLength();
   }
 
   // constructor for UPDATE type
@@ -93,21 +107,29 @@ class LogRecord {
         log_record_type_(log_record_type),
         update_rid_(update_rid),
         old_tuple_(old_tuple),
-        new_tuple_(new_tuple) {
-    // calculate log record size
-    size_ = HEADER_SIZE + sizeof(RID) + old_tuple.GetLength() + new_tuple.GetLength() + 2 * sizeof(int32_t);
+        new_tuple_(new_tuple),
+        has_update_images_(true) {
+    ComputeUpdateDelta();
   }
 
   // constructor for NEWPAGE type
   LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, page_id_t prev_page_id, page_id_t page_id)
-      : size_(HEADER_SIZE),
-        txn_id_(txn_id),
+      : txn_id_(txn_id),
         prev_lsn_(prev_lsn),
         log_record_type_(log_record_type),
         prev_page_id_(prev_page_id),
-        page_id_(page_id) {
-    // calculate log record size, header size + sizeof(prev_page_id) + sizeof(page_id)
-    size_ = HEADER_SIZE + sizeof(page_id_t) * 2;
+        page_id_(page_id) {}
+
+  // constructor for END_CHECKPOINT type
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type,
+            std::vector<std::pair<txn_id_t, lsn_t>> active_txn_table,
+            std::vector<std::pair<page_id_t, lsn_t>> dirty_page_table)
+      : txn_id_(txn_id),
+        prev_lsn_(prev_lsn),
+        log_record_type_(log_record_type),
+        active_txn_table_(std::move(active_txn_table)),
+        dirty_page_table_(std::move(dirty_page_table)) {
+    assert(log_record_type == LogRecordType::END_CHECKPOINT);
   }
 
   ~LogRecord() = default;
@@ -120,14 +142,30 @@ class LogRecord {
 
   inline auto GetInsertRID() -> RID & { return insert_rid_; }
 
-  inline auto GetOriginalTuple() -> Tuple & { return old_tuple_; }
+  /**
+   * @return the old tuple of an UPDATE record built in memory. A deserialized UPDATE record only carries the delta,
+   * rebuild the tuple with ApplyUpdate() instead.
+   */
+  inline auto GetOriginalTuple() -> Tuple & {
+    assert(has_update_images_ && "Deserialized UPDATE records only carry the delta");
+    return old_tuple_;
+  }
 
-  inline auto GetUpdateTuple() -> Tuple & { return new_tuple_; }
+  /** @return the new tuple of an UPDATE record built in memory, see GetOriginalTuple() */
+  inline auto GetUpdateTuple() -> Tuple & {
+    assert(has_update_images_ && "Deserialized UPDATE records only carry the delta");
+    return new_tuple_;
+  }
 
   inline auto GetUpdateRID() -> RID & { return update_rid_; }
 
   inline auto GetNewPageRecord() -> page_id_t { return prev_page_id_; }
 
+  inline auto GetActiveTxnTable() -> std::vector<std::pair<txn_id_t, lsn_t>> & { return active_txn_table_; }
+
+  inline auto GetDirtyPageTable() -> std::vector<std::pair<page_id_t, lsn_t>> & { return dirty_page_table_; }
+
+  /** @return the serialized size of the record, valid once it has been serialized or deserialized */
   inline auto GetSize() -> int32_t { return size_; }
 
   inline auto GetLSN() -> lsn_t { return lsn_; }
@@ -138,6 +176,32 @@ class LogRecord {
 
   inline auto GetLogRecordType() -> LogRecordType & { return log_record_type_; }
 
+  /** @return the number of bytes SerializeTo() will write, given the current lsn of the record */
+  auto GetSerializedSize() const -> int32_t;
+
+  /**
+   * Serialize the record into storage, which must have room for GetSerializedSize() bytes.
+   * @return the number of bytes written
+   */
+  auto SerializeTo(char *storage) -> int32_t;
+
+  /**
+   * Deserialize a record from storage. UPDATE records only carry the delta afterwards, use ApplyUpdate() to rebuild
+   * the old or new tuple from the tuple stored at the rid.
+   * @param storage the start of the record
+   * @param available the number of readable bytes at storage
+   * @return false if storage does not hold a complete record
+   */
+  auto DeserializeFrom(const char *storage, int32_t available) -> bool;
+
+  /**
+   * Apply the delta of an UPDATE record to a tuple.
+   * @param tuple the old tuple when redoing, the new tuple when undoing
+   * @param redo true to produce the new tuple, false to produce the old tuple
+   * @return the resulting tuple
+   */
+  auto ApplyUpdate(const Tuple &tuple, bool redo) const -> Tuple;
+
   // For debug purpose
   inline auto ToString() const -> std::string {
     std::ostringstream os;
@@ -168,15 +232,33 @@ class LogRecord {
   RID insert_rid_;
   Tuple insert_tuple_;
 
-  // case3: for update operation
+  // case3: for update operation, only the delta is serialized: the tuples share their first update_offset_ bytes
+  // and their last (size - update_offset_ - delta size) bytes
   RID update_rid_;
   Tuple old_tuple_;
   Tuple new_tuple_;
+  /** Whether old_tuple_ and new_tuple_ are set, i.e. the record was not deserialized. */
+  bool has_update_images_{false};
+  uint32_t update_offset_{0};
+  std::vector<char> old_delta_;
+  std::vector<char> new_delta_;
 
   // case4: for new page operation
   page_id_t prev_page_id_{INVALID_PAGE_ID};
   page_id_t page_id_{INVALID_PAGE_ID};
-  static const int HEADER_SIZE = 20;
+
+  // case5: for end checkpoint operation
+  std::vector<std::pair<txn_id_t, lsn_t>> active_txn_table_;
+  std::vector<std::pair<page_id_t, lsn_t>> dirty_page_table_;
+
+  /** Compute the delta between old_tuple_ and new_tuple_. */
+  void ComputeUpdateDelta();
+
+  /**
+   * Encode everything after the size field into storage, or only measure it if storage is nullptr.
+   * @return the size of the encoded body
+   */
+  auto EncodeBody(char *storage) const -> int32_t;
 };  // namespace bustub
 
 }  // namespace bustub
@@ -91,6 +91,10 @@ class Page {
   int pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
   bool is_dirty_ = false;
+  /** Lower bound on the LSN of the first change since the page was last clean, i.e. its recLSN once dirty. */
+  lsn_t rec_lsn_ = INVALID_LSN;
+  /** Upper bound on the LSN of the last change to the page: the last LSN handed out when it was unpinned dirty. */
+  lsn_t page_lsn_ = INVALID_LSN;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
 };
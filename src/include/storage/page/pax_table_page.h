@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_table_page.h
+//
+// Identification: src/include/storage/page/pax_table_page.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+static constexpr uint64_t PAX_TABLE_PAGE_HEADER_SIZE = 12;
+/** The average VARCHAR size, in bytes, the capacity of a PAX page is computed for. */
+static constexpr uint32_t PAX_EXPECTED_VARLEN_SIZE = 32;
+
+/**
+ * PAX (Partition Attributes Across) page format, used by tables created with `WITH (storage = pax)`. The tuples of a
+ * page are split by column, so that a scan reading a few columns of a wide table only touches their minipages.
+ *  ------------------------------------------------------------------------------------------------
+ *  | HEADER | TUPLE METAS | MINIPAGE OFFSETS | MINIPAGE 1 | ... | MINIPAGE N | FREE | VARLEN DATA |
+ *  ------------------------------------------------------------------------------------------------
+ *                                                                                   ^
+ *                                                                                   varlen start
+ *
+ *  Header format (size in bytes), the first 8 bytes are the same as in TablePage so TableIterator can walk both:
+ *  ----------------------------------------------------------------------------------------
+ *  | NextPageId (4) | NumTuples (2) | NumDeletedTuples (2) | Capacity (2) | VarlenStart (2) |
+ *  ----------------------------------------------------------------------------------------
+ *
+ * The number of slots (capacity) is fixed when the page is initialized. A minipage holds a null bitmap of capacity
+ * bits followed by capacity values of the column. Fixed-size values are stored inline; a VARCHAR minipage stores the
+ * 2-byte offset of each value, whose (length, data) lives in the varlen area growing down from the end of the page.
+ */
+class PaxTablePage {
+ public:
+  /**
+   * Initialize the PaxTablePage header and lay out the minipages for the given schema.
+   */
+  void Init(const Schema &schema);
+
+  /** @return number of tuples in this page */
+  auto GetNumTuples() const -> uint32_t { return num_tuples_; }
+
+  /** @return the page ID of the next table page */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  /** Set the page id of the next page in the table. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /**
+   * Insert a tuple into the page.
+   * @param schema the schema the page was initialized with
+   * @param tuple tuple to insert, in the row format
+   * @return the slot of the tuple, or nullopt if all slots are used or the varlen area is full
+   */
+  auto InsertTuple(const Schema &schema, const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t>;
+
+  /**
+   * Update a tuple meta. The version in meta is ignored, the version of the tuple is bumped instead.
+   */
+  void UpdateTupleMeta(const TupleMeta &meta, const RID &rid);
+
+  /**
+   * Read a tuple meta from the page.
+   */
+  auto GetTupleMeta(const RID &rid) const -> TupleMeta;
+
+  /**
+   * Read a whole tuple from the page, converted back to the row format.
+   */
+  auto GetTuple(const Schema &schema, const RID &rid) const -> std::pair<TupleMeta, Tuple>;
+
+  /**
+   * Read some columns of a tuple, only touching their minipages.
+   * @param column_ids the columns to read, in the order they are returned
+   */
+  auto GetValues(const Schema &schema, const RID &rid, const std::vector<uint32_t> &column_ids) const
+      -> std::pair<TupleMeta, std::vector<Value>>;
+
+  /**
+   * @return the number of slots of a page of this schema. VARCHAR columns are assumed to hold short values (see
+   * PAX_EXPECTED_VARLEN_SIZE); pages of longer values fill their varlen area before running out of slots.
+   */
+  static auto ComputeCapacity(const Schema &schema) -> uint16_t;
+
+  static_assert(sizeof(page_id_t) == 4);
+
+ private:
+  /** @return the size of a value in the minipage of this column */
+  static auto SlotWidth(const Column &column) -> uint32_t;
+
+  /**
+   * Lay out the minipages of a page with the given capacity.
+   * @param[out] minipage_offsets the offset of every minipage, may be nullptr
+   * @return the offset of the first byte after the minipages
+   */
+  static auto LayOut(const Schema &schema, uint32_t capacity, uint16_t *minipage_offsets) -> uint32_t;
+
+  /** @return the offsets of the minipages, stored after the tuple metas */
+  auto MinipageOffsets() const -> const uint16_t * {
+    return reinterpret_cast<const uint16_t *>(page_start_ + PAX_TABLE_PAGE_HEADER_SIZE + TUPLE_META_SIZE * capacity_);
+  }
+  auto MinipageOffsets() -> uint16_t * {
+    return reinterpret_cast<uint16_t *>(page_start_ + PAX_TABLE_PAGE_HEADER_SIZE + TUPLE_META_SIZE * capacity_);
+  }
+
+  /** @return the slot of rid, throws if there is no such tuple in this page */
+  auto CheckSlot(const RID &rid) const -> uint16_t;
+
+  auto GetValue(const Schema &schema, uint32_t column_idx, uint16_t slot) const -> Value;
+
+  char page_start_[0];
+  page_id_t next_page_id_;
+  uint16_t num_tuples_;
+  uint16_t num_deleted_tuples_;
+  uint16_t capacity_;
+  uint16_t varlen_start_;
+  TupleMeta tuple_metas_[0];
+};
+
+static_assert(sizeof(PaxTablePage) == PAX_TABLE_PAGE_HEADER_SIZE);
+
+}  // namespace bustub
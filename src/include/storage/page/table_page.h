@@ -27,7 +27,7 @@
 
 namespace bustub {
 
-static constexpr uint64_t TABLE_PAGE_HEADER_SIZE = 8;
+static constexpr uint64_t TABLE_PAGE_HEADER_SIZE = 12;
 
 /**
  * Slotted page format:
@@ -38,15 +38,21 @@ static constexpr uint64_t TABLE_PAGE_HEADER_SIZE = 8;
  *                                free space pointer
  *
  *  Header format (size in bytes):
- *  ----------------------------------------------------------------------------
- *  | NextPageId (4)| NumTuples(2) | NumDeletedTuples(2) |
- *  ----------------------------------------------------------------------------
+ *  ------------------------------------------------------------------------------------------------
+ *  | NextPageId (4)| NumTuples(2) | NumDeletedTuples(2) | FreeSpacePointer (2) | FragmentedBytes (2) |
+ *  ------------------------------------------------------------------------------------------------
  *  ----------------------------------------------------------------
  *  | Tuple_1 offset+size (4) | Tuple_2 offset+size (4) | ... |
  *  ----------------------------------------------------------------
  *
  * Tuple format:
  * | meta | data |
+ *
+ * Tuples are addressed by their slot, so the data of a tuple can move within the page without changing its RID.
+ * Updates that shrink a tuple or move it leave holes below the free space pointer, counted in FragmentedBytes. The
+ * data of deleted tuples whose deletion is committed (delete txn id back to INVALID_TXN_ID) can be reclaimed too.
+ * When a tuple does not fit in the free space, the page is compacted: reclaimable slots are emptied (their size set
+ * to 0, their meta kept) and the remaining data is packed against the end of the page.
  */
 
 class TablePage {
@@ -65,18 +71,33 @@ class TablePage {
   /** Set the page id of the next page in the table. */
   void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
-  /** Get the next offset to insert, return nullopt if this tuple cannot fit in this page */
+  /** @return the contiguous free space between the slot array and the tuple data */
+  auto GetFreeSpace() const -> uint32_t {
+    return free_space_pointer_ - TABLE_PAGE_HEADER_SIZE - TUPLE_INFO_SIZE * num_tuples_;
+  }
+
+  /** @return the space a compaction would add to the free space */
+  auto GetReclaimableSpace() const -> uint32_t;
+
+  /**
+   * Reclaim the space of fragments and committed deletes, and pack the data of the remaining tuples against the end
+   * of the page. Slots, and thus RIDs, do not change.
+   */
+  void Compact();
+
+  /** Get the next offset to insert without compacting the page, return nullopt if this tuple cannot fit in it */
   auto GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t>;
 
   /**
    * Insert a tuple into the table.
    * @param tuple tuple to insert
-   * @return true if the insert is successful (i.e. there is enough space)
+   * The page is compacted first if that makes room for the tuple.
+   * @return the slot of the tuple, or nullopt if there is not enough space even after compaction
    */
   auto InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t>;
 
   /**
-   * Update a tuple.
+   * Update a tuple. The version in meta is ignored, the version of the tuple is bumped instead.
    */
   void UpdateTupleMeta(const TupleMeta &meta, const RID &rid);
 
@@ -85,27 +106,52 @@ class TablePage {
    */
   auto GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Locate a tuple without copying it.
+   * @return the meta, the address and the size of the tuple, valid as long as the page is latched
+   */
+  auto GetTupleData(const RID &rid) const -> std::tuple<TupleMeta, const char *, uint32_t>;
+
   /**
    * Read a tuple meta from a table.
    */
   auto GetTupleMeta(const RID &rid) const -> TupleMeta;
 
   /**
-   * Update a tuple in place.
+   * Update a tuple in place. The version in meta is ignored, the version of the tuple is bumped instead.
    */
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
+  /**
+   * Update a tuple and its meta on this page, keeping its slot. The new tuple may be smaller or larger than the old
+   * one; a larger tuple is moved to the free space, compacting the page if needed. The version in meta is ignored,
+   * the version of the tuple is bumped instead.
+   * @return false if the page has no room for the new tuple, in which case nothing is changed
+   */
+  auto UpdateTuple(const TupleMeta &meta, const Tuple &tuple, const RID &rid) -> bool;
+
   static_assert(sizeof(page_id_t) == 4);
 
  private:
+  /** @return whether the data of a tuple with this meta is no longer needed, i.e. its delete has been committed */
+  static auto IsReclaimable(const TupleMeta &meta) -> bool { return meta.is_deleted_ && meta.delete_committed_; }
+
+  /** @return the slot of rid, throws if there is no such tuple in this page */
+  auto CheckSlot(const RID &rid) const -> uint16_t;
+
+  /** Bump the version of a tuple and count it if it gets deleted. */
+  void SetTupleMeta(uint16_t tuple_id, const TupleMeta &meta);
+
   using TupleInfo = std::tuple<uint16_t, uint16_t, TupleMeta>;
   char page_start_[0];
   page_id_t next_page_id_;
   uint16_t num_tuples_;
   uint16_t num_deleted_tuples_;
+  uint16_t free_space_pointer_;
+  uint16_t fragmented_bytes_;
   TupleInfo tuple_info_[0];
 
-  static constexpr size_t TUPLE_INFO_SIZE = 16;
+  static constexpr size_t TUPLE_INFO_SIZE = 20;
   static_assert(sizeof(TupleInfo) == TUPLE_INFO_SIZE);
 };
 
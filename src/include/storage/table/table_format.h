@@ -0,0 +1,25 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_format.h
+//
+// Identification: src/include/storage/table/table_format.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+namespace bustub {
+
+/** The page layout of a table heap, chosen with `CREATE TABLE ... WITH (storage = row | pax)`. */
+enum class TableFormat {
+  /** Slotted pages of row-major tuples, see TablePage. */
+  ROW,
+  /** Pages of column minipages, see PaxTablePage. */
+  PAX,
+};
+
+}  // namespace bustub
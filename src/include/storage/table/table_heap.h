@@ -12,9 +12,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>  // NOLINT
 #include <optional>
+#include <shared_mutex>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
@@ -22,11 +26,16 @@
 #include "concurrency/transaction.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
+#include "storage/table/table_format.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_view.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
+class AbstractExpression;
+
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
@@ -44,6 +53,15 @@ class TableHeap {
    */
   explicit TableHeap(BufferPoolManager *bpm);
 
+  /**
+   * Create a table heap of the given page format. PAX pages are laid out for the schema of the table, so it must be
+   * known to the heap. A heap created with its schema also keeps a zone map of every page.
+   * @param bpm the buffer pool manager
+   * @param schema the schema of the table
+   * @param format the page format
+   */
+  TableHeap(BufferPoolManager *bpm, const Schema &schema, TableFormat format);
+
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return std::nullopt.
    * @param meta tuple meta
@@ -67,6 +85,14 @@ class TableHeap {
    */
   auto GetTuple(RID rid) -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Read a tuple in place, without copying it out of its page. The page stays latched until the view is dropped.
+   * Only row-format tables support views.
+   * @param rid rid of the tuple to read
+   * @return a view of the meta and tuple
+   */
+  auto GetTupleView(RID rid) -> TupleView;
+
   /**
    * Read a tuple meta from the table. Note: if you want to get tuple and meta together, use `GetTuple` insead
    * to ensure atomicity.
@@ -75,29 +101,91 @@ class TableHeap {
    */
   auto GetTupleMeta(RID rid) -> TupleMeta;
 
-  /** @return the iterator of this table, use this for project 3 */
-  auto MakeIterator() -> TableIterator;
+  /**
+   * Read some columns of a tuple. On a PAX table, only the minipages of these columns are read. The heap must have
+   * been created with its schema.
+   * @param rid rid of the tuple to read
+   * @param column_ids the columns to read, in the order they are returned
+   * @return the meta and the values of the columns
+   */
+  auto GetValues(RID rid, const std::vector<uint32_t> &column_ids) -> std::pair<TupleMeta, std::vector<Value>>;
+
+  /**
+   * @return the number of tuples not marked deleted, maintained on every insert and meta update. It includes the
+   * writes of transactions still running.
+   */
+  inline auto GetRowCount() const -> size_t { return row_count_; }
+
+  /** @return the page format of this table */
+  inline auto GetFormat() const -> TableFormat { return format_; }
+
+  /**
+   * @param filter if not null, the iterator skips the pages whose zone map rules out this predicate without fetching
+   * them; it must outlive the iterator. The tuples of the other pages are all returned, filter them as usual.
+   * @return the iterator of this table, use this for project 3
+   */
+  auto MakeIterator(const AbstractExpression *filter = nullptr) -> TableIterator;
 
   /** @return the iterator of this table, use this for project 4 except updates */
-  auto MakeEagerIterator() -> TableIterator;
+  auto MakeEagerIterator(const AbstractExpression *filter = nullptr) -> TableIterator;
+
+  /**
+   * Find the first page, starting at page_id and following the page chain, whose zone map may match the filter.
+   * @param stop_page_id the last page to consider, INVALID_PAGE_ID to consider all the pages up to the end
+   * @return that page, or INVALID_PAGE_ID if all the pages up to stop_page_id are ruled out
+   */
+  auto SkipPages(page_id_t page_id, const AbstractExpression &filter, page_id_t stop_page_id) -> page_id_t;
+
+  /** @return a copy of the zone map of a page, nullopt if the heap keeps none */
+  auto GetZoneMap(page_id_t page_id) -> std::optional<ZoneMap>;
 
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
   /**
-   * Update a tuple in place. SHOULD NOT BE USED UNLESS YOU WANT TO OPTIMIZE FOR PROJECT 4.
+   * Update a tuple in place. SHOULD NOT BE USED UNLESS YOU WANT TO OPTIMIZE FOR PROJECT 4. Not supported on PAX tables.
    * @param meta new tuple meta
    * @param tuple  new tuple
    * @param[out] rid the rid of the tuple to be updated
    */
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
+  /**
+   * Update a tuple on its page, keeping its RID. Unlike UpdateTupleInPlaceUnsafe, the new tuple may have a different
+   * size; the page is compacted if that makes room for it. Not supported on PAX tables.
+   * @return false if the page of the tuple has no room for the new tuple. Nothing is changed then, delete the tuple
+   * and insert the new one instead.
+   */
+  auto UpdateTuple(const TupleMeta &meta, const Tuple &tuple, RID rid) -> bool;
+
  private:
   BufferPoolManager *bpm_;
   page_id_t first_page_id_{INVALID_PAGE_ID};
+  TableFormat format_{TableFormat::ROW};
+  /** The schema of the table, unknown to heaps created without one */
+  std::optional<Schema> schema_;
 
   std::mutex latch_;
   page_id_t last_page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
+
+  std::atomic<size_t> row_count_{0};
+
+  /** Counts a tuple in or out of the row count when its deleted mark changes. */
+  void UpdateRowCount(const TupleMeta &old_meta, const TupleMeta &new_meta);
+
+  /** Appends the zone map of a new last page, if the heap keeps zone maps. */
+  void AddZoneMap(page_id_t page_id);
+
+  /** Widens the zone map of a page with a tuple written to it. Call it before the page is unlatched. */
+  void UpdateZoneMap(page_id_t page_id, const Tuple &tuple);
+
+  /**
+   * The zone maps of the pages in page chain order, and the index of every page in it. They are kept in memory only,
+   * for heaps created with a schema.
+   */
+  std::shared_mutex zone_map_latch_;
+  std::vector<std::pair<page_id_t, ZoneMap>> zone_maps_;
+  std::unordered_map<page_id_t, size_t> zone_map_index_;
 };
 
 }  // namespace bustub
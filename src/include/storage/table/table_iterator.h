@@ -15,14 +15,17 @@
 #include <cassert>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "common/macros.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_view.h"
 
 namespace bustub {
 
+class AbstractExpression;
 class TableHeap;
 
 /**
@@ -34,13 +37,24 @@ class TableIterator {
  public:
   DISALLOW_COPY(TableIterator);
 
-  TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid);
+  TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid, const AbstractExpression *filter = nullptr);
   TableIterator(TableIterator &&) = default;
 
   ~TableIterator() = default;
 
   auto GetTuple() -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Read the current tuple in place. Drop the view before advancing the iterator if other threads may write the page.
+   */
+  auto GetTupleView() -> TupleView;
+
+  /**
+   * Read only some columns of the current tuple, which on a PAX table only touches the minipages of these columns.
+   * @param column_ids the columns to read, in the order they are returned
+   */
+  auto GetValues(const std::vector<uint32_t> &column_ids) -> std::pair<TupleMeta, std::vector<Value>>;
+
   auto GetRID() -> RID;
 
   auto IsEnd() -> bool;
@@ -55,6 +69,9 @@ class TableIterator {
   // Otherwise we will have dead loops when updating while scanning. (In project 4, update should be implemented as
   // deletion + insertion.)
   RID stop_at_rid_;
+
+  // If set, the pages whose zone map rules out this predicate are skipped.
+  const AbstractExpression *filter_;
 };
 
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -21,16 +22,17 @@
 
 namespace bustub {
 
-static constexpr size_t TUPLE_META_SIZE = 12;
+static constexpr size_t TUPLE_META_SIZE = 16;
 
 struct TupleMeta {
   /**
-   * @brief txn id that inserts this tuple. INVALID_TXN if the insertion is completed.
+   * @brief txn id that inserts this tuple. INVALID_TXN if the insertion is completed, TransactionManager::Commit clears
+   * it for the tuples in the write set of every transaction.
    * No need to use it in project 3 (as of Spring 2023).
    */
   txn_id_t insert_txn_id_;
   /**
-   * @brief txn id that deletes this tuple. INVALID_TXN if the deletion is completed.
+   * @brief txn id that deletes this tuple. INVALID_TXN if the deletion is completed, see insert_txn_id_.
    * No need to use it in project 3 (as of Spring 2023).
    */
   txn_id_t delete_txn_id_;
@@ -38,20 +40,37 @@ struct TupleMeta {
    * @brief marks whether this tuple is marked removed from table heap.
    */
   bool is_deleted_;
+  /**
+   * @brief set by TransactionManager::Commit on the tuples a transaction deleted. Until then the delete may still be
+   * rolled back, so the table page must keep the tuple data even though is_deleted_ is set.
+   */
+  bool delete_committed_{false};
+  /**
+   * @brief bumped by the table page on every change to the tuple or its meta. Optimistic readers record it and
+   * validate it at commit. It is 32 bits wide so that it cannot wrap around to the version a reader saw (ABA) within
+   * the lifetime of a transaction.
+   */
+  uint32_t version_{0};
 };
 
 static_assert(sizeof(TupleMeta) == TUPLE_META_SIZE);
 
 /**
  * Tuple format:
- * ---------------------------------------------------------------------
- * | FIXED-SIZE or VARIED-SIZED OFFSET | PAYLOAD OF VARIED-SIZED FIELD |
- * ---------------------------------------------------------------------
+ * ---------------------------------------------------------------------------------
+ * | FIXED-SIZE or VARIED-SIZED SLOT | NULL BITMAP | PAYLOAD OF VARIED-SIZED FIELD |
+ * ---------------------------------------------------------------------------------
+ * Every column is at its schema offset. A varied-sized slot holds the uint16 offset of the data within the tuple and
+ * its uint16 length, so a tuple is at most 64 KB. The null bitmap has one bit per column. Null varchars have no data;
+ * null fixed-size values still hold the null sentinel of their type.
  */
 class Tuple {
   friend class TablePage;
+  friend class PaxTablePage;
   friend class TableHeap;
   friend class TableIterator;
+  friend class LogRecord;
+  friend class TupleView;
 
  public:
   // Default constructor (to create a dummy tuple)
@@ -93,21 +112,36 @@ class Tuple {
   // checks the schema to see how to return the Value.
   auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
 
+  // Get a fixed-size column as T without constructing a Value. The column must not be null, T must match its type.
+  template <class T>
+  inline auto GetAs(const Schema *schema, uint32_t column_idx) const -> T {
+    T value;
+    memcpy(&value, data_.data() + schema->GetColumn(column_idx).GetOffset(), sizeof(T));
+    return value;
+  }
+
   // Generates a key tuple given schemas and attributes
   auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) -> Tuple;
 
   // Is the column value null ?
   inline auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool {
-    Value value = GetValue(schema, column_idx);
-    return value.IsNull();
+    return IsNullAt(data_.data(), schema, column_idx);
   }
 
+  // Read the null bit of a column from tuple data
+  static inline auto IsNullAt(const char *data, const Schema *schema, uint32_t column_idx) -> bool {
+    return ((static_cast<uint8_t>(data[schema->GetLength() + column_idx / 8]) >> (column_idx % 8)) & 1) != 0;
+  }
+
+  // Read a column from tuple data, ignoring the null bitmap, which may be missing (e.g. in a truncated index key).
+  static auto ValueAt(const char *data, const Schema *schema, uint32_t column_idx) -> Value;
+
+  // Size of the null bitmap of a tuple
+  static inline auto NullBitmapSize(uint32_t column_count) -> uint32_t { return (column_count + 7) / 8; }
+
   auto ToString(const Schema *schema) const -> std::string;
 
  private:
-  // Get the starting storage address of specific column
-  auto GetDataPtr(const Schema *schema, uint32_t column_idx) const -> const char *;
-
   RID rid_{};  // if pointing to the table heap, the rid is valid
   std::vector<char> data_;
 };
@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_view.h
+//
+// Identification: src/include/storage/table/tuple_view.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <utility>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/page/page_guard.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleView is a non-owning tuple that reads its columns in place on a table page. The view holds a read guard on the
+ * page, so the page stays pinned and latched as long as the view lives. Executors evaluate predicates against a view
+ * (AbstractExpression::EvaluateView) and only call ToTuple() on the rows that survive, which saves an allocation and
+ * a copy for every rejected row.
+ *
+ * A view must not outlive the pass over the current row: keeping it around blocks writers of the page.
+ */
+class TupleView {
+ public:
+  TupleView() = default;
+
+  TupleView(ReadPageGuard guard, const TupleMeta &meta, const char *data, uint32_t size, RID rid)
+      : guard_(std::move(guard)), meta_(meta), data_(data), size_(size), rid_(rid) {}
+
+  TupleView(const TupleView &) = delete;
+  auto operator=(const TupleView &) -> TupleView & = delete;
+  TupleView(TupleView &&) noexcept = default;
+  auto operator=(TupleView &&) noexcept -> TupleView & = default;
+
+  inline auto GetMeta() const -> const TupleMeta & { return meta_; }
+
+  inline auto GetRid() const -> RID { return rid_; }
+
+  // Get the address of the tuple on the page
+  inline auto GetData() const -> const char * { return data_; }
+
+  inline auto GetLength() const -> uint32_t { return size_; }
+
+  // Get the value of a specified column
+  auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
+
+  // Get a fixed-size column as T without constructing a Value. The column must not be null, T must match its type.
+  template <class T>
+  inline auto GetAs(const Schema *schema, uint32_t column_idx) const -> T {
+    T value;
+    memcpy(&value, data_ + schema->GetColumn(column_idx).GetOffset(), sizeof(T));
+    return value;
+  }
+
+  inline auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool {
+    return Tuple::IsNullAt(data_, schema, column_idx);
+  }
+
+  // Copy the tuple out of the page
+  auto ToTuple() const -> Tuple;
+
+  // Release the page early. The view must not be read afterwards.
+  void Drop() { guard_.Drop(); }
+
+ private:
+  ReadPageGuard guard_;
+  TupleMeta meta_{};
+  const char *data_{nullptr};
+  uint32_t size_{0};
+  RID rid_{};
+};
+
+}  // namespace bustub
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.h
+//
+// Identification: src/include/storage/table/zone_map.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+class AbstractExpression;
+
+/** The summary of one column over the tuples of a page. */
+struct ColumnZone {
+  /** The smallest non-null value, nullopt if there is none */
+  std::optional<Value> min_;
+  /** The largest non-null value, nullopt if there is none */
+  std::optional<Value> max_;
+  /** The number of null values */
+  uint32_t null_count_{0};
+};
+
+/**
+ * ZoneMap keeps the min/max and null count of every column over the tuples of a table page, so that scans can skip
+ * pages whose summary rules out their filter. The zones only ever widen: deletes and the old images of updated tuples
+ * are not removed, which keeps the summary conservative.
+ */
+class ZoneMap {
+ public:
+  explicit ZoneMap(uint32_t num_columns) : columns_(num_columns) {}
+
+  /** Widen the zones with the values of a tuple. */
+  void Update(const Schema &schema, const Tuple &tuple);
+
+  /**
+   * @param predicate a predicate over the tuples of the table, i.e. a filter pushed down to a sequential scan
+   * @return false if no tuple summarized by this zone map can satisfy the predicate. Comparisons of a column with a
+   * constant or a bound parameter, combined with AND and OR, are checked; any other predicate may match.
+   */
+  auto MayMatch(const AbstractExpression &predicate) const -> bool;
+
+  /** @return the zone of a column */
+  auto GetColumnZone(uint32_t column_idx) const -> const ColumnZone & { return columns_[column_idx]; }
+
+ private:
+  std::vector<ColumnZone> columns_;
+};
+
+}  // namespace bustub
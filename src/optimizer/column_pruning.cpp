@@ -0,0 +1,383 @@
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "catalog/catalog.h"
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/nested_index_join_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/optimizer_internal.h"
+
+namespace bustub {
+
+namespace {
+
+/** The position of a column that was pruned. */
+constexpr uint32_t PRUNED = std::numeric_limits<uint32_t>::max();
+
+/** A pruned plan, and the position every column of the original output has in its output. */
+struct PrunedPlan {
+  AbstractPlanNodeRef plan_;
+  std::vector<uint32_t> positions_;
+};
+
+void Require(const AbstractExpressionRef &expr, std::vector<bool> *required) {
+  std::vector<uint32_t> columns;
+  CollectColumns(expr, &columns);
+  for (auto col_idx : columns) {
+    (*required)[col_idx] = true;
+  }
+}
+
+/** Mark the columns a join predicate reads, tuple 0 from the left input and tuple 1 from the right one. */
+void RequireJoin(const AbstractExpressionRef &expr, std::vector<bool> *left, std::vector<bool> *right) {
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get()); column != nullptr) {
+    (column->GetTupleIdx() == 0 ? *left : *right)[column->GetColIdx()] = true;
+  }
+  for (const auto &child : expr->GetChildren()) {
+    RequireJoin(child, left, right);
+  }
+}
+
+auto Remap(const AbstractExpressionRef &expr, const std::vector<uint32_t> &positions) -> AbstractExpressionRef {
+  return MapColumns(expr, [&](uint32_t tuple_idx, uint32_t col_idx) -> std::pair<uint32_t, uint32_t> {
+    BUSTUB_ENSURE(positions[col_idx] != PRUNED, "a pruned column is still read");
+    return {tuple_idx, positions[col_idx]};
+  });
+}
+
+auto RemapJoin(const AbstractExpressionRef &expr, const std::vector<uint32_t> &left, const std::vector<uint32_t> &right)
+    -> AbstractExpressionRef {
+  return MapColumns(expr, [&](uint32_t tuple_idx, uint32_t col_idx) -> std::pair<uint32_t, uint32_t> {
+    auto position = (tuple_idx == 0 ? left : right)[col_idx];
+    BUSTUB_ENSURE(position != PRUNED, "a pruned column is still read");
+    return {tuple_idx, position};
+  });
+}
+
+/** @return the indexes of the required columns, keeping at least one so that rows still have a width */
+auto KeptColumns(const std::vector<bool> &required) -> std::vector<uint32_t> {
+  std::vector<uint32_t> kept;
+  for (uint32_t col_idx = 0; col_idx < required.size(); col_idx++) {
+    if (required[col_idx]) {
+      kept.emplace_back(col_idx);
+    }
+  }
+  if (kept.empty() && !required.empty()) {
+    kept.emplace_back(0);
+  }
+  return kept;
+}
+
+auto PositionsOf(const std::vector<uint32_t> &kept, size_t width) -> std::vector<uint32_t> {
+  std::vector<uint32_t> positions(width, PRUNED);
+  for (uint32_t i = 0; i < kept.size(); i++) {
+    positions[kept[i]] = i;
+  }
+  return positions;
+}
+
+auto Unchanged(const AbstractPlanNodeRef &plan) -> PrunedPlan {
+  std::vector<uint32_t> positions(plan->OutputSchema().GetColumnCount());
+  std::iota(positions.begin(), positions.end(), 0);
+  return {plan, std::move(positions)};
+}
+
+/** The output of a join of two pruned inputs is the left columns followed by the right ones. */
+auto JoinPositions(const PrunedPlan &left, const std::vector<uint32_t> &right_positions) -> std::vector<uint32_t> {
+  auto positions = left.positions_;
+  auto left_width = left.plan_->OutputSchema().GetColumnCount();
+  for (auto position : right_positions) {
+    positions.emplace_back(position == PRUNED ? PRUNED : position + left_width);
+  }
+  return positions;
+}
+
+/**
+ * @return the position every column of a table has in the key of index, if the key holds all the required columns.
+ * The key stores the first key_size_ bytes of the key tuple, so it only holds the values of its columns when they are
+ * all inlined and fit in it: a VARCHAR in the key is truncated, or lives past the end of the key.
+ */
+auto CoveringKeyPositions(const IndexInfo &index, const std::vector<bool> &required)
+    -> std::optional<std::vector<uint32_t>> {
+  if (!index.key_schema_.IsInlined() || index.key_schema_.GetLength() > index.key_size_) {
+    return std::nullopt;
+  }
+  const auto &key_attrs = index.index_->GetKeyAttrs();
+  std::vector<uint32_t> positions(required.size(), PRUNED);
+  for (uint32_t i = 0; i < key_attrs.size(); i++) {
+    positions[key_attrs[i]] = i;
+  }
+  for (uint32_t col_idx = 0; col_idx < required.size(); col_idx++) {
+    if (required[col_idx] && positions[col_idx] == PRUNED) {
+      return std::nullopt;
+    }
+  }
+  return positions;
+}
+
+/** Prune the columns of plan that neither the parent (`required`) nor plan itself reads. */
+auto Prune(const Catalog &catalog, const AbstractPlanNodeRef &plan, const std::vector<bool> &required) -> PrunedPlan {
+  switch (plan->GetType()) {
+    case PlanType::Projection: {
+      const auto &projection = dynamic_cast<const ProjectionPlanNode &>(*plan);
+      auto kept = KeptColumns(required);
+      std::vector<bool> child_required(plan->GetChildAt(0)->OutputSchema().GetColumnCount());
+      for (auto col_idx : kept) {
+        Require(projection.GetExpressions()[col_idx], &child_required);
+      }
+      auto child = Prune(catalog, plan->GetChildAt(0), child_required);
+      std::vector<AbstractExpressionRef> expressions;
+      for (auto col_idx : kept) {
+        expressions.emplace_back(Remap(projection.GetExpressions()[col_idx], child.positions_));
+      }
+      auto schema = std::make_shared<Schema>(Schema::CopySchema(&plan->OutputSchema(), kept));
+      return {std::make_shared<ProjectionPlanNode>(schema, std::move(expressions), child.plan_),
+              PositionsOf(kept, required.size())};
+    }
+    case PlanType::Filter: {
+      const auto &filter = dynamic_cast<const FilterPlanNode &>(*plan);
+      auto child_required = required;
+      Require(filter.GetPredicate(), &child_required);
+      auto child = Prune(catalog, plan->GetChildAt(0), child_required);
+      return {std::make_shared<FilterPlanNode>(child.plan_->output_schema_,
+                                               Remap(filter.GetPredicate(), child.positions_), child.plan_),
+              child.positions_};
+    }
+    case PlanType::Sort:
+    case PlanType::TopN: {
+      const auto &order_bys = plan->GetType() == PlanType::Sort
+                                  ? dynamic_cast<const SortPlanNode &>(*plan).GetOrderBy()
+                                  : dynamic_cast<const TopNPlanNode &>(*plan).GetOrderBy();
+      auto child_required = required;
+      for (const auto &[_, expr] : order_bys) {
+        Require(expr, &child_required);
+      }
+      auto child = Prune(catalog, plan->GetChildAt(0), child_required);
+      std::vector<std::pair<OrderByType, AbstractExpressionRef>> remapped;
+      for (const auto &[type, expr] : order_bys) {
+        remapped.emplace_back(type, Remap(expr, child.positions_));
+      }
+      if (plan->GetType() == PlanType::Sort) {
+        return {std::make_shared<SortPlanNode>(child.plan_->output_schema_, child.plan_, std::move(remapped)),
+                child.positions_};
+      }
+      return {std::make_shared<TopNPlanNode>(child.plan_->output_schema_, child.plan_, std::move(remapped),
+                                             dynamic_cast<const TopNPlanNode &>(*plan).GetN()),
+              child.positions_};
+    }
+    case PlanType::Limit: {
+      auto child = Prune(catalog, plan->GetChildAt(0), required);
+      return {std::make_shared<LimitPlanNode>(child.plan_->output_schema_, child.plan_,
+                                              dynamic_cast<const LimitPlanNode &>(*plan).GetLimit()),
+              child.positions_};
+    }
+    case PlanType::Aggregation: {
+      // Group keys define the groups and always stay, unused aggregates go.
+      const auto &aggregation = dynamic_cast<const AggregationPlanNode &>(*plan);
+      auto group_count = aggregation.GetGroupBys().size();
+      std::vector<uint32_t> kept(group_count);
+      std::iota(kept.begin(), kept.end(), 0);
+      for (uint32_t i = 0; i < aggregation.GetAggregates().size(); i++) {
+        if (required[group_count + i]) {
+          kept.emplace_back(group_count + i);
+        }
+      }
+      if (kept.empty()) {
+        kept.emplace_back(0);
+      }
+      std::vector<bool> child_required(plan->GetChildAt(0)->OutputSchema().GetColumnCount());
+      for (auto col_idx : kept) {
+        Require(col_idx < group_count ? aggregation.GetGroupBys()[col_idx]
+                                      : aggregation.GetAggregateAt(col_idx - group_count),
+                &child_required);
+      }
+      auto child = Prune(catalog, plan->GetChildAt(0), child_required);
+      std::vector<AbstractExpressionRef> group_bys;
+      for (const auto &group_by : aggregation.GetGroupBys()) {
+        group_bys.emplace_back(Remap(group_by, child.positions_));
+      }
+      std::vector<AbstractExpressionRef> aggregates;
+      std::vector<AggregationType> agg_types;
+      for (auto col_idx : kept) {
+        if (col_idx >= group_count) {
+          aggregates.emplace_back(Remap(aggregation.GetAggregateAt(col_idx - group_count), child.positions_));
+          agg_types.emplace_back(aggregation.GetAggregateTypes()[col_idx - group_count]);
+        }
+      }
+      auto schema = std::make_shared<Schema>(Schema::CopySchema(&plan->OutputSchema(), kept));
+      return {std::make_shared<AggregationPlanNode>(schema, child.plan_, std::move(group_bys), std::move(aggregates),
+                                                    std::move(agg_types)),
+              PositionsOf(kept, required.size())};
+    }
+    case PlanType::NestedLoopJoin:
+    case PlanType::HashJoin: {
+      auto join_type = plan->GetType() == PlanType::NestedLoopJoin
+                           ? dynamic_cast<const NestedLoopJoinPlanNode &>(*plan).GetJoinType()
+                           : dynamic_cast<const HashJoinPlanNode &>(*plan).GetJoinType();
+      // Semi and anti joins only output the left columns, the right ones are read by the join alone.
+      bool left_only = join_type == JoinType::SEMI || join_type == JoinType::ANTI;
+      auto left_width = plan->GetChildAt(0)->OutputSchema().GetColumnCount();
+      std::vector<bool> left_required(required.begin(), required.begin() + left_width);
+      std::vector<bool> right_required(plan->GetChildAt(1)->OutputSchema().GetColumnCount());
+      if (!left_only) {
+        right_required.assign(required.begin() + left_width, required.end());
+      }
+      auto positions = [&](const PrunedPlan &left, const PrunedPlan &right) {
+        return left_only ? left.positions_ : JoinPositions(left, right.positions_);
+      };
+      if (plan->GetType() == PlanType::NestedLoopJoin) {
+        const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*plan);
+        RequireJoin(nlj_plan.Predicate(), &left_required, &right_required);
+        auto left = Prune(catalog, nlj_plan.GetLeftPlan(), left_required);
+        auto right = Prune(catalog, nlj_plan.GetRightPlan(), right_required);
+        auto schema =
+            std::make_shared<Schema>(NestedLoopJoinPlanNode::InferJoinSchema(*left.plan_, *right.plan_, join_type));
+        return {std::make_shared<NestedLoopJoinPlanNode>(
+                    schema, left.plan_, right.plan_, RemapJoin(nlj_plan.Predicate(), left.positions_, right.positions_),
+                    join_type),
+                positions(left, right)};
+      }
+      // The key expressions are evaluated on one input each, whatever tuple index they carry.
+      const auto &hash_join = dynamic_cast<const HashJoinPlanNode &>(*plan);
+      for (const auto &key : hash_join.LeftJoinKeyExpressions()) {
+        Require(key, &left_required);
+      }
+      for (const auto &key : hash_join.RightJoinKeyExpressions()) {
+        Require(key, &right_required);
+      }
+      auto left = Prune(catalog, hash_join.GetLeftPlan(), left_required);
+      auto right = Prune(catalog, hash_join.GetRightPlan(), right_required);
+      std::vector<AbstractExpressionRef> left_keys;
+      for (const auto &key : hash_join.LeftJoinKeyExpressions()) {
+        left_keys.emplace_back(Remap(key, left.positions_));
+      }
+      std::vector<AbstractExpressionRef> right_keys;
+      for (const auto &key : hash_join.RightJoinKeyExpressions()) {
+        right_keys.emplace_back(Remap(key, right.positions_));
+      }
+      auto schema =
+          std::make_shared<Schema>(NestedLoopJoinPlanNode::InferJoinSchema(*left.plan_, *right.plan_, join_type));
+      return {std::make_shared<HashJoinPlanNode>(schema, left.plan_, right.plan_, std::move(left_keys),
+                                                 std::move(right_keys), join_type),
+              positions(left, right)};
+    }
+    case PlanType::NestedIndexJoin: {
+      // The inner tuples come whole from the table, unless the index key holds all the inner columns read above: the
+      // join then reads the inner columns from the key. Only the outer side is pruned.
+      const auto &index_join = dynamic_cast<const NestedIndexJoinPlanNode &>(*plan);
+      auto outer_width = plan->GetChildAt(0)->OutputSchema().GetColumnCount();
+      std::vector<bool> outer_required(required.begin(), required.begin() + outer_width);
+      Require(index_join.KeyPredicate(), &outer_required);
+      auto outer = Prune(catalog, plan->GetChildAt(0), outer_required);
+      auto inner_schema = index_join.inner_table_schema_;
+      std::vector<uint32_t> inner_positions(inner_schema->GetColumnCount());
+      std::iota(inner_positions.begin(), inner_positions.end(), 0);
+      bool index_only = index_join.index_only_;
+      if (!index_only) {
+        const auto *index = catalog.GetIndex(index_join.GetIndexOid());
+        const auto &key_attrs = index->index_->GetKeyAttrs();
+        if (auto positions =
+                CoveringKeyPositions(*index, std::vector<bool>(required.begin() + outer_width, required.end()));
+            positions.has_value()) {
+          inner_schema = std::make_shared<Schema>(Schema::CopySchema(inner_schema.get(), key_attrs));
+          inner_positions = std::move(*positions);
+          index_only = true;
+        }
+      }
+      std::vector<Column> columns = outer.plan_->OutputSchema().GetColumns();
+      const auto &inner_columns = inner_schema->GetColumns();
+      columns.insert(columns.end(), inner_columns.begin(), inner_columns.end());
+      auto pruned = std::make_shared<NestedIndexJoinPlanNode>(
+          std::make_shared<Schema>(columns), outer.plan_, Remap(index_join.KeyPredicate(), outer.positions_),
+          index_join.GetInnerTableOid(), index_join.GetIndexOid(), index_join.GetIndexName(),
+          index_join.index_table_name_, std::move(inner_schema), index_join.GetJoinType());
+      pruned->index_only_ = index_only;
+      return {pruned, JoinPositions(outer, inner_positions)};
+    }
+    case PlanType::IndexScan: {
+      // An index scan that only needs the columns of the index key reads them from the key, without fetching the
+      // tuples from the table.
+      const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*plan);
+      if (index_scan.index_only_) {
+        return Unchanged(plan);
+      }
+      auto needed = required;
+      if (index_scan.filter_predicate_ != nullptr) {
+        Require(index_scan.filter_predicate_, &needed);
+      }
+      const auto *index = catalog.GetIndex(index_scan.GetIndexOid());
+      const auto &key_attrs = index->index_->GetKeyAttrs();
+      if (auto positions = CoveringKeyPositions(*index, needed); positions.has_value()) {
+        auto index_only = std::make_shared<IndexScanPlanNode>(index_scan);
+        index_only->output_schema_ =
+            std::make_shared<Schema>(Schema::CopySchema(&index_scan.OutputSchema(), key_attrs));
+        if (index_scan.filter_predicate_ != nullptr) {
+          index_only->filter_predicate_ = Remap(index_scan.filter_predicate_, *positions);
+        }
+        index_only->index_only_ = true;
+        return {index_only, std::move(*positions)};
+      }
+      [[fallthrough]];
+    }
+    case PlanType::Spool:
+    case PlanType::SeqScan:
+    case PlanType::MockScan:
+    case PlanType::Values: {
+      // The scan executors produce whole rows, a projection right over the scan narrows them for everything above.
+      // Every reader of a spool shares its rows, so the spooled plan keeps all its columns whatever one reader needs.
+      auto scan = plan;
+      if (plan->GetType() == PlanType::Spool) {
+        const auto &child = plan->GetChildAt(0);
+        auto all = std::vector<bool>(child->OutputSchema().GetColumnCount(), true);
+        scan = plan->CloneWithChildren({Prune(catalog, child, all).plan_});
+      }
+      auto kept = KeptColumns(required);
+      if (kept.size() == required.size()) {
+        return Unchanged(scan);
+      }
+      std::vector<AbstractExpressionRef> expressions;
+      for (auto col_idx : kept) {
+        expressions.emplace_back(
+            std::make_shared<ColumnValueExpression>(0, col_idx, plan->OutputSchema().GetColumn(col_idx).GetType()));
+      }
+      auto schema = std::make_shared<Schema>(Schema::CopySchema(&plan->OutputSchema(), kept));
+      return {std::make_shared<ProjectionPlanNode>(schema, std::move(expressions), std::move(scan)),
+              PositionsOf(kept, required.size())};
+    }
+    default:
+      break;
+  }
+
+  // Any other plan reads all the columns of its children.
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    auto all = std::vector<bool>(child->OutputSchema().GetColumnCount(), true);
+    children.emplace_back(Prune(catalog, child, all).plan_);
+  }
+  return Unchanged(plan->CloneWithChildren(std::move(children)));
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeColumnPruning(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  auto pruned = Prune(catalog_, plan, std::vector<bool>(plan->OutputSchema().GetColumnCount(), true));
+  return pruned.plan_;
+}
+
+}  // namespace bustub
@@ -0,0 +1,194 @@
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "fmt/format.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return whether two expressions compute the same value */
+auto SameExpression(const AbstractExpressionRef &a, const AbstractExpressionRef &b) -> bool {
+  const auto &a_expr = *a;
+  const auto &b_expr = *b;
+  if (typeid(a_expr) != typeid(b_expr) || a->GetReturnType() != b->GetReturnType() ||
+      a->GetChildren().size() != b->GetChildren().size() || a->ToString() != b->ToString()) {
+    return false;
+  }
+  for (size_t i = 0; i < a->GetChildren().size(); i++) {
+    if (!SameExpression(a->GetChildAt(i), b->GetChildAt(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** @return whether an expression is worth computing once: not a leaf, nor a logic expression that short-circuits */
+auto IsComputation(const AbstractExpressionRef &expr) -> bool {
+  return !expr->GetChildren().empty() && dynamic_cast<const LogicExpression *>(expr.get()) == nullptr;
+}
+
+/**
+ * CommonSubexpressions finds the subexpressions computed more than once by a list of expressions, and rewrites the
+ * expressions to read them from columns appended to the input instead.
+ */
+class CommonSubexpressions {
+ public:
+  explicit CommonSubexpressions(const std::vector<AbstractExpressionRef> &exprs) {
+    for (const auto &expr : exprs) {
+      Count(expr, true);
+    }
+  }
+
+  /** @return the expression reading the repeated subexpressions from the columns after the first input_width ones */
+  auto Rewrite(const AbstractExpressionRef &expr, size_t input_width) -> AbstractExpressionRef {
+    if (IsComputation(expr) && IsRepeated(expr)) {
+      size_t idx = 0;
+      while (idx < common_.size() && !SameExpression(common_[idx], expr)) {
+        idx++;
+      }
+      if (idx == common_.size()) {
+        common_.emplace_back(expr);
+      }
+      return std::make_shared<ColumnValueExpression>(0, input_width + idx, expr->GetReturnType());
+    }
+    std::vector<AbstractExpressionRef> children;
+    for (const auto &child : expr->GetChildren()) {
+      children.emplace_back(Rewrite(child, input_width));
+    }
+    return expr->CloneWithChildren(std::move(children));
+  }
+
+  /** @return the subexpressions replaced by Rewrite, in the order of their columns */
+  auto Common() const -> const std::vector<AbstractExpressionRef> & { return common_; }
+
+ private:
+  /** The occurrences of a subexpression, and whether one of them is evaluated for every row. */
+  struct Occurrences {
+    AbstractExpressionRef expr_;
+    size_t count_;
+    bool always_evaluated_;
+  };
+
+  /**
+   * Count the occurrences of the subexpressions of expr. The right operand of AND and OR may be skipped, so its
+   * occurrences are not always evaluated.
+   */
+  void Count(const AbstractExpressionRef &expr, bool always_evaluated) {
+    if (IsComputation(expr)) {
+      auto &candidates = counts_[expr->ToString()];
+      auto it = Find(expr);
+      if (it == candidates.end()) {
+        candidates.push_back({expr, 1, always_evaluated});
+      } else {
+        it->count_++;
+        it->always_evaluated_ = it->always_evaluated_ || always_evaluated;
+      }
+    }
+    bool is_logic = dynamic_cast<const LogicExpression *>(expr.get()) != nullptr;
+    for (size_t i = 0; i < expr->GetChildren().size(); i++) {
+      Count(expr->GetChildAt(i), always_evaluated && (!is_logic || i == 0));
+    }
+  }
+
+  /**
+   * @return whether expr is worth computing ahead: it occurs twice or more, and at least once where it is evaluated
+   * for every row. Computing ahead a subexpression that every row may skip could cost more than the short circuit
+   * saves, or fail on a row the short circuit would have filtered out.
+   */
+  auto IsRepeated(const AbstractExpressionRef &expr) -> bool {
+    auto it = Find(expr);
+    return it != counts_[expr->ToString()].end() && it->count_ > 1 && it->always_evaluated_;
+  }
+
+  auto Find(const AbstractExpressionRef &expr) -> std::vector<Occurrences>::iterator {
+    auto &candidates = counts_[expr->ToString()];
+    auto it = candidates.begin();
+    while (it != candidates.end() && !SameExpression(it->expr_, expr)) {
+      it++;
+    }
+    return it;
+  }
+
+  /** The occurrences of the subexpressions, by their string representation. */
+  std::unordered_map<std::string, std::vector<Occurrences>> counts_;
+  std::vector<AbstractExpressionRef> common_;
+};
+
+/** @return a projection of the columns of child followed by the values of exprs */
+auto AppendColumns(const AbstractPlanNodeRef &child, const std::vector<AbstractExpressionRef> &exprs)
+    -> AbstractPlanNodeRef {
+  std::vector<AbstractExpressionRef> columns;
+  std::vector<std::string> names;
+  const auto &child_columns = child->OutputSchema().GetColumns();
+  for (size_t i = 0; i < child_columns.size(); i++) {
+    columns.emplace_back(std::make_shared<ColumnValueExpression>(0, i, child_columns[i].GetType()));
+    names.emplace_back(child_columns[i].GetName());
+  }
+  for (size_t i = 0; i < exprs.size(); i++) {
+    columns.emplace_back(exprs[i]);
+    names.emplace_back(fmt::format("__common#{}", i));
+  }
+  return std::make_shared<ProjectionPlanNode>(
+      std::make_shared<Schema>(
+          ProjectionPlanNode::RenameSchema(ProjectionPlanNode::InferProjectionSchema(columns), names)),
+      std::move(columns), child);
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeCommonSubexpressions(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeCommonSubexpressions(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::Filter) {
+    const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+    const auto &child = filter_plan.GetChildPlan();
+    CommonSubexpressions common({filter_plan.GetPredicate()});
+    auto predicate = common.Rewrite(filter_plan.GetPredicate(), child->OutputSchema().GetColumnCount());
+    if (common.Common().empty()) {
+      return optimized_plan;
+    }
+    // Filter the rows with the computed columns, and drop them after.
+    auto input = AppendColumns(child, common.Common());
+    auto filter =
+        std::make_shared<FilterPlanNode>(std::make_shared<Schema>(input->OutputSchema()), std::move(predicate), input);
+    std::vector<AbstractExpressionRef> columns;
+    const auto &child_columns = child->OutputSchema().GetColumns();
+    for (size_t i = 0; i < child_columns.size(); i++) {
+      columns.emplace_back(std::make_shared<ColumnValueExpression>(0, i, child_columns[i].GetType()));
+    }
+    return std::make_shared<ProjectionPlanNode>(filter_plan.output_schema_, std::move(columns), std::move(filter));
+  }
+
+  if (optimized_plan->GetType() == PlanType::Projection) {
+    const auto &projection_plan = dynamic_cast<const ProjectionPlanNode &>(*optimized_plan);
+    const auto &child = projection_plan.GetChildPlan();
+    CommonSubexpressions common(projection_plan.GetExpressions());
+    std::vector<AbstractExpressionRef> exprs;
+    for (const auto &expr : projection_plan.GetExpressions()) {
+      exprs.emplace_back(common.Rewrite(expr, child->OutputSchema().GetColumnCount()));
+    }
+    if (common.Common().empty()) {
+      return optimized_plan;
+    }
+    return std::make_shared<ProjectionPlanNode>(projection_plan.output_schema_, std::move(exprs),
+                                                AppendColumns(child, common.Common()));
+  }
+
+  return optimized_plan;
+}
+
+}  // namespace bustub
@@ -0,0 +1,189 @@
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/parameter_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/optimizer_internal.h"
+
+namespace bustub {
+
+namespace {
+
+/**
+ * A fetch through the index costs a random page access where a sequential scan reads a whole page of tuples; the
+ * index only pays off when it keeps less than this fraction of the table.
+ */
+constexpr double INDEX_SCAN_MAX_SELECTIVITY = 0.25;
+
+/** A conjunct of the form `column op constant`. */
+struct ColumnComparison {
+  uint32_t col_idx_;
+  ComparisonType comp_type_;
+  AbstractExpressionRef value_;
+};
+
+/** @return the conjunct as `column op constant`, flipping `constant op column`; a parameter counts as a constant */
+auto MatchColumnComparison(const AbstractExpressionRef &conjunct) -> std::optional<ColumnComparison> {
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(conjunct.get());
+  if (comparison == nullptr) {
+    return std::nullopt;
+  }
+  for (size_t side = 0; side < 2; side++) {
+    const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(side).get());
+    const auto &value = comparison->GetChildAt(1 - side);
+    if (column == nullptr || (dynamic_cast<const ConstantValueExpression *>(value.get()) == nullptr &&
+                              dynamic_cast<const ParameterValueExpression *>(value.get()) == nullptr)) {
+      continue;
+    }
+    auto comp_type = comparison->comp_type_;
+    if (side == 1) {
+      switch (comp_type) {
+        case ComparisonType::LessThan:
+          comp_type = ComparisonType::GreaterThan;
+          break;
+        case ComparisonType::LessThanOrEqual:
+          comp_type = ComparisonType::GreaterThanOrEqual;
+          break;
+        case ComparisonType::GreaterThan:
+          comp_type = ComparisonType::LessThan;
+          break;
+        case ComparisonType::GreaterThanOrEqual:
+          comp_type = ComparisonType::LessThanOrEqual;
+          break;
+        default:
+          break;
+      }
+    }
+    return ColumnComparison{column->GetColIdx(), comp_type, value};
+  }
+  return std::nullopt;
+}
+
+/** The key range an index can scan for a set of conjuncts, and the conjuncts left to evaluate on the tuples. */
+struct KeyRange {
+  std::vector<AbstractExpressionRef> key_prefix_;
+  std::optional<IndexScanBound> lower_;
+  std::optional<IndexScanBound> upper_;
+  std::vector<AbstractExpressionRef> covered_;
+  std::vector<AbstractExpressionRef> residual_;
+};
+
+/**
+ * Match conjuncts to the key columns of an index: equalities on a prefix of the key columns, then a range on the next
+ * one. Sargable conjuncts on later key columns cannot narrow the scan and stay in the residual predicate.
+ */
+auto MatchKeyRange(const std::vector<AbstractExpressionRef> &conjuncts, const std::vector<uint32_t> &key_attrs)
+    -> KeyRange {
+  KeyRange range;
+  std::vector<bool> used(conjuncts.size(), false);
+  auto use = [&](size_t i) {
+    used[i] = true;
+    range.covered_.emplace_back(conjuncts[i]);
+  };
+
+  for (auto key_attr : key_attrs) {
+    std::optional<size_t> equality;
+    for (size_t i = 0; i < conjuncts.size() && !equality.has_value(); i++) {
+      auto comparison = MatchColumnComparison(conjuncts[i]);
+      if (!used[i] && comparison.has_value() && comparison->col_idx_ == key_attr &&
+          comparison->comp_type_ == ComparisonType::Equal) {
+        equality = i;
+      }
+    }
+    if (equality.has_value()) {
+      range.key_prefix_.emplace_back(MatchColumnComparison(conjuncts[*equality])->value_);
+      use(*equality);
+      continue;
+    }
+
+    for (size_t i = 0; i < conjuncts.size(); i++) {
+      auto comparison = MatchColumnComparison(conjuncts[i]);
+      if (used[i] || !comparison.has_value() || comparison->col_idx_ != key_attr) {
+        continue;
+      }
+      bool inclusive = comparison->comp_type_ == ComparisonType::GreaterThanOrEqual ||
+                       comparison->comp_type_ == ComparisonType::LessThanOrEqual;
+      if ((comparison->comp_type_ == ComparisonType::GreaterThan ||
+           comparison->comp_type_ == ComparisonType::GreaterThanOrEqual) &&
+          !range.lower_.has_value()) {
+        range.lower_ = IndexScanBound{comparison->value_, inclusive};
+        use(i);
+      } else if ((comparison->comp_type_ == ComparisonType::LessThan ||
+                  comparison->comp_type_ == ComparisonType::LessThanOrEqual) &&
+                 !range.upper_.has_value()) {
+        range.upper_ = IndexScanBound{comparison->value_, inclusive};
+        use(i);
+      }
+    }
+    break;
+  }
+
+  for (size_t i = 0; i < conjuncts.size(); i++) {
+    if (!used[i]) {
+      range.residual_.emplace_back(conjuncts[i]);
+    }
+  }
+  return range;
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeFilterAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeFilterAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // A filter over a sequential scan, or a sequential scan with its own filter.
+  const SeqScanPlanNode *seq_scan = nullptr;
+  std::vector<AbstractExpressionRef> conjuncts;
+  if (optimized_plan->GetType() == PlanType::Filter && optimized_plan->GetChildAt(0)->GetType() == PlanType::SeqScan) {
+    seq_scan = dynamic_cast<const SeqScanPlanNode *>(optimized_plan->GetChildAt(0).get());
+    SplitConjuncts(dynamic_cast<const FilterPlanNode &>(*optimized_plan).GetPredicate(), &conjuncts);
+  } else if (optimized_plan->GetType() == PlanType::SeqScan) {
+    seq_scan = dynamic_cast<const SeqScanPlanNode *>(optimized_plan.get());
+  } else {
+    return optimized_plan;
+  }
+  if (seq_scan->filter_predicate_ != nullptr) {
+    SplitConjuncts(seq_scan->filter_predicate_, &conjuncts);
+  }
+  if (conjuncts.empty()) {
+    return optimized_plan;
+  }
+
+  // Pick the index whose key range keeps the fewest rows.
+  std::optional<KeyRange> best;
+  const IndexInfo *best_index = nullptr;
+  double best_selectivity = INDEX_SCAN_MAX_SELECTIVITY;
+  for (const auto *index_info : catalog_.GetTableIndexes(seq_scan->table_name_)) {
+    auto range = MatchKeyRange(conjuncts, index_info->index_->GetKeyAttrs());
+    if (range.covered_.empty()) {
+      continue;
+    }
+    auto selectivity = EstimateSelectivity(seq_scan->table_name_, MakeConjunction(range.covered_));
+    if (selectivity < best_selectivity) {
+      best_selectivity = selectivity;
+      best = std::move(range);
+      best_index = index_info;
+    }
+  }
+  if (best_index == nullptr) {
+    return optimized_plan;
+  }
+  auto filter_predicate = best->residual_.empty() ? nullptr : MakeConjunction(best->residual_);
+  return std::make_shared<IndexScanPlanNode>(seq_scan->output_schema_, best_index->index_oid_,
+                                             std::move(best->key_prefix_), std::move(best->lower_),
+                                             std::move(best->upper_), std::move(filter_predicate));
+}
+
+}  // namespace bustub
@@ -0,0 +1,598 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/nested_index_join_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/optimizer_internal.h"
+
+namespace bustub {
+
+namespace {
+
+/** Joins of up to this many relations are enumerated exhaustively, larger ones greedily. */
+constexpr size_t DPCCP_MAX_RELATIONS = 10;
+/** Relation sets are 64-bit sets, joins of more relations keep their written order. */
+constexpr size_t MAX_RELATIONS = 64;
+/** The assumed size of a relation nothing is known about, e.g. a subquery. */
+constexpr double DEFAULT_CARDINALITY = 1000;
+/** The cost of inserting a tuple into a hash table, relative to reading one. */
+constexpr double HASH_BUILD_COST = 2;
+/** The cost of probing an index (B+ tree descent and heap fetch), relative to reading a tuple. */
+constexpr double INDEX_PROBE_COST = 4;
+
+using RelationSet = uint64_t;
+
+auto Singleton(size_t relation) -> RelationSet { return RelationSet{1} << relation; }
+
+auto IsSubset(RelationSet subset, RelationSet set) -> bool { return (subset & ~set) == 0; }
+
+/** A vertex of the join graph: a table scan, or any other plan that is not an inner join. */
+struct JoinRelation {
+  AbstractPlanNodeRef plan_;
+  /** The table scanned, empty if the relation is not a scan. */
+  std::string table_name_;
+  /** The position of the first column of the relation in the output of the original join tree. */
+  size_t offset_;
+  size_t width_;
+  /** The conjuncts that only read this relation, over its own columns. */
+  std::vector<AbstractExpressionRef> filters_{};
+  /** The number of rows the relation reads, and the number it returns after its filters. */
+  double scanned_{0};
+  double cardinality_{0};
+  /** For an unfiltered table scan, the index keyed on each column, if any. */
+  std::vector<std::optional<std::tuple<index_oid_t, std::string>>> indexes_{};
+};
+
+/** An edge of the join graph: a conjunct over the columns of the original join tree output. */
+struct JoinPredicate {
+  AbstractExpressionRef expr_;
+  RelationSet relations_;
+  /** For a `left = right` conjunct whose sides read disjoint relations, the relations each side reads. */
+  RelationSet left_relations_{0};
+  RelationSet right_relations_{0};
+  double selectivity_{1};
+
+  auto IsEquiJoin() const -> bool { return left_relations_ != 0 && right_relations_ != 0; }
+};
+
+enum class JoinAlgorithm { Leaf, NestedLoop, Hash, NestedIndex };
+
+struct JoinTree;
+using JoinTreeRef = std::shared_ptr<const JoinTree>;
+
+/**
+ * A join tree considered by the enumerator. The left child is the outer side of a nested loop or nested index join
+ * and the probe side of a hash join.
+ */
+struct JoinTree {
+  RelationSet relations_;
+  double cardinality_;
+  double cost_;
+  JoinAlgorithm algorithm_;
+  JoinTreeRef left_;
+  JoinTreeRef right_;
+  /** The relation of a leaf, or the predicate a nested index join probes the index with. */
+  size_t relation_{0};
+  size_t index_key_{0};
+};
+
+auto IsInnerNLJ(const AbstractPlanNodeRef &plan) -> bool {
+  return plan->GetType() == PlanType::NestedLoopJoin &&
+         dynamic_cast<const NestedLoopJoinPlanNode &>(*plan).GetJoinType() == JoinType::INNER;
+}
+
+/** @return whether the plan is an inner nested loop join, possibly under filters */
+auto IsJoinGraph(const AbstractPlanNodeRef &plan) -> bool {
+  if (plan->GetType() == PlanType::Filter) {
+    return IsJoinGraph(plan->GetChildAt(0));
+  }
+  return IsInnerNLJ(plan);
+}
+
+/**
+ * Flatten a tree of inner joins and filters into its relations and the conjuncts of its predicates. `offset` is the
+ * position of the first column of `plan` in the output of the whole tree.
+ */
+void CollectJoinGraph(const AbstractPlanNodeRef &plan, size_t offset, std::vector<JoinRelation> *relations,
+                      std::vector<AbstractExpressionRef> *conjuncts) {
+  if (IsJoinGraph(plan)) {
+    size_t left_width = 0;
+    AbstractExpressionRef predicate;
+    if (plan->GetType() == PlanType::Filter) {
+      predicate = dynamic_cast<const FilterPlanNode &>(*plan).GetPredicate();
+      CollectJoinGraph(plan->GetChildAt(0), offset, relations, conjuncts);
+    } else {
+      const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*plan);
+      predicate = nlj_plan.Predicate();
+      left_width = nlj_plan.GetLeftPlan()->OutputSchema().GetColumnCount();
+      CollectJoinGraph(nlj_plan.GetLeftPlan(), offset, relations, conjuncts);
+      CollectJoinGraph(nlj_plan.GetRightPlan(), offset + left_width, relations, conjuncts);
+    }
+    SplitConjuncts(MapColumns(predicate,
+                              [&](uint32_t tuple_idx, uint32_t col_idx) -> std::pair<uint32_t, uint32_t> {
+                                return {0, offset + col_idx + (tuple_idx == 1 ? left_width : 0)};
+                              }),
+                   conjuncts);
+    return;
+  }
+  if (plan->GetType() == PlanType::Filter && (plan->GetChildAt(0)->GetType() == PlanType::SeqScan ||
+                                              plan->GetChildAt(0)->GetType() == PlanType::MockScan)) {
+    // A filter pushed down to a scan is taken apart, to estimate the scan and to be pushed down again.
+    CollectJoinGraph(plan->GetChildAt(0), offset, relations, conjuncts);
+    SplitConjuncts(MapColumns(dynamic_cast<const FilterPlanNode &>(*plan).GetPredicate(),
+                              [&](uint32_t, uint32_t col_idx) -> std::pair<uint32_t, uint32_t> {
+                                return {0, offset + col_idx};
+                              }),
+                   conjuncts);
+    return;
+  }
+  relations->emplace_back(JoinRelation{plan, "", offset, plan->OutputSchema().GetColumnCount()});
+}
+
+/** Enumerates the join trees of a join graph and builds the plan of the cheapest one. */
+class JoinOrderEnumerator {
+ public:
+  JoinOrderEnumerator(const std::vector<JoinRelation> &relations, const std::vector<JoinPredicate> &predicates)
+      : relations_(relations), predicates_(predicates), adjacency_(relations.size(), 0) {
+    for (size_t i = 0; i < relations_.size(); i++) {
+      relation_of_column_.insert(relation_of_column_.end(), relations_[i].width_, i);
+    }
+    for (const auto &predicate : predicates_) {
+      // Only binary edges make the graph connected, a conjunct over more relations is applied once all are joined.
+      if (__builtin_popcountll(predicate.relations_) == 2) {
+        auto first = __builtin_ctzll(predicate.relations_);
+        auto second = 63 - __builtin_clzll(predicate.relations_);
+        adjacency_[first] |= Singleton(second);
+        adjacency_[second] |= Singleton(first);
+      }
+    }
+  }
+
+  /** @return the cheapest join tree found */
+  auto Enumerate() const -> JoinTreeRef {
+    if (relations_.size() <= DPCCP_MAX_RELATIONS) {
+      if (auto tree = DPccp(); tree != nullptr) {
+        return tree;
+      }
+    }
+    return Greedy();
+  }
+
+  /** @return the plan of a join tree, and the relations in the order its output has their columns */
+  auto Build(const JoinTreeRef &tree) const -> std::pair<AbstractPlanNodeRef, std::vector<size_t>> {
+    if (tree->algorithm_ == JoinAlgorithm::Leaf) {
+      const auto &relation = relations_[tree->relation_];
+      auto plan = relation.plan_;
+      if (!relation.filters_.empty()) {
+        plan = std::make_shared<FilterPlanNode>(plan->output_schema_, MakeConjunction(relation.filters_), plan);
+      }
+      return {plan, {tree->relation_}};
+    }
+
+    AbstractPlanNodeRef left_plan;
+    AbstractPlanNodeRef right_plan;
+    std::vector<size_t> left_order;
+    std::vector<size_t> right_order;
+    std::tie(left_plan, left_order) = Build(tree->left_);
+    std::tie(right_plan, right_order) = Build(tree->right_);
+    std::vector<size_t> order = left_order;
+    order.insert(order.end(), right_order.begin(), right_order.end());
+    // Join predicates read the left input as tuple 0 and the right one as tuple 1, filters above the join read its
+    // output as tuple 0.
+    ColumnMapping join_mapping = [&](uint32_t, uint32_t col_idx) -> std::pair<uint32_t, uint32_t> {
+      if (IsSubset(Singleton(relation_of_column_[col_idx]), tree->left_->relations_)) {
+        return {0, Position(left_order, col_idx)};
+      }
+      return {1, Position(right_order, col_idx)};
+    };
+    ColumnMapping output_mapping = [&](uint32_t, uint32_t col_idx) -> std::pair<uint32_t, uint32_t> {
+      return {0, Position(order, col_idx)};
+    };
+
+    std::vector<AbstractExpressionRef> join_conjuncts;
+    std::vector<AbstractExpressionRef> residual;
+    std::vector<AbstractExpressionRef> left_keys;
+    std::vector<AbstractExpressionRef> right_keys;
+    AbstractExpressionRef index_key;
+    for (size_t i = 0; i < predicates_.size(); i++) {
+      const auto &predicate = predicates_[i];
+      if (!IsJoinedBy(predicate, tree->left_->relations_, tree->right_->relations_)) {
+        continue;
+      }
+      if (tree->algorithm_ == JoinAlgorithm::NestedLoop) {
+        join_conjuncts.emplace_back(MapColumns(predicate.expr_, join_mapping));
+      } else if (tree->algorithm_ == JoinAlgorithm::Hash && IsSplitBy(predicate, tree->left_->relations_)) {
+        auto left_side = IsSubset(predicate.left_relations_, tree->left_->relations_) ? 0 : 1;
+        left_keys.emplace_back(MapColumns(predicate.expr_->GetChildAt(left_side), join_mapping));
+        right_keys.emplace_back(MapColumns(predicate.expr_->GetChildAt(1 - left_side), join_mapping));
+      } else if (tree->algorithm_ == JoinAlgorithm::NestedIndex && i == tree->index_key_) {
+        auto outer_side = IsSubset(predicate.left_relations_, tree->left_->relations_) ? 0 : 1;
+        index_key = MapColumns(predicate.expr_->GetChildAt(outer_side), join_mapping);
+      } else {
+        residual.emplace_back(MapColumns(predicate.expr_, output_mapping));
+      }
+    }
+
+    auto schema = std::make_shared<Schema>(NestedLoopJoinPlanNode::InferJoinSchema(*left_plan, *right_plan));
+    AbstractPlanNodeRef plan;
+    switch (tree->algorithm_) {
+      case JoinAlgorithm::NestedLoop:
+        plan = std::make_shared<NestedLoopJoinPlanNode>(schema, left_plan, right_plan, MakeConjunction(join_conjuncts),
+                                                        JoinType::INNER);
+        break;
+      case JoinAlgorithm::Hash:
+        plan = std::make_shared<HashJoinPlanNode>(schema, left_plan, right_plan, std::move(left_keys),
+                                                  std::move(right_keys), JoinType::INNER);
+        break;
+      case JoinAlgorithm::NestedIndex: {
+        const auto &inner = relations_[tree->right_->relation_];
+        const auto &inner_scan = dynamic_cast<const SeqScanPlanNode &>(*inner.plan_);
+        auto [index_oid, index_name] = *inner.indexes_[*IndexKeyColumn(predicates_[tree->index_key_], inner)];
+        plan = std::make_shared<NestedIndexJoinPlanNode>(schema, left_plan, index_key, inner_scan.GetTableOid(),
+                                                         index_oid, index_name, inner_scan.table_name_,
+                                                         inner_scan.output_schema_, JoinType::INNER);
+        break;
+      }
+      case JoinAlgorithm::Leaf:
+        UNREACHABLE("leaves are built above");
+    }
+    if (!residual.empty()) {
+      plan = std::make_shared<FilterPlanNode>(plan->output_schema_, MakeConjunction(residual), plan);
+    }
+    return {plan, std::move(order)};
+  }
+
+  /** @return the position of a column of the original join tree output in an output with the given relation order */
+  auto Position(const std::vector<size_t> &order, uint32_t col_idx) const -> uint32_t {
+    auto relation = relation_of_column_[col_idx];
+    uint32_t position = 0;
+    for (auto other : order) {
+      if (other == relation) {
+        return position + col_idx - relations_[relation].offset_;
+      }
+      position += relations_[other].width_;
+    }
+    UNREACHABLE("column not in the join output");
+  }
+
+ private:
+  /** @return whether the predicate is applied by the join of left and right */
+  static auto IsJoinedBy(const JoinPredicate &predicate, RelationSet left, RelationSet right) -> bool {
+    return IsSubset(predicate.relations_, left | right) && !IsSubset(predicate.relations_, left) &&
+           !IsSubset(predicate.relations_, right);
+  }
+
+  /** @return whether one side of the equality reads only `left`, and the other side none of it */
+  static auto IsSplitBy(const JoinPredicate &predicate, RelationSet left) -> bool {
+    if (!predicate.IsEquiJoin()) {
+      return false;
+    }
+    return (IsSubset(predicate.left_relations_, left) && (predicate.right_relations_ & left) == 0) ||
+           (IsSubset(predicate.right_relations_, left) && (predicate.left_relations_ & left) == 0);
+  }
+
+  /** @return the column of `inner` an index join can look up with this predicate, if it has an index */
+  static auto IndexKeyColumn(const JoinPredicate &predicate, const JoinRelation &inner) -> std::optional<uint32_t> {
+    if (!predicate.IsEquiJoin()) {
+      return std::nullopt;
+    }
+    for (size_t side = 0; side < 2; side++) {
+      const auto *column = dynamic_cast<const ColumnValueExpression *>(predicate.expr_->GetChildAt(side).get());
+      if (column == nullptr || column->GetColIdx() < inner.offset_ ||
+          column->GetColIdx() >= inner.offset_ + inner.width_) {
+        continue;
+      }
+      auto col_idx = column->GetColIdx() - inner.offset_;
+      if (col_idx < inner.indexes_.size() && inner.indexes_[col_idx].has_value()) {
+        return col_idx;
+      }
+    }
+    return std::nullopt;
+  }
+
+  auto Leaf(size_t relation) const -> JoinTreeRef {
+    const auto &rel = relations_[relation];
+    return std::make_shared<JoinTree>(
+        JoinTree{Singleton(relation), rel.cardinality_, rel.scanned_, JoinAlgorithm::Leaf, nullptr, nullptr, relation});
+  }
+
+  auto IsConnected(RelationSet left, RelationSet right) const -> bool {
+    return std::any_of(predicates_.begin(), predicates_.end(),
+                       [&](const JoinPredicate &predicate) { return IsJoinedBy(predicate, left, right); });
+  }
+
+  /** @return the cheapest way to join two disjoint join trees, over both orders and all applicable algorithms */
+  auto BestJoin(const JoinTreeRef &first, const JoinTreeRef &second) const -> JoinTreeRef {
+    auto relations = first->relations_ | second->relations_;
+    auto cardinality = first->cardinality_ * second->cardinality_;
+    for (const auto &predicate : predicates_) {
+      if (IsJoinedBy(predicate, first->relations_, second->relations_)) {
+        cardinality *= predicate.selectivity_;
+      }
+    }
+    cardinality = std::max(cardinality, 1.0);
+
+    JoinTreeRef best;
+    auto consider = [&](JoinTree tree) {
+      if (best == nullptr || tree.cost_ < best->cost_) {
+        best = std::make_shared<JoinTree>(std::move(tree));
+      }
+    };
+    for (const auto &order : {std::make_pair(first, second), std::make_pair(second, first)}) {
+      const auto &outer = order.first;
+      const auto &inner = order.second;
+      // A nested loop join runs its inner side again for every outer tuple.
+      consider({relations, cardinality, outer->cost_ + outer->cardinality_ * inner->cost_ + cardinality,
+                JoinAlgorithm::NestedLoop, outer, inner});
+
+      bool has_equi_join = std::any_of(predicates_.begin(), predicates_.end(), [&](const JoinPredicate &predicate) {
+        return IsJoinedBy(predicate, outer->relations_, inner->relations_) &&
+               IsSplitBy(predicate, outer->relations_);
+      });
+      if (has_equi_join) {
+        consider({relations, cardinality,
+                  outer->cost_ + inner->cost_ + HASH_BUILD_COST * inner->cardinality_ + outer->cardinality_ +
+                      cardinality,
+                  JoinAlgorithm::Hash, outer, inner});
+      }
+
+      if (inner->algorithm_ != JoinAlgorithm::Leaf || relations_[inner->relation_].indexes_.empty()) {
+        continue;
+      }
+      for (size_t i = 0; i < predicates_.size(); i++) {
+        const auto &predicate = predicates_[i];
+        if (IsJoinedBy(predicate, outer->relations_, inner->relations_) && IsSplitBy(predicate, outer->relations_) &&
+            IndexKeyColumn(predicate, relations_[inner->relation_]).has_value()) {
+          JoinTree tree{relations, cardinality, outer->cost_ + INDEX_PROBE_COST * outer->cardinality_ + cardinality,
+                        JoinAlgorithm::NestedIndex, outer, inner};
+          tree.index_key_ = i;
+          consider(std::move(tree));
+          break;
+        }
+      }
+    }
+    return best;
+  }
+
+  /** @return the connected subgraphs that extend `set` with neighbours not in `excluded` */
+  void EnumerateCsgRec(RelationSet set, RelationSet excluded, std::vector<RelationSet> *subgraphs) const {
+    RelationSet neighbors = 0;
+    for (size_t i = 0; i < relations_.size(); i++) {
+      if ((set & Singleton(i)) != 0) {
+        neighbors |= adjacency_[i];
+      }
+    }
+    neighbors &= ~(set | excluded);
+    for (auto subset = neighbors; subset != 0; subset = (subset - 1) & neighbors) {
+      subgraphs->emplace_back(set | subset);
+    }
+    for (auto subset = neighbors; subset != 0; subset = (subset - 1) & neighbors) {
+      EnumerateCsgRec(set | subset, excluded | neighbors, subgraphs);
+    }
+  }
+
+  /**
+   * DPccp (Moerkotte and Neumann): enumerate every pair of a connected subgraph and a connected complement joined to
+   * it exactly once, and keep the cheapest tree of every connected subgraph.
+   * @return the cheapest tree, or nullptr if the join graph is not connected
+   */
+  auto DPccp() const -> JoinTreeRef {
+    auto num_relations = relations_.size();
+    std::unordered_map<RelationSet, JoinTreeRef> best;
+    std::vector<std::pair<RelationSet, RelationSet>> pairs;
+    for (size_t i = num_relations; i-- > 0;) {
+      best[Singleton(i)] = Leaf(i);
+      // The subgraphs whose smallest relation is i.
+      std::vector<RelationSet> subgraphs{Singleton(i)};
+      EnumerateCsgRec(Singleton(i), Singleton(i) - 1, &subgraphs);
+      for (auto subgraph : subgraphs) {
+        auto excluded = (Singleton(__builtin_ctzll(subgraph)) - 1) | subgraph;
+        RelationSet neighbors = 0;
+        for (size_t j = 0; j < num_relations; j++) {
+          if ((subgraph & Singleton(j)) != 0) {
+            neighbors |= adjacency_[j];
+          }
+        }
+        neighbors &= ~excluded;
+        for (size_t j = num_relations; j-- > 0;) {
+          if ((neighbors & Singleton(j)) == 0) {
+            continue;
+          }
+          std::vector<RelationSet> complements{Singleton(j)};
+          EnumerateCsgRec(Singleton(j), excluded | (neighbors & (Singleton(j) - 1)), &complements);
+          for (auto complement : complements) {
+            pairs.emplace_back(subgraph, complement);
+          }
+        }
+      }
+    }
+
+    // Smaller subgraphs first, so both halves of a pair have their best tree when it is considered.
+    std::stable_sort(pairs.begin(), pairs.end(), [](const auto &a, const auto &b) {
+      return __builtin_popcountll(a.first | a.second) < __builtin_popcountll(b.first | b.second);
+    });
+    for (const auto &[subgraph, complement] : pairs) {
+      auto tree = BestJoin(best.at(subgraph), best.at(complement));
+      auto &current = best[subgraph | complement];
+      if (current == nullptr || tree->cost_ < current->cost_) {
+        current = tree;
+      }
+    }
+    auto all = best.find(Singleton(num_relations) - 1);
+    return all == best.end() ? nullptr : all->second;
+  }
+
+  /**
+   * Greedy operator ordering: repeatedly join the two trees with the smallest result, preferring pairs connected by a
+   * predicate over cross products.
+   */
+  auto Greedy() const -> JoinTreeRef {
+    std::vector<JoinTreeRef> trees;
+    for (size_t i = 0; i < relations_.size(); i++) {
+      trees.emplace_back(Leaf(i));
+    }
+    while (trees.size() > 1) {
+      JoinTreeRef best;
+      bool best_connected = false;
+      size_t best_i = 0;
+      size_t best_j = 0;
+      for (size_t i = 0; i < trees.size(); i++) {
+        for (size_t j = i + 1; j < trees.size(); j++) {
+          bool connected = IsConnected(trees[i]->relations_, trees[j]->relations_);
+          if (best != nullptr && best_connected && !connected) {
+            continue;
+          }
+          auto tree = BestJoin(trees[i], trees[j]);
+          if (best == nullptr || connected != best_connected || tree->cardinality_ < best->cardinality_ ||
+              (tree->cardinality_ == best->cardinality_ && tree->cost_ < best->cost_)) {
+            best = tree;
+            best_connected = connected;
+            best_i = i;
+            best_j = j;
+          }
+        }
+      }
+      trees[best_i] = best;
+      trees.erase(trees.begin() + best_j);
+    }
+    return trees[0];
+  }
+
+  const std::vector<JoinRelation> &relations_;
+  const std::vector<JoinPredicate> &predicates_;
+  /** The relations each relation shares a binary join predicate with. */
+  std::vector<RelationSet> adjacency_;
+  /** The relation every column of the original join tree output belongs to. */
+  std::vector<size_t> relation_of_column_;
+};
+
+}  // namespace
+
+auto Optimizer::OptimizeJoinOrder(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<JoinRelation> relations;
+  std::vector<AbstractExpressionRef> conjuncts;
+  if (IsJoinGraph(plan)) {
+    CollectJoinGraph(plan, 0, &relations, &conjuncts);
+  }
+  if (relations.empty() || relations.size() > MAX_RELATIONS) {
+    std::vector<AbstractPlanNodeRef> children;
+    for (const auto &child : plan->GetChildren()) {
+      children.emplace_back(OptimizeJoinOrder(child));
+    }
+    return plan->CloneWithChildren(std::move(children));
+  }
+
+  std::vector<size_t> relation_of_column;
+  for (size_t i = 0; i < relations.size(); i++) {
+    relation_of_column.insert(relation_of_column.end(), relations[i].width_, i);
+  }
+  auto relations_of = [&](const AbstractExpressionRef &expr) {
+    std::vector<uint32_t> columns;
+    CollectColumns(expr, &columns);
+    RelationSet set = 0;
+    for (auto col_idx : columns) {
+      set |= Singleton(relation_of_column[col_idx]);
+    }
+    return set;
+  };
+
+  // Push the conjuncts over a single relation down to it, the others become the edges of the join graph.
+  std::vector<AbstractExpressionRef> constant_conjuncts;
+  std::vector<JoinPredicate> predicates;
+  for (const auto &conjunct : conjuncts) {
+    auto set = relations_of(conjunct);
+    if (set == 0) {
+      constant_conjuncts.emplace_back(conjunct);
+    } else if (__builtin_popcountll(set) == 1) {
+      auto &relation = relations[__builtin_ctzll(set)];
+      relation.filters_.emplace_back(
+          MapColumns(conjunct, [&](uint32_t, uint32_t col_idx) -> std::pair<uint32_t, uint32_t> {
+            return {0, col_idx - relation.offset_};
+          }));
+    } else {
+      predicates.emplace_back(JoinPredicate{conjunct, set});
+    }
+  }
+
+  for (auto &relation : relations) {
+    relation.plan_ = OptimizeJoinOrder(relation.plan_);
+    if (relation.plan_->GetType() == PlanType::SeqScan) {
+      const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*relation.plan_);
+      relation.table_name_ = seq_scan.table_name_;
+      if (seq_scan.filter_predicate_ == nullptr && relation.filters_.empty()) {
+        for (uint32_t col_idx = 0; col_idx < relation.width_; col_idx++) {
+          relation.indexes_.emplace_back(MatchIndex(relation.table_name_, col_idx));
+        }
+      }
+    } else if (relation.plan_->GetType() == PlanType::MockScan) {
+      relation.table_name_ = dynamic_cast<const MockScanPlanNode &>(*relation.plan_).GetTable();
+    }
+    relation.scanned_ = std::max<double>(EstimatedCardinality(relation.table_name_).value_or(DEFAULT_CARDINALITY), 1);
+    auto selectivity = EstimateSelectivity(relation.table_name_, MakeConjunction(relation.filters_));
+    relation.cardinality_ = std::max(relation.scanned_ * selectivity, 1.0);
+  }
+
+  for (auto &predicate : predicates) {
+    predicate.selectivity_ = EstimateSelectivity("", predicate.expr_);
+    const auto *comparison = dynamic_cast<const ComparisonExpression *>(predicate.expr_.get());
+    if (comparison == nullptr || comparison->comp_type_ != ComparisonType::Equal) {
+      continue;
+    }
+    auto left = relations_of(comparison->GetChildAt(0));
+    auto right = relations_of(comparison->GetChildAt(1));
+    if (left == 0 || right == 0 || (left & right) != 0) {
+      continue;
+    }
+    predicate.left_relations_ = left;
+    predicate.right_relations_ = right;
+    // Without statistics, assume the column of the larger side is a key the other side references.
+    std::vector<double> distinct_counts;
+    for (const auto &side : comparison->GetChildren()) {
+      const auto *column = dynamic_cast<const ColumnValueExpression *>(side.get());
+      if (column == nullptr) {
+        continue;
+      }
+      const auto &relation = relations[relation_of_column[column->GetColIdx()]];
+      auto distinct = EstimatedDistinctCount(relation.table_name_, column->GetColIdx() - relation.offset_);
+      auto count = distinct.has_value() ? static_cast<double>(*distinct) : relation.cardinality_;
+      distinct_counts.emplace_back(std::clamp(count, 1.0, relation.cardinality_));
+    }
+    if (distinct_counts.size() == 2) {
+      predicate.selectivity_ = 1 / std::max(distinct_counts[0], distinct_counts[1]);
+    }
+  }
+
+  JoinOrderEnumerator enumerator(relations, predicates);
+  auto [joined, order] = enumerator.Build(enumerator.Enumerate());
+  if (!constant_conjuncts.empty()) {
+    joined = std::make_shared<FilterPlanNode>(joined->output_schema_, MakeConjunction(constant_conjuncts), joined);
+  }
+  if (std::is_sorted(order.begin(), order.end())) {
+    return joined;
+  }
+  std::vector<AbstractExpressionRef> columns;
+  for (uint32_t col_idx = 0; col_idx < plan->OutputSchema().GetColumnCount(); col_idx++) {
+    columns.emplace_back(std::make_shared<ColumnValueExpression>(0, enumerator.Position(order, col_idx),
+                                                                 plan->OutputSchema().GetColumn(col_idx).GetType()));
+  }
+  return std::make_shared<ProjectionPlanNode>(plan->output_schema_, std::move(columns), joined);
+}
+
+}  // namespace bustub
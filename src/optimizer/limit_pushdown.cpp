@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/optimizer_internal.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the predicate of the scan, AND the predicate of a filter over it if any */
+auto MergePredicates(const AbstractExpressionRef &scan_predicate, const AbstractExpressionRef &filter_predicate)
+    -> AbstractExpressionRef {
+  if (scan_predicate == nullptr) {
+    return filter_predicate;
+  }
+  std::vector<AbstractExpressionRef> conjuncts;
+  SplitConjuncts(scan_predicate, &conjuncts);
+  SplitConjuncts(filter_predicate, &conjuncts);
+  return MakeConjunction(conjuncts);
+}
+
+/**
+ * @return a scan of plan that stops after limit tuples passing filter_predicate (nullptr if none), nullptr if plan is
+ * not a scan, or has a limit already and a filter to merge
+ */
+template <typename ScanPlanNode>
+auto LimitScan(const AbstractPlanNodeRef &plan, size_t limit, const AbstractExpressionRef &filter_predicate)
+    -> AbstractPlanNodeRef {
+  const auto *scan = dynamic_cast<const ScanPlanNode *>(plan.get());
+  if (scan == nullptr) {
+    return nullptr;
+  }
+  auto limited = std::make_shared<ScanPlanNode>(*scan);
+  if (filter_predicate != nullptr) {
+    // The limit counts the tuples passing the filter: it must not be already applied to the tuples before it.
+    if (scan->limit_.has_value()) {
+      return nullptr;
+    }
+    limited->filter_predicate_ = MergePredicates(scan->filter_predicate_, filter_predicate);
+  }
+  limited->limit_ = std::min(limit, scan->limit_.value_or(limit));
+  return limited;
+}
+
+/**
+ * @return plan with its scan told to stop after limit rows, as a hint: the rows of plan past the first limit ones may
+ * still be produced, the limit above plan drops them.
+ */
+auto HintLimit(const AbstractPlanNodeRef &plan, size_t limit) -> AbstractPlanNodeRef {
+  AbstractPlanNodeRef scan = nullptr;
+  switch (plan->GetType()) {
+    case PlanType::Projection: {
+      // A projection maps every row to one row: the first rows of its output are those of its input.
+      const auto &projection_plan = dynamic_cast<const ProjectionPlanNode &>(*plan);
+      return plan->CloneWithChildren({HintLimit(projection_plan.GetChildPlan(), limit)});
+    }
+    case PlanType::SeqScan:
+      scan = LimitScan<SeqScanPlanNode>(plan, limit, nullptr);
+      break;
+    case PlanType::IndexScan:
+      scan = LimitScan<IndexScanPlanNode>(plan, limit, nullptr);
+      break;
+    case PlanType::Filter: {
+      // The filter moves into the scan, which counts the rows passing it.
+      const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*plan);
+      scan = LimitScan<SeqScanPlanNode>(filter_plan.GetChildPlan(), limit, filter_plan.GetPredicate());
+      if (scan == nullptr) {
+        scan = LimitScan<IndexScanPlanNode>(filter_plan.GetChildPlan(), limit, filter_plan.GetPredicate());
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return scan != nullptr ? scan : plan;
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeLimitPushdown(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeLimitPushdown(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::Limit) {
+    // The limit node stays and enforces the limit, the scan below only stops early. Nested limits keep the smallest.
+    const auto &limit_plan = dynamic_cast<const LimitPlanNode &>(*optimized_plan);
+    auto limit = limit_plan.GetLimit();
+    auto child = limit_plan.GetChildPlan();
+    while (child->GetType() == PlanType::Limit) {
+      const auto &child_limit_plan = dynamic_cast<const LimitPlanNode &>(*child);
+      limit = std::min(limit, child_limit_plan.GetLimit());
+      child = child_limit_plan.GetChildPlan();
+    }
+    return std::make_shared<LimitPlanNode>(limit_plan.output_schema_, HintLimit(child, limit), limit);
+  }
+  return optimized_plan;
+}
+
+}  // namespace bustub
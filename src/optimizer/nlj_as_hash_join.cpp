@@ -13,16 +13,53 @@
 #include "execution/plans/nested_loop_join_plan.h"
 #include "execution/plans/projection_plan.h"
 #include "optimizer/optimizer.h"
+#include "optimizer/optimizer_internal.h"
 #include "type/type_id.h"
 
 namespace bustub {
 
 auto Optimizer::OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
-  // TODO(student): implement NestedLoopJoin -> HashJoin optimizer rule
-  // Note for 2023 Spring: You should at least support join keys of the form:
-  // 1. <column expr> = <column expr>
-  // 2. <column expr> = <column expr> AND <column expr> = <column expr>
-  return plan;
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeNLJAsHashJoin(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::NestedLoopJoin) {
+    return optimized_plan;
+  }
+  // Inner joins pick their algorithm by cost when they are reordered. The other joins cannot take a residual
+  // predicate out of the join, so every conjunct has to be a key: `<left expr> = <right expr>`.
+  const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*optimized_plan);
+  if (nlj_plan.GetJoinType() == JoinType::INNER) {
+    return optimized_plan;
+  }
+  std::vector<AbstractExpressionRef> conjuncts;
+  SplitConjuncts(nlj_plan.Predicate(), &conjuncts);
+  std::vector<AbstractExpressionRef> left_keys;
+  std::vector<AbstractExpressionRef> right_keys;
+  for (const auto &conjunct : conjuncts) {
+    const auto *comparison = dynamic_cast<const ComparisonExpression *>(conjunct.get());
+    if (comparison == nullptr || comparison->comp_type_ != ComparisonType::Equal) {
+      return optimized_plan;
+    }
+    auto left_side = ReadTuples(comparison->GetChildAt(0));
+    auto right_side = ReadTuples(comparison->GetChildAt(1));
+    if (left_side == 1 && right_side == 2) {
+      left_keys.emplace_back(comparison->GetChildAt(0));
+      right_keys.emplace_back(comparison->GetChildAt(1));
+    } else if (left_side == 2 && right_side == 1) {
+      left_keys.emplace_back(comparison->GetChildAt(1));
+      right_keys.emplace_back(comparison->GetChildAt(0));
+    } else {
+      return optimized_plan;
+    }
+  }
+  if (left_keys.empty()) {
+    return optimized_plan;
+  }
+  return std::make_shared<HashJoinPlanNode>(nlj_plan.output_schema_, nlj_plan.GetLeftPlan(), nlj_plan.GetRightPlan(),
+                                            std::move(left_keys), std::move(right_keys), nlj_plan.GetJoinType());
 }
 
 }  // namespace bustub
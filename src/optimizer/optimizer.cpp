@@ -1,6 +1,10 @@
 #include "optimizer/optimizer.h"
 #include <optional>
 #include "common/util/string_util.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
 #include "execution/plans/abstract_plan.h"
 
 namespace bustub {
@@ -20,6 +24,10 @@ auto Optimizer::Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef
 }
 
 auto Optimizer::EstimatedCardinality(const std::string &table_name) -> std::optional<size_t> {
+  auto table_info = catalog_.GetTable(table_name);
+  if (table_info != nullptr && table_info->table_ != nullptr) {
+    return table_info->table_->GetRowCount();
+  }
   if (StringUtil::EndsWith(table_name, "_1m")) {
     return std::make_optional(1000000);
   }
@@ -41,4 +49,67 @@ auto Optimizer::EstimatedCardinality(const std::string &table_name) -> std::opti
   return std::nullopt;
 }
 
+auto Optimizer::EstimatedDistinctCount(const std::string &table_name, uint32_t col_idx) -> std::optional<size_t> {
+  auto table_info = catalog_.GetTable(table_name);
+  if (table_info == nullptr || table_info->statistics_ == nullptr) {
+    return std::nullopt;
+  }
+  return table_info->statistics_->GetColumnStatistics(col_idx).distinct_count_;
+}
+
+auto Optimizer::EstimateSelectivity(const std::string &table_name, const AbstractExpressionRef &predicate) -> double {
+  static constexpr double DEFAULT_EQUAL_SELECTIVITY = 0.1;
+  static constexpr double DEFAULT_SELECTIVITY = 1.0 / 3;
+
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(predicate.get()); logic != nullptr) {
+    auto left = EstimateSelectivity(table_name, logic->GetChildAt(0));
+    auto right = EstimateSelectivity(table_name, logic->GetChildAt(1));
+    return logic->logic_type_ == LogicType::And ? left * right : left + right - left * right;
+  }
+  if (const auto *constant = dynamic_cast<const ConstantValueExpression *>(predicate.get());
+      constant != nullptr && constant->val_.GetTypeId() == TypeId::BOOLEAN) {
+    return constant->val_.IsNull() || !constant->val_.GetAs<bool>() ? 0 : 1;
+  }
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(predicate.get());
+  if (comparison == nullptr) {
+    return DEFAULT_SELECTIVITY;
+  }
+  auto default_selectivity =
+      comparison->comp_type_ == ComparisonType::Equal ? DEFAULT_EQUAL_SELECTIVITY : DEFAULT_SELECTIVITY;
+
+  // Normalize `constant op column` to `column op' constant`.
+  auto comp_type = comparison->comp_type_;
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+  const auto *value = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1).get());
+  if (column == nullptr && value == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+    value = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0).get());
+    switch (comp_type) {
+      case ComparisonType::LessThan:
+        comp_type = ComparisonType::GreaterThan;
+        break;
+      case ComparisonType::LessThanOrEqual:
+        comp_type = ComparisonType::GreaterThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+        comp_type = ComparisonType::LessThan;
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        comp_type = ComparisonType::LessThanOrEqual;
+        break;
+      default:
+        break;
+    }
+  }
+  if (column == nullptr || value == nullptr) {
+    return default_selectivity;
+  }
+
+  auto table_info = catalog_.GetTable(table_name);
+  if (table_info == nullptr || table_info->statistics_ == nullptr) {
+    return default_selectivity;
+  }
+  return table_info->statistics_->GetColumnStatistics(column->GetColIdx()).EstimateSelectivity(comp_type, value->val_);
+}
+
 }  // namespace bustub
@@ -10,10 +10,20 @@ namespace bustub {
 auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
   auto p = plan;
   p = OptimizeMergeProjection(p);
+  p = OptimizeSimplifyExpressions(p);
+  p = OptimizePredicatePushdown(p);
   p = OptimizeMergeFilterNLJ(p);
+  p = OptimizeJoinOrder(p);
   p = OptimizeNLJAsHashJoin(p);
+  p = OptimizeFilterAsIndexScan(p);
   p = OptimizeOrderByAsIndexScan(p);
+  p = OptimizeLimitPushdown(p);
   p = OptimizeSortLimitAsTopN(p);
+  p = OptimizeColumnPruning(p);
+  // The rules above build new filters: order their operands again.
+  p = OptimizeSimplifyExpressions(p);
+  p = OptimizeCommonSubexpressions(p);
+  p = OptimizeMergeProjection(p);
   return p;
 }
 
@@ -1,5 +1,72 @@
+#include "optimizer/optimizer_internal.h"
+
+#include <memory>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "type/value_factory.h"
+
 namespace bustub {
 
 void OptimizerHelperFunction() {}
 
+auto MapColumns(const AbstractExpressionRef &expr, const ColumnMapping &mapping) -> AbstractExpressionRef {
+  std::vector<AbstractExpressionRef> children;
+  for (const auto &child : expr->GetChildren()) {
+    children.emplace_back(MapColumns(child, mapping));
+  }
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get()); column != nullptr) {
+    auto [tuple_idx, col_idx] = mapping(column->GetTupleIdx(), column->GetColIdx());
+    return std::make_shared<ColumnValueExpression>(tuple_idx, col_idx, column->GetReturnType());
+  }
+  return expr->CloneWithChildren(std::move(children));
+}
+
+void CollectColumns(const AbstractExpressionRef &expr, std::vector<uint32_t> *columns) {
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get()); column != nullptr) {
+    columns->emplace_back(column->GetColIdx());
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+auto ReadTuples(const AbstractExpressionRef &expr) -> uint32_t {
+  uint32_t tuples = 0;
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get()); column != nullptr) {
+    tuples |= 1U << column->GetTupleIdx();
+  }
+  for (const auto &child : expr->GetChildren()) {
+    tuples |= ReadTuples(child);
+  }
+  return tuples;
+}
+
+void SplitConjuncts(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *conjuncts) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get());
+      logic != nullptr && logic->logic_type_ == LogicType::And) {
+    SplitConjuncts(logic->GetChildAt(0), conjuncts);
+    SplitConjuncts(logic->GetChildAt(1), conjuncts);
+    return;
+  }
+  if (const auto *constant = dynamic_cast<const ConstantValueExpression *>(expr.get());
+      constant != nullptr && constant->val_.GetTypeId() == TypeId::BOOLEAN && !constant->val_.IsNull() &&
+      constant->val_.GetAs<bool>()) {
+    return;
+  }
+  conjuncts->emplace_back(expr);
+}
+
+auto MakeConjunction(const std::vector<AbstractExpressionRef> &conjuncts) -> AbstractExpressionRef {
+  if (conjuncts.empty()) {
+    return std::make_shared<ConstantValueExpression>(ValueFactory::GetBooleanValue(true));
+  }
+  auto expr = conjuncts[0];
+  for (size_t i = 1; i < conjuncts.size(); i++) {
+    expr = std::make_shared<LogicExpression>(expr, conjuncts[i], LogicType::And);
+  }
+  return expr;
+}
+
 }  // namespace bustub
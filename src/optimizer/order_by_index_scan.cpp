@@ -1,5 +1,7 @@
 #include <algorithm>
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "binder/bound_order_by.h"
 #include "catalog/catalog.h"
@@ -21,6 +23,29 @@
 
 namespace bustub {
 
+namespace {
+
+/**
+ * @return whether a scan of an index returns its tuples in the order of the columns: they are, ignoring the key columns
+ * fixed by the first `fixed` key values, a prefix of the key columns after them
+ */
+auto IndexOrders(const std::vector<uint32_t> &key_attrs, size_t fixed, const std::vector<uint32_t> &order_by_column_ids)
+    -> bool {
+  size_t key_idx = fixed;
+  for (auto col_idx : order_by_column_ids) {
+    if (std::find(key_attrs.begin(), key_attrs.begin() + fixed, col_idx) != key_attrs.begin() + fixed) {
+      continue;
+    }
+    if (key_idx == key_attrs.size() || key_attrs[key_idx] != col_idx) {
+      return false;
+    }
+    key_idx++;
+  }
+  return true;
+}
+
+}  // namespace
+
 auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
   std::vector<AbstractPlanNodeRef> children;
   for (const auto &child : plan->GetChildren()) {
@@ -52,28 +77,33 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
     BUSTUB_ENSURE(optimized_plan->children_.size() == 1, "Sort with multiple children?? Impossible!");
     const auto &child_plan = optimized_plan->children_[0];
 
-    if (child_plan->GetType() == PlanType::SeqScan) {
-      const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
+    // A filter keeps the order of its input: the scan below it can produce the order instead.
+    const auto *filter_plan = dynamic_cast<const FilterPlanNode *>(child_plan.get());
+    const auto &scan_plan = filter_plan != nullptr ? filter_plan->GetChildPlan() : child_plan;
+
+    if (scan_plan->GetType() == PlanType::SeqScan) {
+      const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*scan_plan);
       const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
       const auto indices = catalog_.GetTableIndexes(table_info->name_);
 
       for (const auto *index : indices) {
-        const auto &columns = index->key_schema_.GetColumns();
-        // check index key schema == order by columns
-        bool valid = true;
-        if (columns.size() == order_by_column_ids.size()) {
-          for (size_t i = 0; i < columns.size(); i++) {
-            if (columns[i].GetName() != table_info->schema_.GetColumn(order_by_column_ids[i]).GetName()) {
-              valid = false;
-              break;
-            }
-          }
-          if (valid) {
-            return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_);
-          }
+        if (IndexOrders(index->index_->GetKeyAttrs(), 0, order_by_column_ids)) {
+          AbstractPlanNodeRef index_scan = std::make_shared<IndexScanPlanNode>(
+              seq_scan.output_schema_, index->index_oid_, std::vector<AbstractExpressionRef>{}, std::nullopt,
+              std::nullopt, seq_scan.filter_predicate_);
+          return filter_plan != nullptr ? filter_plan->CloneWithChildren({index_scan}) : index_scan;
         }
       }
     }
+
+    if (scan_plan->GetType() == PlanType::IndexScan) {
+      // The index scan already returns the key range in key order.
+      const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*scan_plan);
+      const auto *index = catalog_.GetIndex(index_scan.GetIndexOid());
+      if (IndexOrders(index->index_->GetKeyAttrs(), index_scan.key_prefix_.size(), order_by_column_ids)) {
+        return child_plan;
+      }
+    }
   }
 
   return optimized_plan;
@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/nested_index_join_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/optimizer_internal.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return whether every column the expression reads is in [begin, end) */
+auto ReadsOnly(const AbstractExpressionRef &expr, uint32_t begin, uint32_t end) -> bool {
+  std::vector<uint32_t> columns;
+  CollectColumns(expr, &columns);
+  return std::all_of(columns.begin(), columns.end(),
+                     [&](uint32_t col_idx) { return col_idx >= begin && col_idx < end; });
+}
+
+/** Replace every column reference by the expression that computes the column below. */
+auto Substitute(const AbstractExpressionRef &expr, const std::vector<AbstractExpressionRef> &columns)
+    -> AbstractExpressionRef {
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get()); column != nullptr) {
+    return columns[column->GetColIdx()];
+  }
+  std::vector<AbstractExpressionRef> children;
+  for (const auto &child : expr->GetChildren()) {
+    children.emplace_back(Substitute(child, columns));
+  }
+  return expr->CloneWithChildren(std::move(children));
+}
+
+auto ShiftLeft(const AbstractExpressionRef &expr, uint32_t offset) -> AbstractExpressionRef {
+  return MapColumns(expr, [&](uint32_t, uint32_t col_idx) -> std::pair<uint32_t, uint32_t> {
+    return {0, col_idx - offset};
+  });
+}
+
+/** Put the conjuncts that cannot be pushed any further in a filter over the plan. */
+auto AddFilter(const AbstractPlanNodeRef &plan, const std::vector<AbstractExpressionRef> &conjuncts)
+    -> AbstractPlanNodeRef {
+  if (conjuncts.empty()) {
+    return plan;
+  }
+  return std::make_shared<FilterPlanNode>(plan->output_schema_, MakeConjunction(conjuncts), plan);
+}
+
+/** Push conjuncts over the output of plan as far down into it as they can go. */
+auto PushDown(const AbstractPlanNodeRef &plan, std::vector<AbstractExpressionRef> conjuncts) -> AbstractPlanNodeRef {
+  switch (plan->GetType()) {
+    case PlanType::Filter: {
+      SplitConjuncts(dynamic_cast<const FilterPlanNode &>(*plan).GetPredicate(), &conjuncts);
+      return PushDown(plan->GetChildAt(0), std::move(conjuncts));
+    }
+    case PlanType::Projection: {
+      // Subqueries are planned as projections, a conjunct goes through by computing the columns it reads below.
+      const auto &projection = dynamic_cast<const ProjectionPlanNode &>(*plan);
+      std::vector<AbstractExpressionRef> pushed;
+      for (const auto &conjunct : conjuncts) {
+        pushed.emplace_back(Substitute(conjunct, projection.GetExpressions()));
+      }
+      return plan->CloneWithChildren({PushDown(plan->GetChildAt(0), std::move(pushed))});
+    }
+    case PlanType::Sort:
+      return plan->CloneWithChildren({PushDown(plan->GetChildAt(0), std::move(conjuncts))});
+    case PlanType::Aggregation: {
+      // Conjuncts over group keys only keep or drop whole groups, they can filter the rows before grouping. Without
+      // group keys, the single output row exists even for an empty input, so nothing goes through.
+      const auto &aggregation = dynamic_cast<const AggregationPlanNode &>(*plan);
+      auto group_count = aggregation.GetGroupBys().size();
+      std::vector<AbstractExpressionRef> pushed;
+      std::vector<AbstractExpressionRef> kept;
+      for (const auto &conjunct : conjuncts) {
+        if (group_count != 0 && ReadsOnly(conjunct, 0, group_count)) {
+          pushed.emplace_back(Substitute(conjunct, aggregation.GetGroupBys()));
+        } else {
+          kept.emplace_back(conjunct);
+        }
+      }
+      return AddFilter(plan->CloneWithChildren({PushDown(plan->GetChildAt(0), std::move(pushed))}), kept);
+    }
+    case PlanType::NestedLoopJoin: {
+      const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*plan);
+      auto join_type = nlj_plan.GetJoinType();
+      if (join_type != JoinType::INNER && join_type != JoinType::LEFT && join_type != JoinType::SEMI &&
+          join_type != JoinType::ANTI) {
+        break;
+      }
+      bool inner = join_type == JoinType::INNER;
+      // Whether a left row failing the predicate is dropped, so that its conjuncts over the left side filter it first.
+      bool drops_unmatched = inner || join_type == JoinType::SEMI;
+      auto left_width = nlj_plan.GetLeftPlan()->OutputSchema().GetColumnCount();
+      auto width = plan->OutputSchema().GetColumnCount();
+      std::vector<AbstractExpressionRef> left;
+      std::vector<AbstractExpressionRef> right;
+      std::vector<AbstractExpressionRef> join;
+      std::vector<AbstractExpressionRef> kept;
+      // Conjuncts above the join: for a left join, only those over the left side go through, as the rows it pads
+      // with nulls have to meet the others too. Semi and anti joins only output the left side.
+      for (const auto &conjunct : conjuncts) {
+        if (ReadsOnly(conjunct, 0, left_width)) {
+          left.emplace_back(conjunct);
+        } else if (inner && ReadsOnly(conjunct, left_width, width)) {
+          right.emplace_back(ShiftLeft(conjunct, left_width));
+        } else if (inner) {
+          join.emplace_back(MapColumns(conjunct, [&](uint32_t, uint32_t col_idx) -> std::pair<uint32_t, uint32_t> {
+            return col_idx < left_width ? std::make_pair(0U, col_idx) : std::make_pair(1U, col_idx - left_width);
+          }));
+        } else {
+          kept.emplace_back(conjunct);
+        }
+      }
+      // Conjuncts of the join predicate: for left and anti joins, only those over the right side go down, a left row
+      // that fails the others is still returned.
+      std::vector<AbstractExpressionRef> own;
+      SplitConjuncts(nlj_plan.Predicate(), &own);
+      for (const auto &conjunct : own) {
+        auto tuples = ReadTuples(conjunct);
+        auto to_single = [](uint32_t, uint32_t col_idx) -> std::pair<uint32_t, uint32_t> { return {0, col_idx}; };
+        if (drops_unmatched && tuples == 1) {
+          left.emplace_back(MapColumns(conjunct, to_single));
+        } else if (tuples == 2) {
+          right.emplace_back(MapColumns(conjunct, to_single));
+        } else {
+          join.emplace_back(conjunct);
+        }
+      }
+      auto joined = std::make_shared<NestedLoopJoinPlanNode>(
+          nlj_plan.output_schema_, PushDown(nlj_plan.GetLeftPlan(), std::move(left)),
+          PushDown(nlj_plan.GetRightPlan(), std::move(right)), MakeConjunction(join), join_type);
+      return AddFilter(joined, kept);
+    }
+    case PlanType::HashJoin: {
+      const auto &hash_join = dynamic_cast<const HashJoinPlanNode &>(*plan);
+      if (hash_join.GetJoinType() != JoinType::INNER && hash_join.GetJoinType() != JoinType::LEFT &&
+          hash_join.GetJoinType() != JoinType::SEMI && hash_join.GetJoinType() != JoinType::ANTI) {
+        break;
+      }
+      auto left_width = hash_join.GetLeftPlan()->OutputSchema().GetColumnCount();
+      auto width = plan->OutputSchema().GetColumnCount();
+      std::vector<AbstractExpressionRef> left;
+      std::vector<AbstractExpressionRef> right;
+      std::vector<AbstractExpressionRef> kept;
+      for (const auto &conjunct : conjuncts) {
+        if (ReadsOnly(conjunct, 0, left_width)) {
+          left.emplace_back(conjunct);
+        } else if (hash_join.GetJoinType() == JoinType::INNER && ReadsOnly(conjunct, left_width, width)) {
+          right.emplace_back(ShiftLeft(conjunct, left_width));
+        } else {
+          kept.emplace_back(conjunct);
+        }
+      }
+      return AddFilter(plan->CloneWithChildren({PushDown(hash_join.GetLeftPlan(), std::move(left)),
+                                                PushDown(hash_join.GetRightPlan(), std::move(right))}),
+                       kept);
+    }
+    case PlanType::NestedIndexJoin: {
+      // The inner side is looked up in the index, only the outer side can be filtered first.
+      auto outer_width = plan->GetChildAt(0)->OutputSchema().GetColumnCount();
+      std::vector<AbstractExpressionRef> outer;
+      std::vector<AbstractExpressionRef> kept;
+      for (const auto &conjunct : conjuncts) {
+        (ReadsOnly(conjunct, 0, outer_width) ? outer : kept).emplace_back(conjunct);
+      }
+      return AddFilter(plan->CloneWithChildren({PushDown(plan->GetChildAt(0), std::move(outer))}), kept);
+    }
+    default:
+      break;
+  }
+
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(PushDown(child, {}));
+  }
+  return AddFilter(plan->CloneWithChildren(std::move(children)), conjuncts);
+}
+
+}  // namespace
+
+auto Optimizer::OptimizePredicatePushdown(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  return PushDown(plan, {});
+}
+
+}  // namespace bustub
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/expressions/parameter_value_expression.h"
+#include "execution/expressions/string_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/values_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** Evaluating a string function copies its argument into a new string. */
+constexpr double STRING_FUNCTION_COST = 10;
+
+/** @return the constant value of an expression, nullptr if it is not a constant */
+auto AsConstant(const AbstractExpressionRef &expr) -> const Value * {
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(expr.get());
+  return constant == nullptr ? nullptr : &constant->val_;
+}
+
+/** @return whether the expression is the boolean constant value */
+auto IsBoolean(const AbstractExpressionRef &expr, bool value) -> bool {
+  const auto *val = AsConstant(expr);
+  return val != nullptr && val->GetTypeId() == TypeId::BOOLEAN && !val->IsNull() && val->GetAs<bool>() == value;
+}
+
+/** @return the rough cost of evaluating an expression once, in units of a column read or a comparison */
+auto ExpressionCost(const AbstractExpressionRef &expr) -> double {
+  double cost = expr->GetChildren().empty() ? 1 : 0;
+  if (dynamic_cast<const StringExpression *>(expr.get()) != nullptr) {
+    cost += STRING_FUNCTION_COST;
+  } else if (dynamic_cast<const LogicExpression *>(expr.get()) == nullptr && !expr->GetChildren().empty()) {
+    cost += 1;
+  }
+  for (const auto &child : expr->GetChildren()) {
+    cost += ExpressionCost(child);
+  }
+  return cost;
+}
+
+/** Append the operands of a tree of logic expressions of one type to operands. */
+void SplitOperands(const AbstractExpressionRef &expr, LogicType logic_type,
+                   std::vector<AbstractExpressionRef> *operands) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get());
+      logic != nullptr && logic->logic_type_ == logic_type) {
+    SplitOperands(logic->GetChildAt(0), logic_type, operands);
+    SplitOperands(logic->GetChildAt(1), logic_type, operands);
+    return;
+  }
+  operands->emplace_back(expr);
+}
+
+}  // namespace
+
+auto Optimizer::SimplifyExpression(const AbstractExpressionRef &expr, const std::string &table_name)
+    -> AbstractExpressionRef {
+  if (const auto *parameter = dynamic_cast<const ParameterValueExpression *>(expr.get()); parameter != nullptr) {
+    depends_on_parameters_ = true;
+    const auto *values = ParameterBinding::Current();
+    if (values != nullptr && parameter->param_idx_ < values->size()) {
+      return std::make_shared<ConstantValueExpression>((*values)[parameter->param_idx_]);
+    }
+    return expr;
+  }
+
+  std::vector<AbstractExpressionRef> children;
+  bool all_constant = true;
+  for (const auto &child : expr->GetChildren()) {
+    children.emplace_back(SimplifyExpression(child, table_name));
+    all_constant = all_constant && AsConstant(children.back()) != nullptr;
+  }
+
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get()); logic != nullptr) {
+    // `false AND x` is false and `true AND x` is x whatever x is (even NULL); the same goes for OR the other way.
+    auto absorbing = logic->logic_type_ == LogicType::Or;
+    std::vector<AbstractExpressionRef> operands;
+    for (const auto &child : children) {
+      SplitOperands(child, logic->logic_type_, &operands);
+    }
+    std::vector<std::pair<double, AbstractExpressionRef>> ranked;
+    for (auto &operand : operands) {
+      if (IsBoolean(operand, absorbing)) {
+        return operand;
+      }
+      if (IsBoolean(operand, !absorbing)) {
+        continue;
+      }
+      // Short-circuit evaluation stops at the first operand deciding the result: put first the operands that are
+      // cheap and likely to decide it. The expected cost is lowest in the increasing order of
+      // cost / P(operand decides).
+      auto selectivity = EstimateSelectivity(table_name, operand);
+      auto decides = absorbing ? selectivity : 1 - selectivity;
+      auto rank = decides > 0 ? ExpressionCost(operand) / decides : std::numeric_limits<double>::infinity();
+      ranked.emplace_back(rank, std::move(operand));
+    }
+    if (ranked.empty()) {
+      return std::make_shared<ConstantValueExpression>(ValueFactory::GetBooleanValue(!absorbing));
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    auto result = std::move(ranked[0].second);
+    bool all_null = AsConstant(result) != nullptr;
+    for (size_t i = 1; i < ranked.size(); i++) {
+      all_null = all_null && AsConstant(ranked[i].second) != nullptr;
+      result = std::make_shared<LogicExpression>(std::move(result), std::move(ranked[i].second), logic->logic_type_);
+    }
+    // Only NULL operands are left.
+    return all_null ? std::make_shared<ConstantValueExpression>(ValueFactory::GetBooleanValue(CmpBool::CmpNull))
+                    : result;
+  }
+
+  auto simplified = expr->CloneWithChildren(std::move(children));
+  // Fold the expressions over constants, but not the leaves: columns and unbound parameters only have a value at
+  // execution.
+  if (simplified->GetChildren().empty() || !all_constant) {
+    return simplified;
+  }
+  if (const auto *string_expr = dynamic_cast<const StringExpression *>(simplified.get()); string_expr != nullptr) {
+    if (AsConstant(string_expr->GetChildAt(0))->IsNull()) {
+      return std::make_shared<ConstantValueExpression>(ValueFactory::GetNullValueByType(TypeId::VARCHAR));
+    }
+  }
+  try {
+    return std::make_shared<ConstantValueExpression>(simplified->Evaluate(nullptr, Schema(std::vector<Column>{})));
+  } catch (const Exception &e) {
+    // Leave the error to the execution, which may never evaluate the expression.
+    return simplified;
+  }
+}
+
+auto Optimizer::OptimizeSimplifyExpressions(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSimplifyExpressions(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+  auto simplify = [this](AbstractExpressionRef *expr, const std::string &table_name = "") {
+    *expr = SimplifyExpression(*expr, table_name);
+  };
+
+  switch (optimized_plan->GetType()) {
+    case PlanType::Filter: {
+      auto &filter_plan = dynamic_cast<FilterPlanNode &>(*optimized_plan);
+      // The statistics of the table give the selectivities of the conjuncts of a filter over its scan.
+      std::string table_name;
+      if (const auto *seq_scan = dynamic_cast<const SeqScanPlanNode *>(filter_plan.GetChildPlan().get());
+          seq_scan != nullptr) {
+        table_name = seq_scan->table_name_;
+      }
+      simplify(&filter_plan.predicate_, table_name);
+      if (IsBoolean(filter_plan.predicate_, true)) {
+        return filter_plan.GetChildPlan();
+      }
+      if (AsConstant(filter_plan.predicate_) != nullptr) {
+        // False or NULL: no row passes.
+        return std::make_shared<ValuesPlanNode>(filter_plan.output_schema_,
+                                                std::vector<std::vector<AbstractExpressionRef>>{});
+      }
+      break;
+    }
+    case PlanType::SeqScan: {
+      auto &seq_scan = dynamic_cast<SeqScanPlanNode &>(*optimized_plan);
+      if (seq_scan.filter_predicate_ != nullptr) {
+        simplify(&seq_scan.filter_predicate_, seq_scan.table_name_);
+        if (IsBoolean(seq_scan.filter_predicate_, true)) {
+          seq_scan.filter_predicate_ = nullptr;
+        }
+      }
+      break;
+    }
+    case PlanType::NestedLoopJoin:
+      simplify(&dynamic_cast<NestedLoopJoinPlanNode &>(*optimized_plan).predicate_);
+      break;
+    case PlanType::Projection:
+      for (auto &expr : dynamic_cast<ProjectionPlanNode &>(*optimized_plan).expressions_) {
+        simplify(&expr);
+      }
+      break;
+    case PlanType::Aggregation: {
+      auto &agg_plan = dynamic_cast<AggregationPlanNode &>(*optimized_plan);
+      for (auto &expr : agg_plan.group_bys_) {
+        simplify(&expr);
+      }
+      for (auto &expr : agg_plan.aggregates_) {
+        simplify(&expr);
+      }
+      break;
+    }
+    case PlanType::Sort:
+      for (auto &[_, expr] : dynamic_cast<SortPlanNode &>(*optimized_plan).order_bys_) {
+        simplify(&expr);
+      }
+      break;
+    default:
+      break;
+  }
+  return optimized_plan;
+}
+
+}  // namespace bustub
@@ -47,7 +47,8 @@ auto Planner::PlanAggCall(const BoundAggCall &agg_call, const std::vector<Abstra
 // TODO(chi): clang-tidy on macOS will suggest changing it to const reference. Looks like a bug.
 
 /* NOLINTNEXTLINE */
-auto Planner::PlanSelectAgg(const SelectStatement &statement, AbstractPlanNodeRef child) -> AbstractPlanNodeRef {
+auto Planner::PlanSelectAgg(const SelectStatement &statement, AbstractPlanNodeRef child,
+                            std::vector<AbstractExpressionRef> correlation_keys) -> AbstractPlanNodeRef {
   /* Transforming hash agg is complex. Let's see a concrete example here.
    *
    * Now that we have,
@@ -85,6 +86,11 @@ auto Planner::PlanSelectAgg(const SelectStatement &statement, AbstractPlanNodeRe
   std::vector<AbstractExpressionRef> group_by_exprs;
   std::vector<std::string> output_col_names;
 
+  for (size_t i = 0; i < correlation_keys.size(); i++) {
+    group_by_exprs.emplace_back(std::move(correlation_keys[i]));
+    output_col_names.emplace_back(fmt::format("__correlation#{}", i));
+  }
+
   for (const auto &expr : statement.group_by_) {
     auto [col_name, abstract_expr] = PlanExpression(*expr, {child});
     group_by_exprs.emplace_back(std::move(abstract_expr));
@@ -151,6 +157,10 @@ auto Planner::PlanSelectAgg(const SelectStatement &statement, AbstractPlanNodeRe
   std::vector<AbstractExpressionRef> exprs;
   std::vector<std::string> final_output_col_names;
   std::vector<AbstractPlanNodeRef> children = {plan};
+  for (size_t i = 0; i < correlation_keys.size(); i++) {
+    exprs.emplace_back(std::make_shared<ColumnValueExpression>(0, i, plan->OutputSchema().GetColumn(i).GetType()));
+    final_output_col_names.emplace_back(plan->OutputSchema().GetColumn(i).GetName());
+  }
   for (const auto &item : statement.select_list_) {
     auto [name, expr] = PlanExpression(*item, {plan});
     exprs.push_back(std::move(expr));
@@ -0,0 +1,190 @@
+#include "planner/plan_cache.h"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/binder.h"
+#include "binder/simplified_token.h"
+#include "common/util/string_util.h"
+#include "fmt/format.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the integer value of a numeric literal, nullopt if it is not an integer the binder would bind as one */
+auto ParseInteger(const std::string &text, bool negative) -> std::optional<int32_t> {
+  if (text.empty() || text.size() > 10) {
+    return std::nullopt;
+  }
+  int64_t value = 0;
+  for (char c : text) {
+    if (c < '0' || c > '9') {
+      return std::nullopt;
+    }
+    value = value * 10 + (c - '0');
+  }
+  value = negative ? -value : value;
+  if (value < BUSTUB_INT32_MIN || value > BUSTUB_INT32_MAX) {
+    return std::nullopt;
+  }
+  return static_cast<int32_t>(value);
+}
+
+/** @return the value of a string literal, nullopt if it is not a plain quoted string */
+auto ParseString(const std::string &text) -> std::optional<std::string> {
+  if (text.size() < 2 || text.front() != '\'' || text.back() != '\'') {
+    return std::nullopt;
+  }
+  auto quoted = text.substr(1, text.size() - 2);
+  std::string value;
+  for (size_t i = 0; i < quoted.size(); i++) {
+    if (quoted[i] == '\'') {
+      // A quote inside the literal is escaped by doubling it.
+      if (i + 1 == quoted.size() || quoted[i + 1] != '\'') {
+        return std::nullopt;
+      }
+      i++;
+    }
+    value += quoted[i];
+  }
+  return value;
+}
+
+}  // namespace
+
+auto ParameterizeQuery(const std::string &sql) -> std::optional<ParameterizedQuery> {
+  auto tokens = Binder::Tokenize(sql);
+  std::vector<std::pair<SimplifiedTokenType, std::string>> texts;
+  for (size_t i = 0; i < tokens.size(); i++) {
+    auto end = i + 1 < tokens.size() ? static_cast<size_t>(tokens[i + 1].start_) : sql.size();
+    auto text = sql.substr(tokens[i].start_, end - tokens[i].start_);
+    // The tokenizer skips comments: cut the one that may follow the token.
+    if (tokens[i].type_ != SimplifiedTokenType::SIMPLIFIED_TOKEN_STRING_CONSTANT) {
+      text = text.substr(0, std::min(text.find("--"), text.find("/*")));
+    }
+    StringUtil::RTrim(&text);
+    if (tokens[i].type_ != SimplifiedTokenType::SIMPLIFIED_TOKEN_COMMENT) {
+      texts.emplace_back(tokens[i].type_, std::move(text));
+    }
+  }
+  if (!texts.empty() && texts.back().second == ";") {
+    texts.pop_back();
+  }
+  if (texts.empty() || texts.front().first != SimplifiedTokenType::SIMPLIFIED_TOKEN_KEYWORD) {
+    return std::nullopt;
+  }
+  auto command = StringUtil::Lower(texts.front().second);
+  if (command != "select" && command != "insert" && command != "update" && command != "delete" && command != "with") {
+    return std::nullopt;
+  }
+
+  ParameterizedQuery result;
+  for (size_t i = 0; i < texts.size(); i++) {
+    const auto &[type, text] = texts[i];
+    // Several statements, or parameters of the query's own.
+    if ((type == SimplifiedTokenType::SIMPLIFIED_TOKEN_OPERATOR && text == ";") || text.front() == '$') {
+      return std::nullopt;
+    }
+    if (!result.query_.empty()) {
+      result.query_ += ' ';
+    }
+
+    // The parser folds a minus sign before a number into the constant, where it cannot be a binary minus.
+    bool negative = false;
+    if (type == SimplifiedTokenType::SIMPLIFIED_TOKEN_OPERATOR && text == "-" && i + 1 < texts.size() &&
+        texts[i + 1].first == SimplifiedTokenType::SIMPLIFIED_TOKEN_NUMERIC_CONSTANT &&
+        (i == 0 || texts[i - 1].first == SimplifiedTokenType::SIMPLIFIED_TOKEN_KEYWORD ||
+         (texts[i - 1].first == SimplifiedTokenType::SIMPLIFIED_TOKEN_OPERATOR && texts[i - 1].second != ")"))) {
+      negative = true;
+    }
+    const auto &literal_type = negative ? texts[i + 1].first : type;
+    const auto &literal_text = negative ? texts[i + 1].second : text;
+
+    // The planner needs the counts of LIMIT and OFFSET as constants.
+    bool keep_literal = i > 0 && texts[i - 1].first == SimplifiedTokenType::SIMPLIFIED_TOKEN_KEYWORD &&
+                        (StringUtil::Lower(texts[i - 1].second) == "limit" ||
+                         StringUtil::Lower(texts[i - 1].second) == "offset");
+
+    std::optional<Value> literal;
+    if (literal_type == SimplifiedTokenType::SIMPLIFIED_TOKEN_NUMERIC_CONSTANT && !keep_literal) {
+      if (auto value = ParseInteger(literal_text, negative); value.has_value()) {
+        literal = ValueFactory::GetIntegerValue(*value);
+      }
+    } else if (literal_type == SimplifiedTokenType::SIMPLIFIED_TOKEN_STRING_CONSTANT) {
+      if (auto value = ParseString(literal_text); value.has_value()) {
+        literal = ValueFactory::GetVarcharValue(*value);
+      }
+    }
+
+    if (literal.has_value()) {
+      result.parameters_.emplace_back(std::move(*literal));
+      result.query_ += fmt::format("${}", result.parameters_.size());
+      i += negative ? 1 : 0;
+    } else if (type == SimplifiedTokenType::SIMPLIFIED_TOKEN_KEYWORD) {
+      result.query_ += StringUtil::Lower(text);
+    } else {
+      result.query_ += text;
+    }
+  }
+  return result;
+}
+
+auto PlanCache::MakeKey(const std::string &query, const std::vector<TypeId> &parameter_types) -> std::string {
+  auto key = query;
+  key += '\0';
+  for (auto type : parameter_types) {
+    key += static_cast<char>(type);
+  }
+  return key;
+}
+
+auto PlanCache::Get(const std::string &query, const std::vector<TypeId> &parameter_types, uint64_t catalog_version)
+    -> std::shared_ptr<const CachedPlan> {
+  std::scoped_lock lock(latch_);
+  auto it = index_.find(MakeKey(query, parameter_types));
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  if (it->second->catalog_version_ != catalog_version) {
+    entries_.erase(it->second);
+    index_.erase(it);
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->plan_;
+}
+
+void PlanCache::Put(const std::string &query, const std::vector<TypeId> &parameter_types, uint64_t catalog_version,
+                    std::shared_ptr<const CachedPlan> plan) {
+  auto key = MakeKey(query, parameter_types);
+  std::scoped_lock lock(latch_);
+  if (auto it = index_.find(key); it != index_.end()) {
+    entries_.erase(it->second);
+    index_.erase(it);
+  }
+  entries_.push_front(Entry{key, catalog_version, std::move(plan)});
+  index_.emplace(std::move(key), entries_.begin());
+  while (entries_.size() > capacity_) {
+    index_.erase(entries_.back().key_);
+    entries_.pop_back();
+  }
+}
+
+void PlanCache::Clear() {
+  std::scoped_lock lock(latch_);
+  entries_.clear();
+  index_.clear();
+}
+
+auto PlanCache::Size() -> size_t {
+  std::scoped_lock lock(latch_);
+  return entries_.size();
+}
+
+}  // namespace bustub
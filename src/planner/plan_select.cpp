@@ -52,9 +52,7 @@ auto Planner::PlanSelect(const SelectStatement &statement) -> AbstractPlanNodeRe
   }
 
   if (!statement.where_->IsInvalid()) {
-    auto schema = plan->OutputSchema();
-    auto [_, expr] = PlanExpression(*statement.where_, {plan});
-    plan = std::make_shared<FilterPlanNode>(std::make_shared<Schema>(schema), std::move(expr), std::move(plan));
+    plan = PlanWhere({statement.where_.get()}, std::move(plan));
   }
 
   bool has_agg = false;
@@ -72,6 +70,9 @@ auto Planner::PlanSelect(const SelectStatement &statement) -> AbstractPlanNodeRe
     // Plan normal select
     std::vector<AbstractExpressionRef> exprs;
     std::vector<std::string> column_names;
+    for (const auto &item : statement.select_list_) {
+      plan = PlanScalarSubqueries(*item, std::move(plan));
+    }
     std::vector<AbstractPlanNodeRef> children = {plan};
     for (const auto &item : statement.select_list_) {
       auto [name, expr] = PlanExpression(*item, {plan});
@@ -0,0 +1,458 @@
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_expression.h"
+#include "binder/bound_order_by.h"
+#include "binder/bound_table_ref.h"
+#include "binder/expressions/bound_agg_call.h"
+#include "binder/expressions/bound_alias.h"
+#include "binder/expressions/bound_binary_op.h"
+#include "binder/expressions/bound_column_ref.h"
+#include "binder/expressions/bound_func_call.h"
+#include "binder/expressions/bound_subquery_expr.h"
+#include "binder/expressions/bound_unary_op.h"
+#include "binder/statement/select_statement.h"
+#include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/values_plan.h"
+#include "fmt/format.h"
+#include "planner/planner.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** Collect the names of the columns an expression reads. The columns read inside a subquery are not collected. */
+void CollectColumnNames(const BoundExpression &expr, std::vector<std::string> *names) {
+  switch (expr.type_) {
+    case ExpressionType::COLUMN_REF:
+      names->emplace_back(expr.ToString());
+      return;
+    case ExpressionType::BINARY_OP: {
+      const auto &binary_op = dynamic_cast<const BoundBinaryOp &>(expr);
+      CollectColumnNames(*binary_op.larg_, names);
+      CollectColumnNames(*binary_op.rarg_, names);
+      return;
+    }
+    case ExpressionType::UNARY_OP:
+      CollectColumnNames(*dynamic_cast<const BoundUnaryOp &>(expr).arg_, names);
+      return;
+    case ExpressionType::FUNC_CALL:
+      for (const auto &arg : dynamic_cast<const BoundFuncCall &>(expr).args_) {
+        CollectColumnNames(*arg, names);
+      }
+      return;
+    case ExpressionType::AGG_CALL:
+      for (const auto &arg : dynamic_cast<const BoundAggCall &>(expr).args_) {
+        CollectColumnNames(*arg, names);
+      }
+      return;
+    case ExpressionType::ALIAS:
+      CollectColumnNames(*dynamic_cast<const BoundAlias &>(expr).child_, names);
+      return;
+    case ExpressionType::SUBQUERY: {
+      const auto &subquery = dynamic_cast<const BoundSubqueryExpr &>(expr);
+      if (subquery.arg_ != nullptr) {
+        CollectColumnNames(*subquery.arg_, names);
+      }
+      return;
+    }
+    default:
+      return;
+  }
+}
+
+/** @return the names of the columns of a plan's output */
+auto ColumnNames(const AbstractPlanNode &plan) -> std::unordered_set<std::string> {
+  std::unordered_set<std::string> names;
+  for (const auto &column : plan.OutputSchema().GetColumns()) {
+    names.emplace(column.GetName());
+  }
+  return names;
+}
+
+/** @return whether an expression only reads the given columns */
+auto ReadsOnly(const BoundExpression &expr, const std::unordered_set<std::string> &columns) -> bool {
+  std::vector<std::string> names;
+  CollectColumnNames(expr, &names);
+  for (const auto &name : names) {
+    if (columns.count(name) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** Split an expression into the operands of its top-level `AND`s. */
+void SplitConjuncts(const BoundExpression *expr, std::vector<const BoundExpression *> *conjuncts) {
+  if (expr->type_ == ExpressionType::BINARY_OP) {
+    const auto &binary_op = dynamic_cast<const BoundBinaryOp &>(*expr);
+    if (binary_op.op_name_ == "and") {
+      SplitConjuncts(binary_op.larg_.get(), conjuncts);
+      SplitConjuncts(binary_op.rarg_.get(), conjuncts);
+      return;
+    }
+  }
+  conjuncts->emplace_back(expr);
+}
+
+/** @return the conjunct as an `EXISTS` or `IN` subquery, and whether it is negated; nullptr if it is not one */
+auto MatchSemiJoin(const BoundExpression *conjunct) -> std::tuple<const BoundSubqueryExpr *, bool> {
+  bool negated = false;
+  if (conjunct->type_ == ExpressionType::UNARY_OP) {
+    const auto &unary_op = dynamic_cast<const BoundUnaryOp &>(*conjunct);
+    if (unary_op.op_name_ != "not") {
+      return {nullptr, false};
+    }
+    conjunct = unary_op.arg_.get();
+    negated = true;
+  }
+  if (conjunct->type_ != ExpressionType::SUBQUERY) {
+    return {nullptr, false};
+  }
+  const auto *subquery = dynamic_cast<const BoundSubqueryExpr *>(conjunct);
+  if (subquery->subquery_type_ == SubqueryType::SCALAR) {
+    return {nullptr, false};
+  }
+  return {subquery, negated};
+}
+
+/** @return whether an expression calls COUNT, which does not return NULL over no rows */
+auto HasCount(const BoundExpression &expr) -> bool {
+  switch (expr.type_) {
+    case ExpressionType::AGG_CALL: {
+      const auto &agg_call = dynamic_cast<const BoundAggCall &>(expr);
+      return agg_call.func_name_ == "count" || agg_call.func_name_ == "count_star";
+    }
+    case ExpressionType::BINARY_OP: {
+      const auto &binary_op = dynamic_cast<const BoundBinaryOp &>(expr);
+      return HasCount(*binary_op.larg_) || HasCount(*binary_op.rarg_);
+    }
+    case ExpressionType::FUNC_CALL:
+      for (const auto &arg : dynamic_cast<const BoundFuncCall &>(expr).args_) {
+        if (HasCount(*arg)) {
+          return true;
+        }
+      }
+      return false;
+    case ExpressionType::ALIAS:
+      return HasCount(*dynamic_cast<const BoundAlias &>(expr).child_);
+    default:
+      return false;
+  }
+}
+
+/** @return a projection of all the columns of plan, with the last one renamed */
+auto RenameLastColumn(AbstractPlanNodeRef plan, const std::string &name) -> AbstractPlanNodeRef {
+  std::vector<AbstractExpressionRef> exprs;
+  std::vector<std::string> names;
+  const auto &columns = plan->OutputSchema().GetColumns();
+  for (size_t i = 0; i < columns.size(); i++) {
+    exprs.emplace_back(std::make_shared<ColumnValueExpression>(0, i, columns[i].GetType()));
+    names.emplace_back(i + 1 == columns.size() ? name : columns[i].GetName());
+  }
+  return std::make_shared<ProjectionPlanNode>(
+      std::make_shared<Schema>(
+          ProjectionPlanNode::RenameSchema(ProjectionPlanNode::InferProjectionSchema(exprs), names)),
+      std::move(exprs), std::move(plan));
+}
+
+auto MakeJoin(AbstractPlanNodeRef left, AbstractPlanNodeRef right, AbstractExpressionRef predicate,
+              JoinType join_type) -> AbstractPlanNodeRef {
+  return std::make_shared<NestedLoopJoinPlanNode>(
+      std::make_shared<Schema>(NestedLoopJoinPlanNode::InferJoinSchema(*left, *right, join_type)), std::move(left),
+      std::move(right), std::move(predicate), join_type);
+}
+
+auto TrueExpression() -> AbstractExpressionRef {
+  return std::make_shared<ConstantValueExpression>(ValueFactory::GetBooleanValue(true));
+}
+
+}  // namespace
+
+auto Planner::PlanWhere(const std::vector<const BoundExpression *> &conjuncts, AbstractPlanNodeRef plan)
+    -> AbstractPlanNodeRef {
+  std::vector<const BoundExpression *> split;
+  for (const auto *conjunct : conjuncts) {
+    SplitConjuncts(conjunct, &split);
+  }
+
+  // Filter before the semi joins, so that they probe fewer rows.
+  std::vector<std::tuple<const BoundSubqueryExpr *, bool>> semi_joins;
+  AbstractExpressionRef predicate = nullptr;
+  for (const auto *conjunct : split) {
+    if (auto [subquery, negated] = MatchSemiJoin(conjunct); subquery != nullptr) {
+      semi_joins.emplace_back(subquery, negated);
+      continue;
+    }
+    plan = PlanScalarSubqueries(*conjunct, std::move(plan));
+    auto [_, expr] = PlanExpression(*conjunct, {plan});
+    predicate = predicate == nullptr ? std::move(expr)
+                                     : GetBinaryExpressionFromFactory("and", std::move(predicate), std::move(expr));
+  }
+  if (predicate != nullptr) {
+    auto schema = plan->OutputSchema();
+    plan = std::make_shared<FilterPlanNode>(std::make_shared<Schema>(schema), std::move(predicate), std::move(plan));
+  }
+
+  for (const auto &[subquery, negated] : semi_joins) {
+    plan = PlanSemiJoin(*subquery, negated, std::move(plan));
+  }
+  return plan;
+}
+
+auto Planner::PlanScalarSubqueries(const BoundExpression &expr, AbstractPlanNodeRef plan) -> AbstractPlanNodeRef {
+  switch (expr.type_) {
+    case ExpressionType::SUBQUERY: {
+      const auto &subquery = dynamic_cast<const BoundSubqueryExpr &>(expr);
+      if (subquery.subquery_type_ == SubqueryType::SCALAR) {
+        return PlanScalarSubquery(subquery, std::move(plan));
+      }
+      return plan;
+    }
+    case ExpressionType::BINARY_OP: {
+      const auto &binary_op = dynamic_cast<const BoundBinaryOp &>(expr);
+      plan = PlanScalarSubqueries(*binary_op.larg_, std::move(plan));
+      return PlanScalarSubqueries(*binary_op.rarg_, std::move(plan));
+    }
+    case ExpressionType::UNARY_OP:
+      return PlanScalarSubqueries(*dynamic_cast<const BoundUnaryOp &>(expr).arg_, std::move(plan));
+    case ExpressionType::FUNC_CALL:
+      for (const auto &arg : dynamic_cast<const BoundFuncCall &>(expr).args_) {
+        plan = PlanScalarSubqueries(*arg, std::move(plan));
+      }
+      return plan;
+    case ExpressionType::ALIAS:
+      return PlanScalarSubqueries(*dynamic_cast<const BoundAlias &>(expr).child_, std::move(plan));
+    default:
+      return plan;
+  }
+}
+
+auto Planner::PlanCorrelatedSubquery(const SelectStatement &subquery, const AbstractPlanNodeRef &outer)
+    -> std::tuple<AbstractPlanNodeRef, std::vector<const BoundExpression *>> {
+  if (!subquery.limit_count_->IsInvalid() || !subquery.limit_offset_->IsInvalid()) {
+    throw NotImplementedException("LIMIT in a correlated subquery is not supported");
+  }
+
+  auto ctx_guard = NewContext();
+  if (!subquery.ctes_.empty()) {
+    ctx_.cte_list_ = &subquery.ctes_;
+  }
+
+  AbstractPlanNodeRef plan = nullptr;
+  if (subquery.table_->type_ == TableReferenceType::EMPTY) {
+    plan = std::make_shared<ValuesPlanNode>(
+        std::make_shared<Schema>(std::vector<Column>{}),
+        std::vector<std::vector<AbstractExpressionRef>>{std::vector<AbstractExpressionRef>{}});
+  } else {
+    plan = PlanTableRef(*subquery.table_);
+  }
+
+  auto inner_columns = ColumnNames(*plan);
+  auto visible_columns = inner_columns;
+  for (const auto &column : outer->OutputSchema().GetColumns()) {
+    visible_columns.emplace(column.GetName());
+  }
+
+  std::vector<const BoundExpression *> conjuncts;
+  if (!subquery.where_->IsInvalid()) {
+    SplitConjuncts(subquery.where_.get(), &conjuncts);
+  }
+  std::vector<const BoundExpression *> local;
+  std::vector<const BoundExpression *> correlated;
+  for (const auto *conjunct : conjuncts) {
+    if (ReadsOnly(*conjunct, inner_columns)) {
+      local.emplace_back(conjunct);
+    } else if (ReadsOnly(*conjunct, visible_columns)) {
+      correlated.emplace_back(conjunct);
+    } else {
+      throw NotImplementedException(
+          fmt::format("cannot decorrelate {}: only references to the enclosing query are supported",
+                      conjunct->ToString()));
+    }
+  }
+
+  for (const auto &item : subquery.select_list_) {
+    if (!ReadsOnly(*item, inner_columns)) {
+      throw NotImplementedException("a correlated subquery can only read the enclosing query in its WHERE clause");
+    }
+  }
+  for (const auto &expr : subquery.group_by_) {
+    if (!ReadsOnly(*expr, inner_columns)) {
+      throw NotImplementedException("a correlated subquery can only read the enclosing query in its WHERE clause");
+    }
+  }
+
+  if (!local.empty()) {
+    plan = PlanWhere(local, std::move(plan));
+  }
+  return {std::move(plan), std::move(correlated)};
+}
+
+auto Planner::PlanSemiJoin(const BoundSubqueryExpr &expr, bool anti, AbstractPlanNodeRef plan)
+    -> AbstractPlanNodeRef {
+  if (anti && expr.subquery_type_ == SubqueryType::IN) {
+    throw NotImplementedException("NOT IN subquery is not supported, use NOT EXISTS");
+  }
+  const auto &subquery = *expr.subquery_;
+  auto join_type = anti ? JoinType::ANTI : JoinType::SEMI;
+
+  AbstractExpressionRef key = nullptr;
+  if (expr.subquery_type_ == SubqueryType::IN) {
+    plan = PlanScalarSubqueries(*expr.arg_, std::move(plan));
+    auto [_, arg] = PlanExpression(*expr.arg_, {plan});
+    key = std::move(arg);
+  }
+
+  if (!expr.is_correlated_) {
+    auto right = PlanSelect(subquery);
+    auto predicate = TrueExpression();
+    if (key != nullptr) {
+      predicate = GetBinaryExpressionFromFactory(
+          "=", std::move(key),
+          std::make_shared<ColumnValueExpression>(1, 0, right->OutputSchema().GetColumn(0).GetType()));
+    }
+    return MakeJoin(std::move(plan), std::move(right), std::move(predicate), join_type);
+  }
+
+  // The rows of the subquery are the rows of its FROM clause passing its WHERE clause, so the semi join can read the
+  // columns of its FROM clause in place of the correlated conjuncts.
+  bool has_agg = false;
+  for (const auto &item : subquery.select_list_) {
+    has_agg = has_agg || item->HasAggregation();
+  }
+  if (has_agg || !subquery.group_by_.empty() || !subquery.having_->IsInvalid()) {
+    throw NotImplementedException("aggregation in a correlated EXISTS or IN subquery is not supported");
+  }
+  auto [right, correlated] = PlanCorrelatedSubquery(subquery, plan);
+
+  std::vector<AbstractExpressionRef> conditions;
+  if (key != nullptr) {
+    // Project the value of the subquery before the columns of its FROM clause.
+    auto [_, item] = PlanExpression(*subquery.select_list_[0], {right});
+    std::vector<AbstractExpressionRef> exprs{std::move(item)};
+    std::vector<std::string> names{fmt::format("__subquery#{}", universal_id_++)};
+    const auto &columns = right->OutputSchema().GetColumns();
+    for (size_t i = 0; i < columns.size(); i++) {
+      exprs.emplace_back(std::make_shared<ColumnValueExpression>(0, i, columns[i].GetType()));
+      names.emplace_back(columns[i].GetName());
+    }
+    right = std::make_shared<ProjectionPlanNode>(
+        std::make_shared<Schema>(
+            ProjectionPlanNode::RenameSchema(ProjectionPlanNode::InferProjectionSchema(exprs), names)),
+        std::move(exprs), std::move(right));
+    conditions.emplace_back(GetBinaryExpressionFromFactory(
+        "=", std::move(key),
+        std::make_shared<ColumnValueExpression>(1, 0, right->OutputSchema().GetColumn(0).GetType())));
+  }
+  for (const auto *conjunct : correlated) {
+    auto [_, condition] = PlanExpression(*conjunct, {plan, right});
+    conditions.emplace_back(std::move(condition));
+  }
+
+  auto predicate = TrueExpression();
+  for (size_t i = 0; i < conditions.size(); i++) {
+    predicate = i == 0 ? std::move(conditions[i])
+                       : GetBinaryExpressionFromFactory("and", std::move(predicate), std::move(conditions[i]));
+  }
+  return MakeJoin(std::move(plan), std::move(right), std::move(predicate), join_type);
+}
+
+auto Planner::PlanScalarSubquery(const BoundSubqueryExpr &expr, AbstractPlanNodeRef plan) -> AbstractPlanNodeRef {
+  const auto &subquery = *expr.subquery_;
+  bool has_agg = false;
+  for (const auto &item : subquery.select_list_) {
+    has_agg = has_agg || item->HasAggregation();
+  }
+  auto name = fmt::format("__scalar#{}", universal_id_++);
+
+  if (!expr.is_correlated_) {
+    // A subquery returning more than one row is an error the executors cannot raise: only plan the subqueries that
+    // return a single row.
+    bool single_row = (has_agg && subquery.group_by_.empty() && subquery.having_->IsInvalid()) ||
+                      (subquery.table_->type_ == TableReferenceType::EMPTY && subquery.where_->IsInvalid());
+    if (!single_row) {
+      throw NotImplementedException("only scalar subqueries with an aggregate and no GROUP BY are supported");
+    }
+    auto right = RenameLastColumn(PlanSelect(subquery), name);
+    plan = MakeJoin(std::move(plan), std::move(right), TrueExpression(), JoinType::LEFT);
+    ctx_.scalar_subqueries_.emplace(&expr, std::move(name));
+    return plan;
+  }
+
+  // Group the subquery by the inner sides of its equalities with the enclosing query, and join the groups on them.
+  if (!has_agg || !subquery.group_by_.empty() || !subquery.having_->IsInvalid() || subquery.is_distinct_) {
+    throw NotImplementedException("only correlated scalar subqueries with an aggregate and no GROUP BY are supported");
+  }
+  if (HasCount(*subquery.select_list_[0])) {
+    throw NotImplementedException("COUNT in a correlated scalar subquery is not supported");
+  }
+  auto [inner, correlated] = PlanCorrelatedSubquery(subquery, plan);
+  auto inner_columns = ColumnNames(*inner);
+
+  std::vector<AbstractExpressionRef> inner_keys;
+  std::vector<AbstractExpressionRef> outer_keys;
+  for (const auto *conjunct : correlated) {
+    const auto *binary_op = dynamic_cast<const BoundBinaryOp *>(conjunct);
+    if (binary_op == nullptr || binary_op->op_name_ != "=") {
+      throw NotImplementedException(
+          fmt::format("cannot decorrelate {}: only equalities with the enclosing query are supported",
+                      conjunct->ToString()));
+    }
+    const auto *inner_side = binary_op->larg_.get();
+    const auto *outer_side = binary_op->rarg_.get();
+    if (!ReadsOnly(*inner_side, inner_columns)) {
+      std::swap(inner_side, outer_side);
+    }
+    if (!ReadsOnly(*inner_side, inner_columns) || !ReadsOnly(*outer_side, ColumnNames(*plan))) {
+      throw NotImplementedException(
+          fmt::format("cannot decorrelate {}: only equalities with the enclosing query are supported",
+                      conjunct->ToString()));
+    }
+    auto [_1, inner_key] = PlanExpression(*inner_side, {inner});
+    auto [_2, outer_key] = PlanExpression(*outer_side, {plan});
+    inner_keys.emplace_back(std::move(inner_key));
+    outer_keys.emplace_back(std::move(outer_key));
+  }
+
+  auto right = RenameLastColumn(PlanSelectAgg(subquery, std::move(inner), inner_keys), name);
+  auto predicate = TrueExpression();
+  for (size_t i = 0; i < outer_keys.size(); i++) {
+    auto condition = GetBinaryExpressionFromFactory(
+        "=", std::move(outer_keys[i]),
+        std::make_shared<ColumnValueExpression>(1, i, right->OutputSchema().GetColumn(i).GetType()));
+    predicate = i == 0 ? std::move(condition)
+                       : GetBinaryExpressionFromFactory("and", std::move(predicate), std::move(condition));
+  }
+  plan = MakeJoin(std::move(plan), std::move(right), std::move(predicate), JoinType::LEFT);
+  ctx_.scalar_subqueries_.emplace(&expr, std::move(name));
+  return plan;
+}
+
+auto Planner::PlanSubqueryExpr(const BoundSubqueryExpr &expr, const std::vector<AbstractPlanNodeRef> &children)
+    -> AbstractExpressionRef {
+  if (expr.subquery_type_ != SubqueryType::SCALAR) {
+    throw NotImplementedException("EXISTS and IN subqueries are only supported as conjuncts of WHERE");
+  }
+  auto it = ctx_.scalar_subqueries_.find(&expr);
+  if (it != ctx_.scalar_subqueries_.end() && children.size() == 1) {
+    const auto &schema = children[0]->OutputSchema();
+    if (auto col_idx = schema.TryGetColIdx(it->second); col_idx.has_value()) {
+      return std::make_shared<ColumnValueExpression>(0, *col_idx, schema.GetColumn(*col_idx).GetType());
+    }
+  }
+  throw NotImplementedException("scalar subqueries are only supported in WHERE and in the select list");
+}
+
+}  // namespace bustub
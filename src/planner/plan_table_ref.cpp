@@ -22,6 +22,7 @@
 #include "execution/plans/nested_loop_join_plan.h"
 #include "execution/plans/projection_plan.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/spool_plan.h"
 #include "execution/plans/values_plan.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
@@ -64,25 +65,27 @@ auto Planner::PlanTableRef(const BoundTableRef &table_ref) -> AbstractPlanNodeRe
 }
 
 auto Planner::PlanSubquery(const BoundSubqueryRef &table_ref, const std::string &alias) -> AbstractPlanNodeRef {
-  auto select_node = PlanSelect(*table_ref.subquery_);
+  return RenameSubquery(PlanSelect(*table_ref.subquery_), table_ref, alias);
+}
+
+auto Planner::RenameSubquery(AbstractPlanNodeRef plan, const BoundSubqueryRef &table_ref, const std::string &alias)
+    -> AbstractPlanNodeRef {
   std::vector<std::string> output_column_names;
   std::vector<AbstractExpressionRef> exprs;
   size_t idx = 0;
 
   // This projection will be removed by eliminate projection rule. It's solely used for renaming columns.
-  for (const auto &col : select_node->OutputSchema().GetColumns()) {
+  for (const auto &col : plan->OutputSchema().GetColumns()) {
     auto expr = std::make_shared<ColumnValueExpression>(0, idx, col.GetType());
     output_column_names.emplace_back(fmt::format("{}.{}", alias, fmt::join(table_ref.select_list_name_[idx], ".")));
     exprs.push_back(std::move(expr));
     idx++;
   }
 
-  auto saved_child = std::move(select_node);
-
   return std::make_shared<ProjectionPlanNode>(
       std::make_shared<Schema>(
           ProjectionPlanNode::RenameSchema(ProjectionPlanNode::InferProjectionSchema(exprs), output_column_names)),
-      std::move(exprs), saved_child);
+      std::move(exprs), std::move(plan));
 }
 
 auto Planner::PlanBaseTableRef(const BoundBaseTableRef &table_ref) -> AbstractPlanNodeRef {
@@ -122,12 +125,33 @@ auto Planner::PlanCrossProductRef(const BoundCrossProductRef &table_ref) -> Abst
 auto Planner::PlanCTERef(const BoundCTERef &table_ref) -> AbstractPlanNodeRef {
   for (const auto &cte : *ctx_.cte_list_) {
     if (cte->alias_ == table_ref.cte_name_) {
-      return PlanSubquery(*cte, table_ref.alias_);
+      auto it = cte_spools_.find(cte.get());
+      if (it == cte_spools_.end()) {
+        auto child = PlanSelect(*cte->subquery_);
+        auto spool = std::make_shared<SpoolPlanNode>(std::make_shared<Schema>(child->OutputSchema()), std::move(child),
+                                                     spool_readers_.size());
+        spool_readers_.emplace_back(0);
+        it = cte_spools_.emplace(cte.get(), std::move(spool)).first;
+      }
+      spool_readers_[it->second->spool_id_]++;
+      return RenameSubquery(it->second, *cte, table_ref.alias_);
     }
   }
   UNREACHABLE("CTE not found");
 }
 
+auto Planner::InlineSingleReaderSpools(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  if (const auto *spool = dynamic_cast<const SpoolPlanNode *>(plan.get());
+      spool != nullptr && spool_readers_[spool->spool_id_] == 1) {
+    return InlineSingleReaderSpools(spool->GetChildPlan());
+  }
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(InlineSingleReaderSpools(child));
+  }
+  return plan->CloneWithChildren(std::move(children));
+}
+
 auto Planner::PlanJoinRef(const BoundJoinRef &table_ref) -> AbstractPlanNodeRef {
   auto left = PlanTableRef(*table_ref.left_);
   auto right = PlanTableRef(*table_ref.right_);
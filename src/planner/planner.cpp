@@ -27,23 +27,25 @@ void Planner::PlanQuery(const BoundStatement &statement) {
   switch (statement.type_) {
     case StatementType::SELECT_STATEMENT: {
       plan_ = PlanSelect(dynamic_cast<const SelectStatement &>(statement));
-      return;
+      break;
     }
     case StatementType::INSERT_STATEMENT: {
       plan_ = PlanInsert(dynamic_cast<const InsertStatement &>(statement));
-      return;
+      break;
     }
     case StatementType::DELETE_STATEMENT: {
       plan_ = PlanDelete(dynamic_cast<const DeleteStatement &>(statement));
-      return;
+      break;
     }
     case StatementType::UPDATE_STATEMENT: {
       plan_ = PlanUpdate(dynamic_cast<const UpdateStatement &>(statement));
-      return;
+      break;
     }
     default:
       throw Exception(fmt::format("the statement {} is not supported in planner yet", statement.type_));
   }
+  // A CTE referenced once is read straight from its plan.
+  plan_ = InlineSingleReaderSpools(plan_);
 }
 
 auto Planner::MakeOutputSchema(const std::vector<std::pair<std::string, TypeId>> &exprs) -> SchemaRef {
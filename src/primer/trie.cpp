@@ -1,9 +1,60 @@
 #include "primer/trie.h"
 #include <string_view>
+#include <unordered_set>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include "common/exception.h"
 
 namespace bustub {
 
+auto TrieChildren::IndexOf(char key) const -> size_t {
+  size_t size = keys_.size();
+  size_t i = 0;
+#if defined(__SSE2__)
+  auto needle = _mm_set1_epi8(key);
+  for (; i + 16 <= size; i += 16) {
+    auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys_.data() + i));
+    auto mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+#endif
+  for (; i < size; i++) {
+    if (keys_[i] == key) {
+      return i;
+    }
+  }
+  return size;
+}
+
+auto TrieChildren::Find(char key) const -> const std::shared_ptr<const TrieNode> * {
+  auto i = IndexOf(key);
+  return i == keys_.size() ? nullptr : &children_[i];
+}
+
+void TrieChildren::InsertOrAssign(char key, std::shared_ptr<const TrieNode> child) {
+  auto i = IndexOf(key);
+  if (i != keys_.size()) {
+    children_[i] = std::move(child);
+    return;
+  }
+  auto pos = std::upper_bound(keys_.begin(), keys_.end(), key) - keys_.begin();
+  keys_.insert(keys_.begin() + pos, key);
+  children_.insert(children_.begin() + pos, std::move(child));
+}
+
+auto TrieChildren::Erase(char key) -> bool {
+  auto i = IndexOf(key);
+  if (i == keys_.size()) {
+    return false;
+  }
+  keys_.erase(keys_.begin() + i);
+  children_.erase(children_.begin() + i);
+  return true;
+}
+
 template <class T>
 auto Trie::Get(std::string_view key) const -> const T * {
   // throw NotImplementedException("Trie::Get is not implemented.");
@@ -13,23 +64,30 @@ auto Trie::Get(std::string_view key) const -> const T * {
   // dynamic_cast returns `nullptr`, it means the type of the value is mismatched, and you should return nullptr.
   // Otherwise, return the value.
 
-  if (this->root_ == nullptr) {
+  auto node = FindNode(this->root_.get(), key);
+  if (node == nullptr || !node->is_value_node_) {
     return nullptr;
   }
+  auto t = dynamic_cast<const TrieNodeWithValue<T> *>(node);
+  return t == nullptr ? nullptr : t->value_.get();
+}
 
-  auto cur = this->root_;
-  for (const auto &ch : key) {
-    auto it = cur->children_.find(ch);
-    if (it == cur->children_.end()) {
+auto Trie::FindNode(const TrieNode *node, std::string_view key) -> const TrieNode * {
+  // The trie is immutable and keeps every node alive, so the walk follows raw pointers. Copying the shared_ptr of
+  // each node would cost two atomic reference count updates per level on cache lines shared by all readers.
+  size_t i = 0;
+  while (node != nullptr && i < key.size()) {
+    auto child = node->children_.Find(key[i]);
+    if (child == nullptr) {
       return nullptr;
     }
-    cur = it->second;
-  }
-  if (cur->is_value_node_) {
-    auto t = dynamic_cast<const TrieNodeWithValue<T> *>(cur.get());
-    return t == nullptr ? nullptr : t->value_.get();
+    node = child->get();
+    if (key.substr(i + 1, node->prefix_.size()) != node->prefix_) {
+      return nullptr;
+    }
+    i += 1 + node->prefix_.size();
   }
-  return nullptr;
+  return node;
 }
 
 template <class T>
@@ -40,67 +98,186 @@ auto Trie::Put(std::string_view key, T value) const -> Trie {
   // You should walk through the trie and create new nodes if necessary. If the node corresponding to the key already
   // exists, you should create a new `TrieNodeWithValue`.
 
-  std::shared_ptr cur_old = (this->root_ != nullptr) ? this->root_ : std::make_shared<TrieNode>();
-  auto value_ptr = std::make_shared<T>(std::move(value));
+  std::unordered_set<const TrieNode *> fresh;
+  std::shared_ptr<TrieNode> new_root = this->root_ != nullptr ? this->root_->Clone() : std::make_shared<TrieNode>();
+  fresh.insert(new_root.get());
+  PutValue(&new_root, key, std::make_shared<T>(std::move(value)), &fresh);
+  return Trie{new_root};
+}
 
-  std::shared_ptr new_root = cur_old->Clone();
-  auto cur = new_root;
+auto Trie::Remove(std::string_view key) const -> Trie {
+  // You should walk through the trie and remove nodes if necessary. If the node doesn't contain a value any more,
+  // you should convert it to `TrieNode`. If a node doesn't have children any more, you should remove it.
+  return RemoveBatch({std::string(key)});
+}
 
+template <class T>
+auto Trie::PutBatch(std::vector<std::pair<std::string, T>> entries) const -> Trie {
+  std::unordered_set<const TrieNode *> fresh;
+  std::shared_ptr<TrieNode> new_root = this->root_ != nullptr ? this->root_->Clone() : std::make_shared<TrieNode>();
+  fresh.insert(new_root.get());
+  for (auto &[key, value] : entries) {
+    PutValue(&new_root, key, std::make_shared<T>(std::move(value)), &fresh);
+  }
+  return Trie{new_root};
+}
+
+template <class T>
+void Trie::PutValue(std::shared_ptr<TrieNode> *root, std::string_view key, std::shared_ptr<T> value,
+                    std::unordered_set<const TrieNode *> *fresh) {
+  auto value_node = [&value, fresh](TrieChildren children, std::string_view prefix) {
+    auto node = std::make_shared<TrieNodeWithValue<T>>(std::move(children), value);
+    node->prefix_ = prefix;
+    fresh->insert(node.get());
+    return node;
+  };
   if (key.empty()) {
-    std::shared_ptr<TrieNode> t = std::make_shared<TrieNodeWithValue<T>>(new_root->children_, value_ptr);
-    return Trie{t};
+    *root = value_node(std::move((*root)->children_), "");
+    return;
   }
-  int n = key.size();
-  for (const char &ch : key) {
-    n--;
-    auto it = cur->children_.find(ch);
-    if (it == cur->children_.end()) {
-      std::shared_ptr<TrieNode> t = std::make_shared<TrieNode>();
-      if (n == 0) {
-        t = std::make_shared<TrieNodeWithValue<T>>(value_ptr);
-      }
-      cur->children_.emplace(ch, t);
-      cur = t;
-    } else {
-      std::shared_ptr t = it->second->Clone();
-      if (n == 0) {
-        t = std::make_shared<TrieNodeWithValue<T>>(t->children_, value_ptr);
+
+  TrieNode *parent = root->get();
+  size_t i = 0;
+  while (true) {
+    auto ch = key[i];
+    auto rest = key.substr(i + 1);
+    auto found = parent->children_.Find(ch);
+    if (found == nullptr) {
+      // The rest of the key becomes the prefix of a single leaf.
+      parent->children_.InsertOrAssign(ch, value_node({}, rest));
+      return;
+    }
+    auto child = *found;
+    const auto &prefix = child->prefix_;
+    size_t matched = 0;
+    while (matched < prefix.size() && matched < rest.size() && prefix[matched] == rest[matched]) {
+      matched++;
+    }
+
+    if (matched < prefix.size()) {
+      // The key ends or branches off inside the compressed path of the child: split the path there. The child keeps
+      // the part of its prefix after the branch.
+      std::string upper_prefix = prefix.substr(0, matched);
+      auto lower = Writable(child, fresh);
+      auto branch = lower->prefix_[matched];
+      lower->prefix_.erase(0, matched + 1);
+      TrieChildren children;
+      children.InsertOrAssign(branch, lower);
+      if (matched == rest.size()) {
+        parent->children_.InsertOrAssign(ch, value_node(std::move(children), upper_prefix));
+        return;
       }
-      cur->children_.insert_or_assign(ch, t);
-      cur = t;
+      auto upper = std::make_shared<TrieNode>(std::move(children));
+      upper->prefix_ = std::move(upper_prefix);
+      fresh->insert(upper.get());
+      upper->children_.InsertOrAssign(rest[matched], value_node({}, rest.substr(matched + 1)));
+      parent->children_.InsertOrAssign(ch, upper);
+      return;
+    }
+
+    if (matched == rest.size()) {
+      // The key ends at the child: it becomes a value node with the same children.
+      parent->children_.InsertOrAssign(ch, value_node(TakeChildren(child, *fresh), prefix));
+      return;
     }
+    parent = CloneChildOnce(parent, ch, fresh);
+    i += 1 + matched;
   }
-  return Trie{new_root};
 }
 
-auto Trie::Remove(std::string_view key) const -> Trie {
-  // throw NotImplementedException("Trie::Remove is not implemented.");
-
-  // You should walk through the trie and remove nodes if necessary. If the node doesn't contain a value any more,
-  // you should convert it to `TrieNode`. If a node doesn't have children any more, you should remove it.
-  std::shared_ptr new_root = this->root_->Clone();
+auto Trie::RemoveBatch(const std::vector<std::string> &keys) const -> Trie {
   if (this->root_ == nullptr) {
-    return Trie{new_root};
-  }
-  if (key.empty()) {
-    return Trie{std::make_shared<TrieNode>(new_root->children_)};
+    return *this;
   }
-  int n = key.size();
-  auto cur = new_root;
-  for (const char &ch : key) {
-    n--;
-    auto it = cur->children_.find(ch);
-    if (it == cur->children_.end()) {
-      return Trie{new_root};
+  std::unordered_set<const TrieNode *> fresh;
+  std::shared_ptr<TrieNode> new_root = nullptr;
+
+  for (const auto &key : keys) {
+    // Look the key up first, so that a missing key clones nothing.
+    auto node = FindNode(new_root != nullptr ? new_root.get() : this->root_.get(), key);
+    if (node == nullptr || !node->is_value_node_) {
+      continue;
     }
-    std::shared_ptr t = it->second->Clone();
-    if (n == 0) {
-      t = std::make_shared<TrieNode>(t->children_);
+
+    if (new_root == nullptr) {
+      new_root = this->root_->Clone();
+      fresh.insert(new_root.get());
+    }
+    if (key.empty()) {
+      new_root = std::make_shared<TrieNode>(std::move(new_root->children_));
+      fresh.insert(new_root.get());
+      continue;
+    }
+
+    // path[j] is a writable node on the way to the key, and edges[j] the character leading from path[j] to the next
+    // node on the way. The last edge leads to the node of the key.
+    std::vector<TrieNode *> path{new_root.get()};
+    std::vector<char> edges{key[0]};
+    for (size_t i = 1 + (*new_root->children_.Find(key[0]))->prefix_.size(); i < key.size();) {
+      path.push_back(CloneChildOnce(path.back(), edges.back(), &fresh));
+      edges.push_back(key[i]);
+      i += 1 + (*path.back()->children_.Find(key[i]))->prefix_.size();
+    }
+    auto old_node = *path.back()->children_.Find(edges.back());
+    if (old_node->children_.Empty()) {
+      path.back()->children_.Erase(edges.back());
+      edges.pop_back();
+    } else {
+      std::shared_ptr<TrieNode> t = std::make_shared<TrieNode>(TakeChildren(old_node, fresh));
+      t->prefix_ = old_node->prefix_;
+      fresh.insert(t.get());
+      path.back()->children_.InsertOrAssign(edges.back(), t);
+      path.push_back(t.get());
+    }
+
+    // Keep the path compressed: drop the nodes left with neither a value nor children, and merge a node left with no
+    // value and a single child into the child.
+    for (size_t j = path.size() - 1; j > 0; j--) {
+      auto *node = path[j];
+      if (node->is_value_node_ || node->children_.Size() > 1) {
+        break;
+      }
+      if (node->children_.Empty()) {
+        path[j - 1]->children_.Erase(edges[j - 1]);
+        continue;
+      }
+      auto merged = Writable(node->children_.ChildAt(0), &fresh);
+      merged->prefix_ = node->prefix_ + node->children_.KeyAt(0) + merged->prefix_;
+      path[j - 1]->children_.InsertOrAssign(edges[j - 1], merged);
+      break;
     }
-    cur->children_.insert_or_assign(ch, t);
-    cur = t;
   }
-  return Trie{new_root};
+  return new_root != nullptr ? Trie{new_root} : *this;
+}
+
+auto Trie::Writable(const std::shared_ptr<const TrieNode> &node, std::unordered_set<const TrieNode *> *fresh)
+    -> std::shared_ptr<TrieNode> {
+  if (fresh->count(node.get()) != 0) {
+    // Created by this batch and reachable from nowhere else, it can be modified in place.
+    return std::const_pointer_cast<TrieNode>(node);
+  }
+  std::shared_ptr<TrieNode> t = node->Clone();
+  fresh->insert(t.get());
+  return t;
+}
+
+auto Trie::CloneChildOnce(TrieNode *parent, char key, std::unordered_set<const TrieNode *> *fresh) -> TrieNode * {
+  const auto &child = *parent->children_.Find(key);
+  if (fresh->count(child.get()) != 0) {
+    return const_cast<TrieNode *>(child.get());
+  }
+  auto t = Writable(child, fresh);
+  parent->children_.InsertOrAssign(key, t);
+  return t.get();
+}
+
+auto Trie::TakeChildren(const std::shared_ptr<const TrieNode> &node, const std::unordered_set<const TrieNode *> &fresh)
+    -> TrieChildren {
+  if (fresh.count(node.get()) != 0) {
+    // The node is about to be replaced, and nothing outside this batch refers to it.
+    return std::move(const_cast<TrieNode *>(node.get())->children_);
+  }
+  return node->children_;
 }
 
 // Below are explicit instantiation of template functions.
@@ -112,12 +289,15 @@ auto Trie::Remove(std::string_view key) const -> Trie {
 
 template auto Trie::Put(std::string_view key, uint32_t value) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const uint32_t *;
+template auto Trie::PutBatch(std::vector<std::pair<std::string, uint32_t>> entries) const -> Trie;
 
 template auto Trie::Put(std::string_view key, uint64_t value) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const uint64_t *;
+template auto Trie::PutBatch(std::vector<std::pair<std::string, uint64_t>> entries) const -> Trie;
 
 template auto Trie::Put(std::string_view key, std::string value) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const std::string *;
+template auto Trie::PutBatch(std::vector<std::pair<std::string, std::string>> entries) const -> Trie;
 
 // If your solution cannot compile for non-copy tests, you can remove the below lines to get partial score.
 
@@ -125,42 +305,17 @@ using Integer = std::unique_ptr<uint32_t>;
 
 template auto Trie::Put(std::string_view key, Integer vaxlue) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const Integer *;
+template auto Trie::PutBatch(std::vector<std::pair<std::string, Integer>> entries) const -> Trie;
 
 // template auto Trie::Put(std::string_view key, MoveBlocked) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const MoveBlocked *;
 
 template <>
 auto Trie::Put(std::string_view key, MoveBlocked value) const -> Trie {
-  std::shared_ptr cur_old = (this->root_ != nullptr) ? this->root_ : std::make_shared<TrieNode>();
-  auto value_ptr = std::make_shared<MoveBlocked>(std::move(value.wait_));
-
-  std::shared_ptr new_root = cur_old->Clone();
-  auto cur = new_root;
-
-  if (key.empty()) {
-    std::shared_ptr<TrieNode> t = std::make_shared<TrieNodeWithValue<MoveBlocked>>(new_root->children_, value_ptr);
-    return Trie{t};
-  }
-  int n = key.size();
-  for (const char &ch : key) {
-    n--;
-    auto it = cur->children_.find(ch);
-    if (it == cur->children_.end()) {
-      std::shared_ptr<TrieNode> t = std::make_shared<TrieNode>();
-      if (n == 0) {
-        t = std::make_shared<TrieNodeWithValue<MoveBlocked>>(value_ptr);
-      }
-      cur->children_.emplace(ch, t);
-      cur = t;
-    } else {
-      std::shared_ptr t = it->second->Clone();
-      if (n == 0) {
-        t = std::make_shared<TrieNodeWithValue<MoveBlocked>>(t->children_, value_ptr);
-      }
-      cur->children_.insert_or_assign(ch, t);
-      cur = t;
-    }
-  }
+  std::unordered_set<const TrieNode *> fresh;
+  std::shared_ptr<TrieNode> new_root = this->root_ != nullptr ? this->root_->Clone() : std::make_shared<TrieNode>();
+  fresh.insert(new_root.get());
+  PutValue(&new_root, key, std::make_shared<MoveBlocked>(std::move(value.wait_)), &fresh);
   return Trie{new_root};
 }
 }  // namespace bustub
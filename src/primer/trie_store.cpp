@@ -1,4 +1,7 @@
 #include "primer/trie_store.h"
+#include <algorithm>
+#include <functional>
+#include <thread>  // NOLINT
 #include "common/exception.h"
 
 namespace bustub {
@@ -13,16 +16,25 @@ auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<T>> {
   //     root. Otherwise, return std::nullopt.
   // throw NotImplementedException("TrieStore::Get is not implemented.");
 
-  std::shared_lock<std::shared_mutex> root_lock(root_lock_);
-  auto root = this->root_;
-  root_lock.unlock();
+  EpochGuard epoch(&epoch_manager_);
+  if (!epoch.IsPinned()) {
+    // Every epoch slot is taken, fall back to holding a reference to the root of the latest snapshot. Writers swap
+    // the snapshot only once the new version is built, so this does not wait for them either.
+    Trie root = *std::atomic_load(&snapshot_);
+    auto ptr_value = root.Get<T>(key);
+    if (ptr_value == nullptr) {
+      return std::nullopt;
+    }
+    return ValueGuard<T>{std::move(root), *ptr_value};
+  }
 
-  auto ptr_value = root.Get<T>(key);
+  // With the epoch pinned, the version we load is not freed until the guard is gone, so the lookup takes no lock
+  // and updates no reference count.
+  auto ptr_value = root_.load()->Get<T>(key);
   if (ptr_value == nullptr) {
     return std::nullopt;
   }
-  const T &value = *ptr_value;
-  return ValueGuard<T>{root, std::move(value)};
+  return ValueGuard<T>{std::move(epoch), *ptr_value};
 }
 
 template <class T>
@@ -31,12 +43,9 @@ void TrieStore::Put(std::string_view key, T value) {
   // The logic should be somehow similar to `TrieStore::Get`.
   // throw NotImplementedException("TrieStore::Put is not implemented.");
 
-  auto root_lock = std::unique_lock<std::shared_mutex>(root_lock_);
+  // Only writers change root_, so the new version is built holding the write lock alone. Readers never wait.
   auto write_lock = std::unique_lock<std::mutex>(write_lock_);
-  auto root = this->root_;
-  this->root_ = root.Put(key, std::move(value));
-  write_lock.unlock();
-  root_lock.unlock();
+  PublishRoot(root_.load()->Put(key, std::move(value)));
 }
 
 void TrieStore::Remove(std::string_view key) {
@@ -44,21 +53,65 @@ void TrieStore::Remove(std::string_view key) {
   // The logic should be somehow similar to `TrieStore::Get`.
   // throw NotImplementedException("TrieStore::Remove is not implemented.");
 
-  auto root_lock = std::unique_lock<std::shared_mutex>(root_lock_);
   auto write_lock = std::unique_lock<std::mutex>(write_lock_);
-  auto root = this->root_;
-  this->root_ = root.Remove(key);
-  write_lock.unlock();
-  root_lock.unlock();
+  PublishRoot(root_.load()->Remove(key));
+}
+
+template <class T>
+void TrieStore::PutBatch(std::vector<std::pair<std::string, T>> entries) {
+  auto write_lock = std::unique_lock<std::mutex>(write_lock_);
+  PublishRoot(root_.load()->PutBatch(std::move(entries)));
+}
+
+void TrieStore::RemoveBatch(const std::vector<std::string> &keys) {
+  auto write_lock = std::unique_lock<std::mutex>(write_lock_);
+  PublishRoot(root_.load()->RemoveBatch(keys));
+}
+
+void TrieStore::PublishRoot(Trie root) {
+  auto snapshot = std::make_shared<const Trie>(root);
+  auto *old_root = root_.exchange(new Trie(std::move(root)));
+  std::atomic_store(&snapshot_, std::shared_ptr<const Trie>(std::move(snapshot)));
+  // A reader that pins a later epoch loads the new root, so the old one only has to outlive the current epoch.
+  retired_.emplace_back(epoch_manager_.Advance(), old_root);
+
+  auto oldest_active_epoch = epoch_manager_.OldestActiveEpoch();
+  auto is_unreachable = [oldest_active_epoch](const auto &retired) { return retired.first < oldest_active_epoch; };
+  retired_.erase(std::remove_if(retired_.begin(), retired_.end(), is_unreachable), retired_.end());
+}
+
+TrieStore::~TrieStore() { delete root_.load(); }
+
+auto EpochManager::Enter() -> size_t {
+  auto epoch = global_epoch_.load();
+  auto start = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  for (size_t i = 0; i < NUM_SLOTS; i++) {
+    auto slot = (start + i) % NUM_SLOTS;
+    auto expected = INACTIVE_EPOCH;
+    if (slots_[slot].epoch_.compare_exchange_strong(expected, epoch)) {
+      return slot;
+    }
+  }
+  return NUM_SLOTS;
+}
+
+auto EpochManager::OldestActiveEpoch() const -> uint64_t {
+  auto oldest = global_epoch_.load();
+  for (const auto &slot : slots_) {
+    oldest = std::min(oldest, slot.epoch_.load());
+  }
+  return oldest;
 }
 
 // Below are explicit instantiation of template functions.
 
 template auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<uint32_t>>;
 template void TrieStore::Put(std::string_view key, uint32_t value);
+template void TrieStore::PutBatch(std::vector<std::pair<std::string, uint32_t>> entries);
 
 template auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<std::string>>;
 template void TrieStore::Put(std::string_view key, std::string value);
+template void TrieStore::PutBatch(std::vector<std::pair<std::string, std::string>> entries);
 
 // If your solution cannot compile for non-copy tests, you can remove the below lines to get partial score.
 
@@ -66,18 +119,15 @@ using Integer = std::unique_ptr<uint32_t>;
 
 template auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<Integer>>;
 template void TrieStore::Put(std::string_view key, Integer value);
+template void TrieStore::PutBatch(std::vector<std::pair<std::string, Integer>> entries);
 
 template auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<MoveBlocked>>;
 // template void TrieStore::Put(std::string_view key, MoveBlocked value);
 
 template <>
 void TrieStore::Put(std::string_view key, MoveBlocked value) {
-  auto root_lock = std::unique_lock<std::shared_mutex>(root_lock_);
   auto write_lock = std::unique_lock<std::mutex>(write_lock_);
-  auto root = this->root_;
-  this->root_ = root.Put(key, MoveBlocked{std::move(value.wait_)});
-  write_lock.unlock();
-  root_lock.unlock();
+  PublishRoot(root_.load()->Put(key, MoveBlocked{std::move(value.wait_)}));
 }
 
 }  // namespace bustub
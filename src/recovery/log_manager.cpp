@@ -12,6 +12,8 @@
 
 #include "recovery/log_manager.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 /*
  * set enable_logging = true
@@ -22,33 +24,119 @@ namespace bustub {
  *
  * This thread runs forever until system shutdown/StopFlushThread
  */
-void LogManager::RunFlushThread() {}
+void LogManager::RunFlushThread() {
+  // The flush thread starts by taking the latch, so it sees flush_thread_ set.
+  std::lock_guard<std::mutex> guard(latch_);
+  if (flush_thread_ != nullptr) {
+    return;
+  }
+  enable_logging = true;
+  flush_thread_ = new std::thread([this] {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (enable_logging) {
+      cv_.wait_for(lock, log_timeout, [this] { return flush_requested_ || !enable_logging; });
+      SwapAndFlush(&lock);
+    }
+  });
+}
 
 /*
  * Stop and join the flush thread, set enable_logging = false
  */
-void LogManager::StopFlushThread() {}
+void LogManager::StopFlushThread() {
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    if (flush_thread_ == nullptr) {
+      return;
+    }
+    enable_logging = false;
+  }
+  cv_.notify_one();
+  flush_thread_->join();
+  delete flush_thread_;
+  flush_thread_ = nullptr;
+
+  // Write out whatever was appended after the last flush.
+  std::unique_lock<std::mutex> lock(latch_);
+  SwapAndFlush(&lock);
+}
 
 /*
  * append a log record into log buffer
  * you MUST set the log record's lsn within this method
  * @return: lsn that is assigned to this log record
  *
- *
- * example below
- * // First, serialize the must have fields(20 bytes in total)
- * log_record.lsn_ = next_lsn_++;
- * memcpy(log_buffer_ + offset_, &log_record, 20);
- * int pos = offset_ + 20;
- *
- * if (log_record.log_record_type_ == LogRecordType::INSERT) {
- *    memcpy(log_buffer_ + pos, &log_record.insert_rid_, sizeof(RID));
- *    pos += sizeof(RID);
- *    // we have provided serialize function for tuple class
- *    log_record.insert_tuple_.SerializeTo(log_buffer_ + pos);
- *  }
- *
+ * The LSN is assigned only once the record is known to fit, so that records are laid out in the log in LSN order.
  */
-auto LogManager::AppendLogRecord(LogRecord *log_record) -> lsn_t { return INVALID_LSN; }
+auto LogManager::AppendLogRecord(LogRecord *log_record) -> lsn_t {
+  std::unique_lock<std::mutex> lock(latch_);
+  log_record->lsn_ = next_lsn_;
+  auto size = log_record->GetSerializedSize();
+  BUSTUB_ASSERT(size <= LOG_BUFFER_SIZE, "Log record does not fit in the log buffer");
+  while (log_buffer_offset_ + size > LOG_BUFFER_SIZE) {
+    if (flush_thread_ != nullptr) {
+      flush_requested_ = true;
+      cv_.notify_one();
+      flushed_cv_.wait(lock);
+    } else {
+      SwapAndFlush(&lock);
+    }
+    // Other appenders may have taken LSNs while we waited.
+    log_record->lsn_ = next_lsn_;
+    size = log_record->GetSerializedSize();
+  }
+
+  log_buffer_lsn_ = next_lsn_++;
+  log_buffer_offset_ += log_record->SerializeTo(log_buffer_ + log_buffer_offset_);
+  return log_buffer_lsn_;
+}
+
+void LogManager::Flush() {
+  lsn_t lsn;
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    lsn = log_buffer_lsn_;
+  }
+  WaitForFlush(lsn);
+}
+
+void LogManager::WaitForFlush(lsn_t lsn) {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (lsn != INVALID_LSN && persistent_lsn_ < lsn) {
+    if (flush_thread_ == nullptr) {
+      SwapAndFlush(&lock);
+      continue;
+    }
+    flush_requested_ = true;
+    cv_.notify_one();
+    flushed_cv_.wait(lock);
+  }
+}
+
+void LogManager::SwapAndFlush(std::unique_lock<std::mutex> *lock) {
+  flush_requested_ = false;
+  if (log_buffer_offset_ == 0) {
+    flushed_cv_.notify_all();
+    return;
+  }
+
+  std::swap(log_buffer_, flush_buffer_);
+  auto size = log_buffer_offset_;
+  auto lsn = log_buffer_lsn_;
+  log_buffer_offset_ = 0;
+
+  if (flush_thread_ != nullptr) {
+    // Only the flush thread gets here, appenders keep filling the other buffer while the flush buffer goes to disk.
+    lock->unlock();
+    disk_manager_->WriteLog(flush_buffer_, size);
+    lock->lock();
+  } else {
+    // Any thread may flush without the flush thread, so the write must not race with another swap.
+    disk_manager_->WriteLog(flush_buffer_, size);
+  }
+
+  persistent_lsn_ = lsn;
+  flushed_cv_.notify_all();
+}
 
 }  // namespace bustub
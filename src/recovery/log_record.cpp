@@ -0,0 +1,287 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_record.cpp
+//
+// Identification: src/recovery/log_record.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "recovery/log_record.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+namespace {
+
+auto ZigZag(int64_t value) -> uint64_t {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+auto UnZigZag(uint64_t value) -> int64_t { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+/**
+ * LogWriter encodes the fields of a log record. Without a buffer it only counts the bytes, so that the same encoding
+ * routine computes the serialized size and does the serialization.
+ */
+class LogWriter {
+ public:
+  explicit LogWriter(char *storage = nullptr) : storage_(storage) {}
+
+  void PutVarint(uint64_t value) {
+    while (value >= 0x80) {
+      PutByte(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    PutByte(static_cast<uint8_t>(value));
+  }
+
+  void PutSigned(int64_t value) { PutVarint(ZigZag(value)); }
+
+  void PutByte(uint8_t byte) {
+    if (storage_ != nullptr) {
+      storage_[size_] = static_cast<char>(byte);
+    }
+    size_++;
+  }
+
+  void PutBytes(const std::vector<char> &bytes) {
+    PutVarint(bytes.size());
+    if (storage_ != nullptr && !bytes.empty()) {
+      memcpy(storage_ + size_, bytes.data(), bytes.size());
+    }
+    size_ += bytes.size();
+  }
+
+  void PutRID(const RID &rid) {
+    PutSigned(rid.GetPageId());
+    PutVarint(rid.GetSlotNum());
+  }
+
+  auto Size() const -> int32_t { return size_; }
+
+ private:
+  char *storage_;
+  int32_t size_{0};
+};
+
+/** LogReader decodes the fields written by LogWriter. Any read past the end of the buffer sets the failed flag. */
+class LogReader {
+ public:
+  LogReader(const char *storage, int32_t available) : pos_(storage), end_(storage + available) {}
+
+  auto GetVarint() -> uint64_t {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      auto byte = GetByte();
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    failed_ = true;
+    return 0;
+  }
+
+  auto GetSigned() -> int64_t { return UnZigZag(GetVarint()); }
+
+  auto GetByte() -> uint8_t {
+    if (pos_ >= end_) {
+      failed_ = true;
+      return 0;
+    }
+    return static_cast<uint8_t>(*pos_++);
+  }
+
+  void GetBytes(std::vector<char> *bytes) {
+    auto size = GetVarint();
+    if (failed_ || size > static_cast<uint64_t>(end_ - pos_)) {
+      failed_ = true;
+      return;
+    }
+    bytes->assign(pos_, pos_ + size);
+    pos_ += size;
+  }
+
+  auto GetRID() -> RID {
+    auto page_id = static_cast<page_id_t>(GetSigned());
+    auto slot_num = static_cast<uint32_t>(GetVarint());
+    return {page_id, slot_num};
+  }
+
+  auto Position() const -> const char * { return pos_; }
+
+  auto Failed() const -> bool { return failed_; }
+
+ private:
+  const char *pos_;
+  const char *end_;
+  bool failed_{false};
+};
+
+}  // namespace
+
+void LogRecord::ComputeUpdateDelta() {
+  const auto &old_data = old_tuple_.data_;
+  const auto &new_data = new_tuple_.data_;
+  size_t max_common = std::min(old_data.size(), new_data.size());
+
+  size_t prefix = 0;
+  while (prefix < max_common && old_data[prefix] == new_data[prefix]) {
+    prefix++;
+  }
+  size_t suffix = 0;
+  while (suffix < max_common - prefix &&
+         old_data[old_data.size() - 1 - suffix] == new_data[new_data.size() - 1 - suffix]) {
+    suffix++;
+  }
+
+  update_offset_ = prefix;
+  old_delta_.assign(old_data.begin() + prefix, old_data.end() - suffix);
+  new_delta_.assign(new_data.begin() + prefix, new_data.end() - suffix);
+}
+
+auto LogRecord::ApplyUpdate(const Tuple &tuple, bool redo) const -> Tuple {
+  BUSTUB_ASSERT(log_record_type_ == LogRecordType::UPDATE, "Only update records carry a delta");
+  const auto &from = redo ? old_delta_ : new_delta_;
+  const auto &to = redo ? new_delta_ : old_delta_;
+  const auto &data = tuple.data_;
+  BUSTUB_ASSERT(data.size() >= update_offset_ + from.size(), "The tuple is too short for this delta");
+
+  Tuple result(update_rid_);
+  result.data_.reserve(data.size() - from.size() + to.size());
+  result.data_.insert(result.data_.end(), data.begin(), data.begin() + update_offset_);
+  result.data_.insert(result.data_.end(), to.begin(), to.end());
+  result.data_.insert(result.data_.end(), data.begin() + update_offset_ + from.size(), data.end());
+  return result;
+}
+
+auto LogRecord::EncodeBody(char *storage) const -> int32_t {
+  LogWriter writer(storage);
+  writer.PutVarint(static_cast<uint32_t>(lsn_));
+  writer.PutSigned(txn_id_);
+  writer.PutVarint(prev_lsn_ == INVALID_LSN ? 0 : static_cast<uint32_t>(lsn_ - prev_lsn_));
+  writer.PutByte(static_cast<uint8_t>(log_record_type_));
+  switch (log_record_type_) {
+    case LogRecordType::INSERT:
+      writer.PutRID(insert_rid_);
+      writer.PutBytes(insert_tuple_.data_);
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      writer.PutRID(delete_rid_);
+      writer.PutBytes(delete_tuple_.data_);
+      break;
+    case LogRecordType::UPDATE:
+      writer.PutRID(update_rid_);
+      writer.PutVarint(update_offset_);
+      writer.PutBytes(old_delta_);
+      writer.PutBytes(new_delta_);
+      break;
+    case LogRecordType::NEWPAGE:
+      writer.PutSigned(prev_page_id_);
+      writer.PutSigned(page_id_);
+      break;
+    case LogRecordType::END_CHECKPOINT:
+      writer.PutVarint(active_txn_table_.size());
+      for (const auto &[txn_id, last_lsn] : active_txn_table_) {
+        writer.PutSigned(txn_id);
+        writer.PutSigned(last_lsn);
+      }
+      writer.PutVarint(dirty_page_table_.size());
+      for (const auto &[page_id, rec_lsn] : dirty_page_table_) {
+        writer.PutSigned(page_id);
+        writer.PutSigned(rec_lsn);
+      }
+      break;
+    default:
+      break;
+  }
+  return writer.Size();
+}
+
+auto LogRecord::GetSerializedSize() const -> int32_t {
+  auto body_size = EncodeBody(nullptr);
+  LogWriter size_field;
+  size_field.PutVarint(body_size);
+  return size_field.Size() + body_size;
+}
+
+auto LogRecord::SerializeTo(char *storage) -> int32_t {
+  auto body_size = EncodeBody(nullptr);
+  LogWriter size_field(storage);
+  size_field.PutVarint(body_size);
+  EncodeBody(storage + size_field.Size());
+  size_ = size_field.Size() + body_size;
+  return size_;
+}
+
+auto LogRecord::DeserializeFrom(const char *storage, int32_t available) -> bool {
+  LogReader size_field(storage, available);
+  auto body_size = size_field.GetVarint();
+  auto header_size = static_cast<int32_t>(size_field.Position() - storage);
+  if (size_field.Failed() || body_size == 0 || body_size > static_cast<uint64_t>(available - header_size)) {
+    return false;
+  }
+
+  LogReader reader(size_field.Position(), static_cast<int32_t>(body_size));
+  lsn_ = static_cast<lsn_t>(reader.GetVarint());
+  txn_id_ = static_cast<txn_id_t>(reader.GetSigned());
+  auto prev_lsn_delta = static_cast<lsn_t>(reader.GetVarint());
+  prev_lsn_ = prev_lsn_delta == 0 ? INVALID_LSN : lsn_ - prev_lsn_delta;
+  log_record_type_ = static_cast<LogRecordType>(reader.GetByte());
+  switch (log_record_type_) {
+    case LogRecordType::INSERT:
+      insert_rid_ = reader.GetRID();
+      reader.GetBytes(&insert_tuple_.data_);
+      insert_tuple_.rid_ = insert_rid_;
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      delete_rid_ = reader.GetRID();
+      reader.GetBytes(&delete_tuple_.data_);
+      delete_tuple_.rid_ = delete_rid_;
+      break;
+    case LogRecordType::UPDATE:
+      has_update_images_ = false;
+      update_rid_ = reader.GetRID();
+      update_offset_ = static_cast<uint32_t>(reader.GetVarint());
+      reader.GetBytes(&old_delta_);
+      reader.GetBytes(&new_delta_);
+      break;
+    case LogRecordType::NEWPAGE:
+      prev_page_id_ = static_cast<page_id_t>(reader.GetSigned());
+      page_id_ = static_cast<page_id_t>(reader.GetSigned());
+      break;
+    case LogRecordType::END_CHECKPOINT: {
+      active_txn_table_.clear();
+      for (auto count = reader.GetVarint(); count > 0 && !reader.Failed(); count--) {
+        auto txn_id = static_cast<txn_id_t>(reader.GetSigned());
+        active_txn_table_.emplace_back(txn_id, static_cast<lsn_t>(reader.GetSigned()));
+      }
+      dirty_page_table_.clear();
+      for (auto count = reader.GetVarint(); count > 0 && !reader.Failed(); count--) {
+        auto page_id = static_cast<page_id_t>(reader.GetSigned());
+        dirty_page_table_.emplace_back(page_id, static_cast<lsn_t>(reader.GetSigned()));
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  if (reader.Failed()) {
+    return false;
+  }
+  size_ = header_size + static_cast<int32_t>(body_size);
+  return true;
+}
+
+}  // namespace bustub
@@ -10,12 +10,13 @@ BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept {
 }
 
 void BasicPageGuard::Drop() {
-  is_dirty_ = false;
   if (page_ == nullptr && bpm_ == nullptr) {
+    is_dirty_ = false;
     return;
   }
   BUSTUB_ASSERT(page_ != nullptr && bpm_ != nullptr, "only one of page and bpm is null");
   bpm_->UnpinPage(page_->GetPageId(), is_dirty_);
+  is_dirty_ = false;
   bpm_ = nullptr;
   page_ = nullptr;
 }
@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_table_page.cpp
+//
+// Identification: src/storage/page/pax_table_page.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/pax_table_page.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "common/exception.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** Null bitmaps are padded to 8 bytes, so that the values of every minipage are 8-byte aligned. */
+auto BitmapSize(uint32_t capacity) -> uint32_t { return (capacity + 63) / 64 * 8; }
+
+auto AlignTo8(uint32_t offset) -> uint32_t { return (offset + 7) & ~7U; }
+
+}  // namespace
+
+auto PaxTablePage::SlotWidth(const Column &column) -> uint32_t {
+  return column.IsInlined() ? column.GetFixedLength() : sizeof(uint16_t);
+}
+
+auto PaxTablePage::LayOut(const Schema &schema, uint32_t capacity, uint16_t *minipage_offsets) -> uint32_t {
+  uint32_t offset =
+      PAX_TABLE_PAGE_HEADER_SIZE + TUPLE_META_SIZE * capacity + sizeof(uint16_t) * schema.GetColumnCount();
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    offset = AlignTo8(offset);
+    if (minipage_offsets != nullptr) {
+      minipage_offsets[i] = offset;
+    }
+    offset += BitmapSize(capacity) + SlotWidth(schema.GetColumn(i)) * capacity;
+  }
+  return offset;
+}
+
+auto PaxTablePage::ComputeCapacity(const Schema &schema) -> uint16_t {
+  uint32_t num_columns = schema.GetColumnCount();
+  uint32_t tuple_size = TUPLE_META_SIZE;
+  for (const auto &column : schema.GetColumns()) {
+    tuple_size += SlotWidth(column);
+    if (!column.IsInlined()) {
+      tuple_size += sizeof(uint32_t) + PAX_EXPECTED_VARLEN_SIZE;
+    }
+  }
+  // Every column costs one bit per tuple for the null bitmap, plus up to 16 bytes of padding and offset.
+  uint32_t fixed_overhead = PAX_TABLE_PAGE_HEADER_SIZE + 16 * num_columns;
+  if (fixed_overhead >= BUSTUB_PAGE_SIZE) {
+    throw Exception("too many columns for a PAX page");
+  }
+  uint32_t capacity = (BUSTUB_PAGE_SIZE - fixed_overhead) * 8 / (8 * tuple_size + num_columns);
+  capacity = std::clamp<uint32_t>(capacity, 1, std::numeric_limits<uint16_t>::max());
+  while (capacity > 1 && LayOut(schema, capacity, nullptr) > BUSTUB_PAGE_SIZE) {
+    capacity--;
+  }
+  if (LayOut(schema, capacity, nullptr) > BUSTUB_PAGE_SIZE) {
+    throw Exception("tuple is too large for a PAX page");
+  }
+  return capacity;
+}
+
+void PaxTablePage::Init(const Schema &schema) {
+  next_page_id_ = INVALID_PAGE_ID;
+  num_tuples_ = 0;
+  num_deleted_tuples_ = 0;
+  capacity_ = ComputeCapacity(schema);
+  varlen_start_ = BUSTUB_PAGE_SIZE;
+  LayOut(schema, capacity_, MinipageOffsets());
+}
+
+auto PaxTablePage::InsertTuple(const Schema &schema, const TupleMeta &meta, const Tuple &tuple)
+    -> std::optional<uint16_t> {
+  if (num_tuples_ == capacity_) {
+    return std::nullopt;
+  }
+  std::vector<Value> values;
+  values.reserve(schema.GetColumnCount());
+  uint32_t varlen_size = 0;
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    values.emplace_back(tuple.GetValue(&schema, i));
+    if (!schema.GetColumn(i).IsInlined() && !values.back().IsNull()) {
+      varlen_size += sizeof(uint32_t) + values.back().GetLength();
+    }
+  }
+  if (varlen_start_ < varlen_size || varlen_start_ - varlen_size < LayOut(schema, capacity_, nullptr)) {
+    return std::nullopt;
+  }
+
+  auto slot = num_tuples_;
+  const auto *minipage_offsets = MinipageOffsets();
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &column = schema.GetColumn(i);
+    auto *bitmap = reinterpret_cast<uint8_t *>(page_start_ + minipage_offsets[i]);
+    char *value_slot = page_start_ + minipage_offsets[i] + BitmapSize(capacity_) + SlotWidth(column) * slot;
+    uint8_t bit = 1U << (slot % 8);
+    if (values[i].IsNull()) {
+      bitmap[slot / 8] |= bit;
+      memset(value_slot, 0, SlotWidth(column));
+      continue;
+    }
+    bitmap[slot / 8] &= ~bit;
+    if (column.IsInlined()) {
+      values[i].SerializeTo(value_slot);
+    } else {
+      varlen_start_ -= sizeof(uint32_t) + values[i].GetLength();
+      values[i].SerializeTo(page_start_ + varlen_start_);
+      memcpy(value_slot, &varlen_start_, sizeof(uint16_t));
+    }
+  }
+  tuple_metas_[slot] = meta;
+  num_tuples_++;
+  return slot;
+}
+
+auto PaxTablePage::CheckSlot(const RID &rid) const -> uint16_t {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  return tuple_id;
+}
+
+void PaxTablePage::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) {
+  auto &old_meta = tuple_metas_[CheckSlot(rid)];
+  if (!old_meta.is_deleted_ && meta.is_deleted_) {
+    num_deleted_tuples_++;
+  }
+  auto new_meta = meta;
+  new_meta.version_ = old_meta.version_ + 1;
+  old_meta = new_meta;
+}
+
+auto PaxTablePage::GetTupleMeta(const RID &rid) const -> TupleMeta { return tuple_metas_[CheckSlot(rid)]; }
+
+auto PaxTablePage::GetValue(const Schema &schema, uint32_t column_idx, uint16_t slot) const -> Value {
+  const auto &column = schema.GetColumn(column_idx);
+  const char *minipage = page_start_ + MinipageOffsets()[column_idx];
+  if ((static_cast<uint8_t>(minipage[slot / 8]) & (1U << (slot % 8))) != 0) {
+    return ValueFactory::GetNullValueByType(column.GetType());
+  }
+  const char *value_slot = minipage + BitmapSize(capacity_) + SlotWidth(column) * slot;
+  if (column.IsInlined()) {
+    return Value::DeserializeFrom(value_slot, column.GetType());
+  }
+  uint16_t varlen_offset;
+  memcpy(&varlen_offset, value_slot, sizeof(uint16_t));
+  return Value::DeserializeFrom(page_start_ + varlen_offset, column.GetType());
+}
+
+auto PaxTablePage::GetTuple(const Schema &schema, const RID &rid) const -> std::pair<TupleMeta, Tuple> {
+  auto slot = CheckSlot(rid);
+  std::vector<Value> values;
+  values.reserve(schema.GetColumnCount());
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    values.emplace_back(GetValue(schema, i, slot));
+  }
+  Tuple tuple(std::move(values), &schema);
+  tuple.rid_ = rid;
+  return std::make_pair(tuple_metas_[slot], std::move(tuple));
+}
+
+auto PaxTablePage::GetValues(const Schema &schema, const RID &rid, const std::vector<uint32_t> &column_ids) const
+    -> std::pair<TupleMeta, std::vector<Value>> {
+  auto slot = CheckSlot(rid);
+  std::vector<Value> values;
+  values.reserve(column_ids.size());
+  for (auto column_idx : column_ids) {
+    values.emplace_back(GetValue(schema, column_idx, slot));
+  }
+  return std::make_pair(tuple_metas_[slot], std::move(values));
+}
+
+}  // namespace bustub
@@ -12,10 +12,13 @@
 
 #include "storage/page/table_page.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <optional>
 #include <tuple>
+#include <vector>
+
 #include "common/config.h"
 #include "common/exception.h"
 #include "storage/table/tuple.h"
@@ -26,54 +29,97 @@ void TablePage::Init() {
   next_page_id_ = INVALID_PAGE_ID;
   num_tuples_ = 0;
   num_deleted_tuples_ = 0;
+  free_space_pointer_ = BUSTUB_PAGE_SIZE;
+  fragmented_bytes_ = 0;
 }
 
-auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t> {
-  size_t slot_end_offset;
-  if (num_tuples_ > 0) {
-    auto &[offset, size, meta] = tuple_info_[num_tuples_ - 1];
-    slot_end_offset = offset;
-  } else {
-    slot_end_offset = BUSTUB_PAGE_SIZE;
+auto TablePage::GetReclaimableSpace() const -> uint32_t {
+  uint32_t reclaimable = fragmented_bytes_;
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    auto &[offset, size, meta] = tuple_info_[tuple_id];
+    if (IsReclaimable(meta)) {
+      reclaimable += size;
+    }
+  }
+  return reclaimable;
+}
+
+void TablePage::Compact() {
+  std::vector<uint16_t> live_tuples;
+  live_tuples.reserve(num_tuples_);
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    auto &[offset, size, meta] = tuple_info_[tuple_id];
+    if (IsReclaimable(meta)) {
+      size = 0;
+    }
+    if (size == 0) {
+      offset = BUSTUB_PAGE_SIZE;
+    } else {
+      live_tuples.push_back(tuple_id);
+    }
+  }
+  // Move the tuples closest to the end of the page first, so that no tuple overwrites one that has not moved yet.
+  std::sort(live_tuples.begin(), live_tuples.end(), [this](uint16_t a, uint16_t b) {
+    return std::get<0>(tuple_info_[a]) > std::get<0>(tuple_info_[b]);
+  });
+  uint16_t data_start = BUSTUB_PAGE_SIZE;
+  for (auto tuple_id : live_tuples) {
+    auto &[offset, size, meta] = tuple_info_[tuple_id];
+    data_start -= size;
+    memmove(page_start_ + data_start, page_start_ + offset, size);
+    offset = data_start;
   }
-  auto tuple_offset = slot_end_offset - tuple.GetLength();
-  auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * (num_tuples_ + 1);
-  if (tuple_offset < offset_size) {
+  free_space_pointer_ = data_start;
+  fragmented_bytes_ = 0;
+}
+
+auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t> {
+  if (GetFreeSpace() < TUPLE_INFO_SIZE + tuple.GetLength()) {
     return std::nullopt;
   }
-  return tuple_offset;
+  return free_space_pointer_ - tuple.GetLength();
 }
 
 auto TablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t> {
   auto tuple_offset = GetNextTupleOffset(meta, tuple);
   if (tuple_offset == std::nullopt) {
-    return std::nullopt;
+    if (GetFreeSpace() + GetReclaimableSpace() < TUPLE_INFO_SIZE + tuple.GetLength()) {
+      return std::nullopt;
+    }
+    Compact();
+    tuple_offset = GetNextTupleOffset(meta, tuple);
   }
   auto tuple_id = num_tuples_;
   tuple_info_[tuple_id] = std::make_tuple(*tuple_offset, tuple.GetLength(), meta);
   num_tuples_++;
+  free_space_pointer_ = *tuple_offset;
   memcpy(page_start_ + *tuple_offset, tuple.data_.data(), tuple.GetLength());
   return tuple_id;
 }
 
-void TablePage::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) {
+auto TablePage::CheckSlot(const RID &rid) const -> uint16_t {
   auto tuple_id = rid.GetSlotNum();
   if (tuple_id >= num_tuples_) {
     throw bustub::Exception("Tuple ID out of range");
   }
-  auto &[offset, size, old_meta] = tuple_info_[tuple_id];
+  return tuple_id;
+}
+
+void TablePage::SetTupleMeta(uint16_t tuple_id, const TupleMeta &meta) {
+  auto &old_meta = std::get<2>(tuple_info_[tuple_id]);
   if (!old_meta.is_deleted_ && meta.is_deleted_) {
     num_deleted_tuples_++;
   }
-  tuple_info_[tuple_id] = std::make_tuple(offset, size, meta);
+  auto new_meta = meta;
+  new_meta.version_ = old_meta.version_ + 1;
+  new_meta.delete_committed_ = meta.is_deleted_ && meta.delete_committed_;
+  old_meta = new_meta;
 }
 
+void TablePage::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) { SetTupleMeta(CheckSlot(rid), meta); }
+
 auto TablePage::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple> {
-  auto tuple_id = rid.GetSlotNum();
-  if (tuple_id >= num_tuples_) {
-    throw bustub::Exception("Tuple ID out of range");
-  }
-  auto &[offset, size, meta] = tuple_info_[tuple_id];
+  auto &[offset, size, meta] = tuple_info_[CheckSlot(rid)];
   Tuple tuple;
   tuple.data_.resize(size);
   memmove(tuple.data_.data(), page_start_ + offset, size);
@@ -81,29 +127,48 @@ auto TablePage::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple> {
   return std::make_pair(meta, std::move(tuple));
 }
 
-auto TablePage::GetTupleMeta(const RID &rid) const -> TupleMeta {
-  auto tuple_id = rid.GetSlotNum();
-  if (tuple_id >= num_tuples_) {
-    throw bustub::Exception("Tuple ID out of range");
-  }
-  auto &[_1, _2, meta] = tuple_info_[tuple_id];
-  return meta;
+auto TablePage::GetTupleData(const RID &rid) const -> std::tuple<TupleMeta, const char *, uint32_t> {
+  auto &[offset, size, meta] = tuple_info_[CheckSlot(rid)];
+  return std::make_tuple(meta, page_start_ + offset, size);
 }
 
+auto TablePage::GetTupleMeta(const RID &rid) const -> TupleMeta { return std::get<2>(tuple_info_[CheckSlot(rid)]); }
+
 void TablePage::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
-  auto tuple_id = rid.GetSlotNum();
-  if (tuple_id >= num_tuples_) {
-    throw bustub::Exception("Tuple ID out of range");
-  }
+  auto tuple_id = CheckSlot(rid);
   auto &[offset, size, old_meta] = tuple_info_[tuple_id];
   if (size != tuple.GetLength()) {
     throw bustub::Exception("Tuple size mismatch");
   }
-  if (!old_meta.is_deleted_ && meta.is_deleted_) {
-    num_deleted_tuples_++;
-  }
-  tuple_info_[tuple_id] = std::make_tuple(offset, size, meta);
+  SetTupleMeta(tuple_id, meta);
   memcpy(page_start_ + offset, tuple.data_.data(), tuple.GetLength());
 }
 
+auto TablePage::UpdateTuple(const TupleMeta &meta, const Tuple &tuple, const RID &rid) -> bool {
+  auto tuple_id = CheckSlot(rid);
+  auto &[offset, size, old_meta] = tuple_info_[tuple_id];
+  uint16_t new_size = tuple.GetLength();
+  if (new_size <= size) {
+    // Shrink in place, the tail of the old data becomes a fragment.
+    fragmented_bytes_ += size - new_size;
+  } else if (GetFreeSpace() >= new_size) {
+    // Move the tuple to the free space, its old data becomes a fragment.
+    fragmented_bytes_ += size;
+    free_space_pointer_ -= new_size;
+    offset = free_space_pointer_;
+  } else if (GetFreeSpace() + GetReclaimableSpace() + (IsReclaimable(old_meta) ? 0 : size) >= new_size) {
+    // Drop the old data and compact the page to make room.
+    size = 0;
+    Compact();
+    free_space_pointer_ -= new_size;
+    offset = free_space_pointer_;
+  } else {
+    return false;
+  }
+  size = new_size;
+  SetTupleMeta(tuple_id, meta);
+  memcpy(page_start_ + offset, tuple.data_.data(), new_size);
+  return true;
+}
+
 }  // namespace bustub
@@ -21,6 +21,7 @@
 #include "concurrency/transaction.h"
 #include "fmt/format.h"
 #include "storage/page/page_guard.h"
+#include "storage/page/pax_table_page.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_heap.h"
 
@@ -36,13 +37,31 @@ TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
   first_page->Init();
 }
 
+TableHeap::TableHeap(BufferPoolManager *bpm, const Schema &schema, TableFormat format)
+    : bpm_(bpm), format_(format), schema_(schema) {
+  auto guard = bpm->NewPageGuarded(&first_page_id_);
+  last_page_id_ = first_page_id_;
+  if (format_ == TableFormat::PAX) {
+    guard.AsMut<PaxTablePage>()->Init(*schema_);
+  } else {
+    guard.AsMut<TablePage>()->Init();
+  }
+  AddZoneMap(first_page_id_);
+}
+
 auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr, Transaction *txn,
                             table_oid_t oid) -> std::optional<RID> {
   std::unique_lock<std::mutex> guard(latch_);
   auto page_guard = bpm_->FetchPageWrite(last_page_id_);
+  std::optional<uint16_t> slot_id;
   while (true) {
     auto page = page_guard.AsMut<TablePage>();
-    if (page->GetNextTupleOffset(meta, tuple) != std::nullopt) {
+    if (format_ == TableFormat::PAX) {
+      slot_id = page_guard.AsMut<PaxTablePage>()->InsertTuple(*schema_, meta, tuple);
+    } else {
+      slot_id = page->InsertTuple(meta, tuple);
+    }
+    if (slot_id != std::nullopt) {
       break;
     }
 
@@ -54,9 +73,13 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
     BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
 
     page->SetNextPageId(next_page_id);
+    AddZoneMap(next_page_id);
 
-    auto next_page = reinterpret_cast<TablePage *>(npg->GetData());
-    next_page->Init();
+    if (format_ == TableFormat::PAX) {
+      reinterpret_cast<PaxTablePage *>(npg->GetData())->Init(*schema_);
+    } else {
+      reinterpret_cast<TablePage *>(npg->GetData())->Init();
+    }
 
     page_guard.Drop();
 
@@ -68,59 +91,172 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
     page_guard = std::move(next_page_guard);
   }
   auto last_page_id = last_page_id_;
-
-  auto page = page_guard.AsMut<TablePage>();
-  auto slot_id = *page->InsertTuple(meta, tuple);
+  UpdateZoneMap(last_page_id, tuple);
+  if (!meta.is_deleted_) {
+    row_count_++;
+  }
 
   // only allow one insertion at a time, otherwise it will deadlock.
   guard.unlock();
 
   if (lock_mgr != nullptr) {
-    BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, RID{last_page_id, slot_id}),
+    BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, RID{last_page_id, *slot_id}),
                   "failed to lock when inserting new tuple");
   }
 
   page_guard.Drop();
 
-  return RID(last_page_id, slot_id);
+  return RID(last_page_id, *slot_id);
 }
 
 void TableHeap::UpdateTupleMeta(const TupleMeta &meta, RID rid) {
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
+  if (format_ == TableFormat::PAX) {
+    auto page = page_guard.AsMut<PaxTablePage>();
+    UpdateRowCount(page->GetTupleMeta(rid), meta);
+    page->UpdateTupleMeta(meta, rid);
+    return;
+  }
   auto page = page_guard.AsMut<TablePage>();
+  UpdateRowCount(page->GetTupleMeta(rid), meta);
   page->UpdateTupleMeta(meta, rid);
 }
 
+void TableHeap::UpdateRowCount(const TupleMeta &old_meta, const TupleMeta &new_meta) {
+  if (old_meta.is_deleted_ && !new_meta.is_deleted_) {
+    row_count_++;
+  } else if (!old_meta.is_deleted_ && new_meta.is_deleted_) {
+    row_count_--;
+  }
+}
+
 auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+  if (format_ == TableFormat::PAX) {
+    return page_guard.As<PaxTablePage>()->GetTuple(*schema_, rid);
+  }
   auto page = page_guard.As<TablePage>();
   auto [meta, tuple] = page->GetTuple(rid);
   tuple.rid_ = rid;
   return std::make_pair(meta, std::move(tuple));
 }
 
+auto TableHeap::GetTupleView(RID rid) -> TupleView {
+  if (format_ == TableFormat::PAX) {
+    throw NotImplementedException("tuple views are only supported on row-format tables");
+  }
+  auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+  auto [meta, data, size] = page_guard.As<TablePage>()->GetTupleData(rid);
+  return {std::move(page_guard), meta, data, size, rid};
+}
+
 auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+  if (format_ == TableFormat::PAX) {
+    return page_guard.As<PaxTablePage>()->GetTupleMeta(rid);
+  }
   auto page = page_guard.As<TablePage>();
   return page->GetTupleMeta(rid);
 }
 
-auto TableHeap::MakeIterator() -> TableIterator {
+auto TableHeap::GetValues(RID rid, const std::vector<uint32_t> &column_ids)
+    -> std::pair<TupleMeta, std::vector<Value>> {
+  auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+  if (format_ == TableFormat::PAX) {
+    return page_guard.As<PaxTablePage>()->GetValues(*schema_, rid, column_ids);
+  }
+  BUSTUB_ASSERT(schema_.has_value(), "the table heap was created without a schema");
+  auto [meta, tuple] = page_guard.As<TablePage>()->GetTuple(rid);
+  std::vector<Value> values;
+  values.reserve(column_ids.size());
+  for (auto column_idx : column_ids) {
+    values.emplace_back(tuple.GetValue(&*schema_, column_idx));
+  }
+  return std::make_pair(meta, std::move(values));
+}
+
+auto TableHeap::MakeIterator(const AbstractExpression *filter) -> TableIterator {
   std::unique_lock<std::mutex> guard(latch_);
   auto last_page_id = last_page_id_;
   guard.unlock();
 
   auto page_guard = bpm_->FetchPageRead(last_page_id);
   auto page = page_guard.As<TablePage>();
-  return {this, {first_page_id_, 0}, {last_page_id, page->GetNumTuples()}};
+  return {this, {first_page_id_, 0}, {last_page_id, page->GetNumTuples()}, filter};
 }
 
-auto TableHeap::MakeEagerIterator() -> TableIterator { return {this, {first_page_id_, 0}, {INVALID_PAGE_ID, 0}}; }
+auto TableHeap::MakeEagerIterator(const AbstractExpression *filter) -> TableIterator {
+  return {this, {first_page_id_, 0}, {INVALID_PAGE_ID, 0}, filter};
+}
+
+void TableHeap::AddZoneMap(page_id_t page_id) {
+  if (!schema_.has_value()) {
+    return;
+  }
+  std::unique_lock<std::shared_mutex> guard(zone_map_latch_);
+  zone_map_index_.emplace(page_id, zone_maps_.size());
+  zone_maps_.emplace_back(page_id, ZoneMap(schema_->GetColumnCount()));
+}
+
+void TableHeap::UpdateZoneMap(page_id_t page_id, const Tuple &tuple) {
+  if (!schema_.has_value()) {
+    return;
+  }
+  std::unique_lock<std::shared_mutex> guard(zone_map_latch_);
+  zone_maps_[zone_map_index_.at(page_id)].second.Update(*schema_, tuple);
+}
+
+auto TableHeap::SkipPages(page_id_t page_id, const AbstractExpression &filter, page_id_t stop_page_id) -> page_id_t {
+  std::shared_lock<std::shared_mutex> guard(zone_map_latch_);
+  auto iter = zone_map_index_.find(page_id);
+  if (iter == zone_map_index_.end()) {
+    return page_id;
+  }
+  for (auto i = iter->second; i < zone_maps_.size(); i++) {
+    const auto &[id, zone_map] = zone_maps_[i];
+    if (zone_map.MayMatch(filter)) {
+      return id;
+    }
+    if (id == stop_page_id) {
+      break;
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+auto TableHeap::GetZoneMap(page_id_t page_id) -> std::optional<ZoneMap> {
+  std::shared_lock<std::shared_mutex> guard(zone_map_latch_);
+  auto iter = zone_map_index_.find(page_id);
+  if (iter == zone_map_index_.end()) {
+    return std::nullopt;
+  }
+  return zone_maps_[iter->second].second;
+}
 
 void TableHeap::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
+  if (format_ == TableFormat::PAX) {
+    throw NotImplementedException("in-place update of a PAX table");
+  }
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
   auto page = page_guard.AsMut<TablePage>();
+  UpdateRowCount(page->GetTupleMeta(rid), meta);
   page->UpdateTupleInPlaceUnsafe(meta, tuple, rid);
+  UpdateZoneMap(rid.GetPageId(), tuple);
+}
+
+auto TableHeap::UpdateTuple(const TupleMeta &meta, const Tuple &tuple, RID rid) -> bool {
+  if (format_ == TableFormat::PAX) {
+    throw NotImplementedException("in-place update of a PAX table");
+  }
+  auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
+  auto page = page_guard.AsMut<TablePage>();
+  auto old_meta = page->GetTupleMeta(rid);
+  if (!page->UpdateTuple(meta, tuple, rid)) {
+    return false;
+  }
+  UpdateRowCount(old_meta, meta);
+  UpdateZoneMap(rid.GetPageId(), tuple);
+  return true;
 }
 
 }  // namespace bustub
@@ -20,8 +20,14 @@
 
 namespace bustub {
 
-TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid)
-    : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid) {
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid, const AbstractExpression *filter)
+    : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid), filter_(filter) {
+  if (filter_ != nullptr) {
+    rid_ = RID{table_heap_->SkipPages(rid_.GetPageId(), *filter_, stop_at_rid_.GetPageId()), 0};
+    if (rid_.GetPageId() == INVALID_PAGE_ID) {
+      return;
+    }
+  }
   // If the rid doesn't correspond to a tuple (i.e., the table has just been initialized), then
   // we set rid_ to invalid.
   auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
@@ -33,6 +39,12 @@ TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid)
 
 auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_); }
 
+auto TableIterator::GetTupleView() -> TupleView { return table_heap_->GetTupleView(rid_); }
+
+auto TableIterator::GetValues(const std::vector<uint32_t> &column_ids) -> std::pair<TupleMeta, std::vector<Value>> {
+  return table_heap_->GetValues(rid_, column_ids);
+}
+
 auto TableIterator::GetRID() -> RID { return rid_; }
 
 auto TableIterator::IsEnd() -> bool { return rid_.GetPageId() == INVALID_PAGE_ID; }
@@ -58,6 +70,9 @@ auto TableIterator::operator++() -> TableIterator & {
     // that's fine
   } else {
     auto next_page_id = page->GetNextPageId();
+    if (filter_ != nullptr && next_page_id != INVALID_PAGE_ID && rid_.GetPageId() != stop_at_rid_.GetPageId()) {
+      next_page_id = table_heap_->SkipPages(next_page_id, *filter_, stop_at_rid_.GetPageId());
+    }
     // if next page is invalid, RID is set to invalid page; otherwise, it's the first tuple in that page.
     rid_ = RID{next_page_id, 0};
   }
@@ -12,60 +12,80 @@
 
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "common/macros.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
-// TODO(Amadou): It does not look like nulls are supported. Add a null bitmap?
 Tuple::Tuple(std::vector<Value> values, const Schema *schema) {
   assert(values.size() == schema->GetColumnCount());
 
   // 1. Calculate the size of the tuple.
-  uint32_t tuple_size = schema->GetLength();
+  uint32_t column_count = schema->GetColumnCount();
+  uint32_t bitmap_offset = schema->GetLength();
+  uint32_t tuple_size = bitmap_offset + NullBitmapSize(column_count);
   for (auto &i : schema->GetUnlinedColumns()) {
-    auto len = values[i].GetLength();
-    if (len == BUSTUB_VALUE_NULL) {
-      len = 0;
+    if (!values[i].IsNull()) {
+      tuple_size += values[i].GetLength();
     }
-    tuple_size += (len + sizeof(uint32_t));
   }
+  BUSTUB_ASSERT(tuple_size <= std::numeric_limits<uint16_t>::max(), "tuple is too large");
 
   // 2. Allocate memory.
   data_.resize(tuple_size);
   std::fill(data_.begin(), data_.end(), 0);
 
   // 3. Serialize each attribute based on the input value.
-  uint32_t column_count = schema->GetColumnCount();
-  uint32_t offset = schema->GetLength();
-
+  uint16_t offset = bitmap_offset + NullBitmapSize(column_count);
   for (uint32_t i = 0; i < column_count; i++) {
     const auto &col = schema->GetColumn(i);
-    if (!col.IsInlined()) {
-      // Serialize relative offset, where the actual varchar data is stored.
-      *reinterpret_cast<uint32_t *>(data_.data() + col.GetOffset()) = offset;
-      // Serialize varchar value, in place (size+data).
-      values[i].SerializeTo(data_.data() + offset);
-      auto len = values[i].GetLength();
-      if (len == BUSTUB_VALUE_NULL) {
-        len = 0;
-      }
-      offset += (len + sizeof(uint32_t));
-    } else {
+    if (values[i].IsNull()) {
+      data_[bitmap_offset + i / 8] |= static_cast<char>(1U << (i % 8));
+    }
+    if (col.IsInlined()) {
+      // Null fixed-size values also keep their sentinel, so that reading the raw bytes sees a null.
       values[i].SerializeTo(data_.data() + col.GetOffset());
+      continue;
     }
+    // Serialize the offset and length of the varchar data, and the data itself. Nulls have no data.
+    uint16_t len = values[i].IsNull() ? 0 : values[i].GetLength();
+    memcpy(data_.data() + col.GetOffset(), &offset, sizeof(uint16_t));
+    memcpy(data_.data() + col.GetOffset() + sizeof(uint16_t), &len, sizeof(uint16_t));
+    if (len != 0) {
+      memcpy(data_.data() + offset, values[i].GetData(), len);
+    }
+    offset += len;
   }
 }
 
 auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
   assert(schema);
-  const TypeId column_type = schema->GetColumn(column_idx).GetType();
-  const char *data_ptr = GetDataPtr(schema, column_idx);
-  // the third parameter "is_inlined" is unused
-  return Value::DeserializeFrom(data_ptr, column_type);
+  if (IsNull(schema, column_idx)) {
+    return ValueFactory::GetNullValueByType(schema->GetColumn(column_idx).GetType());
+  }
+  return ValueAt(data_.data(), schema, column_idx);
+}
+
+auto Tuple::ValueAt(const char *data, const Schema *schema, uint32_t column_idx) -> Value {
+  const auto &col = schema->GetColumn(column_idx);
+  if (col.IsInlined()) {
+    return Value::DeserializeFrom(data + col.GetOffset(), col.GetType());
+  }
+  uint16_t offset;
+  uint16_t len;
+  memcpy(&offset, data + col.GetOffset(), sizeof(uint16_t));
+  memcpy(&len, data + col.GetOffset() + sizeof(uint16_t), sizeof(uint16_t));
+  if (len == 0) {
+    return ValueFactory::GetNullValueByType(col.GetType());
+  }
+  return {col.GetType(), data + offset, len, true};
 }
 
 auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs)
@@ -78,20 +98,6 @@ auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const s
   return {values, &key_schema};
 }
 
-auto Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) const -> const char * {
-  assert(schema);
-  const auto &col = schema->GetColumn(column_idx);
-  bool is_inlined = col.IsInlined();
-  // For inline type, data is stored where it is.
-  if (is_inlined) {
-    return (data_.data() + col.GetOffset());
-  }
-  // We read the relative offset from the tuple data.
-  int32_t offset = *reinterpret_cast<const int32_t *>(data_.data() + col.GetOffset());
-  // And return the beginning address of the real data for the VARCHAR type.
-  return (data_.data() + offset);
-}
-
 auto Tuple::ToString(const Schema *schema) const -> std::string {
   std::stringstream os;
 
@@ -0,0 +1,32 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_view.cpp
+//
+// Identification: src/storage/table/tuple_view.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tuple_view.h"
+
+#include "type/value_factory.h"
+
+namespace bustub {
+
+auto TupleView::GetValue(const Schema *schema, uint32_t column_idx) const -> Value {
+  if (IsNull(schema, column_idx)) {
+    return ValueFactory::GetNullValueByType(schema->GetColumn(column_idx).GetType());
+  }
+  return Tuple::ValueAt(data_, schema, column_idx);
+}
+
+auto TupleView::ToTuple() const -> Tuple {
+  Tuple tuple(rid_);
+  tuple.data_.assign(data_, data_ + size_);
+  return tuple;
+}
+
+}  // namespace bustub
@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.cpp
+//
+// Identification: src/storage/table/zone_map.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/zone_map.h"
+
+#include <optional>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/expressions/parameter_value_expression.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the comparison such that (b flipped a) is equivalent to (a comp_type b) */
+auto Flip(ComparisonType comp_type) -> ComparisonType {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+/** @return whether some value in [min, max] may satisfy (value comp_type constant) */
+auto RangeMayMatch(const Value &min, const Value &max, ComparisonType comp_type, const Value &constant) -> bool {
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return min.CompareLessThanEquals(constant) == CmpBool::CmpTrue &&
+             max.CompareGreaterThanEquals(constant) == CmpBool::CmpTrue;
+    case ComparisonType::NotEqual:
+      return !(min.CompareEquals(constant) == CmpBool::CmpTrue && max.CompareEquals(constant) == CmpBool::CmpTrue);
+    case ComparisonType::LessThan:
+      return min.CompareLessThan(constant) == CmpBool::CmpTrue;
+    case ComparisonType::LessThanOrEqual:
+      return min.CompareLessThanEquals(constant) == CmpBool::CmpTrue;
+    case ComparisonType::GreaterThan:
+      return max.CompareGreaterThan(constant) == CmpBool::CmpTrue;
+    case ComparisonType::GreaterThanOrEqual:
+      return max.CompareGreaterThanEquals(constant) == CmpBool::CmpTrue;
+  }
+  return true;
+}
+
+/** @return the value of a constant or of a bound parameter, nullopt for any other expression */
+auto ConstantOperand(const AbstractExpression &expr) -> std::optional<Value> {
+  if (const auto *constant = dynamic_cast<const ConstantValueExpression *>(&expr); constant != nullptr) {
+    return constant->val_;
+  }
+  if (const auto *parameter = dynamic_cast<const ParameterValueExpression *>(&expr); parameter != nullptr) {
+    const auto *values = ParameterBinding::Current();
+    if (values != nullptr && parameter->param_idx_ < values->size()) {
+      return (*values)[parameter->param_idx_];
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+void ZoneMap::Update(const Schema &schema, const Tuple &tuple) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    auto value = tuple.GetValue(&schema, i);
+    auto &zone = columns_[i];
+    if (value.IsNull()) {
+      zone.null_count_++;
+      continue;
+    }
+    if (!zone.min_.has_value() || value.CompareLessThan(*zone.min_) == CmpBool::CmpTrue) {
+      zone.min_ = value;
+    }
+    if (!zone.max_.has_value() || value.CompareGreaterThan(*zone.max_) == CmpBool::CmpTrue) {
+      zone.max_ = value;
+    }
+  }
+}
+
+auto ZoneMap::MayMatch(const AbstractExpression &predicate) const -> bool {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(&predicate); logic != nullptr) {
+    if (logic->logic_type_ == LogicType::And) {
+      return MayMatch(*logic->GetChildAt(0)) && MayMatch(*logic->GetChildAt(1));
+    }
+    return MayMatch(*logic->GetChildAt(0)) || MayMatch(*logic->GetChildAt(1));
+  }
+
+  if (const auto *constant = dynamic_cast<const ConstantValueExpression *>(&predicate); constant != nullptr) {
+    return constant->val_.GetTypeId() != TypeId::BOOLEAN || constant->val_.IsNull() ||
+           constant->val_.GetAs<int8_t>() != 0;
+  }
+
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(&predicate);
+  if (comparison == nullptr) {
+    return true;
+  }
+  auto comp_type = comparison->comp_type_;
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+  auto constant = ConstantOperand(*comparison->GetChildAt(1));
+  if (column == nullptr || !constant.has_value()) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+    constant = ConstantOperand(*comparison->GetChildAt(0));
+    comp_type = Flip(comp_type);
+  }
+  if (column == nullptr || !constant.has_value() || column->GetTupleIdx() != 0 ||
+      column->GetColIdx() >= columns_.size()) {
+    return true;
+  }
+
+  // A comparison with null is never true, and neither is a comparison on a column that only holds nulls.
+  const auto &zone = columns_[column->GetColIdx()];
+  if (constant->IsNull() || !zone.min_.has_value()) {
+    return false;
+  }
+  if (!zone.min_->CheckComparable(*constant)) {
+    return true;
+  }
+  return RangeMayMatch(*zone.min_, *zone.max_, comp_type, *constant);
+}
+
+}  // namespace bustub
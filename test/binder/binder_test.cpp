@@ -13,6 +13,8 @@
 #include "binder/binder.h"
 #include <memory>
 #include "binder/bound_statement.h"
+#include "binder/statement/analyze_statement.h"
+#include "binder/statement/create_statement.h"
 #include "catalog/catalog.h"
 #include "gtest/gtest.h"
 
@@ -173,6 +175,26 @@ TEST(BinderTest, BindBinaryOp) {
   PrintStatements(statements);
 }
 
+TEST(BinderTest, BindCreatePax) {
+  auto statements = TryBind("create table t (x int, y varchar(16)) with (storage = pax)");
+  PrintStatements(statements);
+  ASSERT_EQ(1, statements.size());
+  EXPECT_EQ(TableFormat::PAX, dynamic_cast<const CreateStatement &>(*statements[0]).format_);
+  statements = TryBind("create table t (x int) with (storage = 'row')");
+  EXPECT_EQ(TableFormat::ROW, dynamic_cast<const CreateStatement &>(*statements[0]).format_);
+  EXPECT_THROW(TryBind("create table t (x int) with (storage = heap)"), Exception);
+}
+
+TEST(BinderTest, BindAnalyze) {
+  auto statements = TryBind("analyze y");
+  PrintStatements(statements);
+  ASSERT_EQ(1, statements.size());
+  EXPECT_EQ(1, dynamic_cast<const AnalyzeStatement &>(*statements[0]).tables_.size());
+  statements = TryBind("analyze");
+  EXPECT_EQ(4, dynamic_cast<const AnalyzeStatement &>(*statements[0]).tables_.size());
+  EXPECT_THROW(TryBind("analyze d"), Exception);
+}
+
 // TODO(chi): subquery is not supported yet
 TEST(BinderTest, DISABLED_BindUncorrelatedSubquery) {
   auto statements = TryBind("select * from (select * from a) INNER JOIN (select * from b) ON a.x = b.y");
@@ -144,4 +144,47 @@ TEST(BufferPoolManagerTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, DirtyPageTableTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const size_t k = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, k);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: Only pages unpinned as dirty show up in the dirty page table.
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+  EXPECT_EQ(true, bpm->UnpinPage(2, true));
+  auto dirty_page_table = bpm->GetDirtyPageTable();
+  EXPECT_EQ(2, dirty_page_table.size());
+
+  // Scenario: Unpinning a dirty page as clean must not lose its dirty flag.
+  EXPECT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  EXPECT_EQ(2, bpm->GetDirtyPageTable().size());
+
+  // Scenario: A flushed page leaves the dirty page table.
+  EXPECT_EQ(true, bpm->FlushPage(0));
+  dirty_page_table = bpm->GetDirtyPageTable();
+  EXPECT_EQ(1, dirty_page_table.size());
+  EXPECT_EQ(2, dirty_page_table[0].first);
+
+  bpm->FlushAllPages();
+  EXPECT_EQ(0, bpm->GetDirtyPageTable().size());
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_statistics_test.cpp
+//
+// Identification: test/catalog/table_statistics_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/table_statistics.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TableStatisticsTest, HyperLogLogTest) {
+  for (int distinct : {10, 1000, 50000}) {
+    HyperLogLog sketch;
+    for (int i = 0; i < 100000; i++) {
+      sketch.Add(ValueFactory::GetIntegerValue(i % distinct));
+    }
+    EXPECT_NEAR(distinct, sketch.Estimate(), distinct * 0.1);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TableStatisticsTest, AnalyzeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  Schema schema{
+      {Column{"id", TypeId::INTEGER}, Column{"category", TypeId::VARCHAR, 16}, Column{"opt", TypeId::BIGINT}}};
+  TableHeap table(bpm.get(), schema, TableFormat::ROW);
+
+  // id is uniform over [0, 20000), category takes 50 values, opt is null one time out of four.
+  const int num_tuples = 20000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    auto opt = i % 4 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT) : ValueFactory::GetBigIntValue(i);
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue("c" + std::to_string(i % 50)), opt},
+                &schema};
+    rids.emplace_back(*table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple));
+  }
+  EXPECT_EQ(num_tuples, table.GetRowCount());
+
+  // Deleted rows leave the row count, and ANALYZE skips them.
+  for (int i = num_tuples - 1000; i < num_tuples; i++) {
+    table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+  }
+  EXPECT_EQ(num_tuples - 1000, table.GetRowCount());
+
+  auto stats = TableStatistics::Analyze(&table, schema);
+  EXPECT_EQ(num_tuples - 1000, stats.GetRowCount());
+
+  const auto &id = stats.GetColumnStatistics(0);
+  EXPECT_NEAR(num_tuples - 1000, id.distinct_count_, num_tuples * 0.1);
+  EXPECT_EQ(0, id.null_fraction_);
+  // The bounds come from a sample of the rows.
+  EXPECT_LE(id.histogram_bounds_.front().GetAs<int32_t>(), 50);
+  EXPECT_GE(id.histogram_bounds_.back().GetAs<int32_t>(), num_tuples - 1050);
+  EXPECT_NEAR(0.25, id.EstimateSelectivity(ComparisonType::LessThan, ValueFactory::GetIntegerValue(4750)), 0.05);
+  EXPECT_NEAR(0.5, id.EstimateSelectivity(ComparisonType::GreaterThanOrEqual, ValueFactory::GetIntegerValue(9500)),
+              0.05);
+  EXPECT_EQ(0, id.EstimateSelectivity(ComparisonType::Equal, ValueFactory::GetIntegerValue(-1)));
+  EXPECT_EQ(0, id.EstimateSelectivity(ComparisonType::GreaterThan, ValueFactory::GetIntegerValue(num_tuples)));
+
+  const auto &category = stats.GetColumnStatistics(1);
+  EXPECT_NEAR(50, category.distinct_count_, 5);
+  EXPECT_NEAR(0.02, category.EstimateSelectivity(ComparisonType::Equal, ValueFactory::GetVarcharValue("c7")), 0.005);
+
+  const auto &opt = stats.GetColumnStatistics(2);
+  EXPECT_NEAR(0.25, opt.null_fraction_, 0.02);
+  EXPECT_NEAR(0.75, opt.EstimateSelectivity(ComparisonType::GreaterThanOrEqual, ValueFactory::GetBigIntValue(0)),
+              0.02);
+}
+
+}  // namespace bustub
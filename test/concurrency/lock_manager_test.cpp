@@ -322,4 +322,92 @@ void AbortTest1() {
 
 TEST(LockManagerTest, DISABLED_RowAbortTest1) { AbortTest1(); }  // NOLINT
 
+void EscalationTest1() {
+  LockManager lock_mgr{};
+  TransactionManager txn_mgr{&lock_mgr};
+  table_oid_t oid = 0;
+  auto old_threshold = lock_escalation_threshold.load();
+  lock_escalation_threshold = 4;
+
+  auto *txn1 = txn_mgr.Begin();
+  auto *txn2 = txn_mgr.Begin();
+  EXPECT_TRUE(lock_mgr.LockTable(txn1, LockManager::LockMode::INTENTION_EXCLUSIVE, oid));
+  EXPECT_TRUE(lock_mgr.LockTable(txn2, LockManager::LockMode::INTENTION_SHARED, oid));
+
+  /** txn2 holds IS, so txn1 can not escalate to X and keeps its row locks */
+  for (uint32_t slot = 0; slot < 5; slot++) {
+    EXPECT_TRUE(lock_mgr.LockRow(txn1, LockManager::LockMode::EXCLUSIVE, oid, RID{0, slot}));
+  }
+  CheckTxnRowLockSize(txn1, oid, 0, 5);
+  EXPECT_EQ(0, lock_mgr.GetEscalationCount());
+
+  /** Once txn2 is gone, the next row lock escalates */
+  txn_mgr.Commit(txn2);
+  EXPECT_TRUE(lock_mgr.LockRow(txn1, LockManager::LockMode::EXCLUSIVE, oid, RID{0, 5}));
+  CheckTxnRowLockSize(txn1, oid, 0, 0);
+  CheckTableLockSizes(txn1, 0, 1, 0, 0, 0);
+  EXPECT_EQ(1, lock_mgr.GetEscalationCount());
+  EXPECT_EQ(6, lock_mgr.GetEscalatedRowLockCount());
+
+  /** Rows are now covered by the table lock */
+  EXPECT_TRUE(lock_mgr.LockRow(txn1, LockManager::LockMode::EXCLUSIVE, oid, RID{0, 6}));
+  CheckTxnRowLockSize(txn1, oid, 0, 0);
+  EXPECT_TRUE(lock_mgr.UnlockRow(txn1, oid, RID{0, 6}, true));
+  CheckGrowing(txn1);
+
+  txn_mgr.Commit(txn1);
+  CheckCommitted(txn1);
+  CheckTableLockSizes(txn1, 0, 0, 0, 0, 0);
+
+  lock_escalation_threshold = old_threshold;
+  delete txn1;
+  delete txn2;
+}
+
+TEST(LockManagerTest, EscalationTest1) { EscalationTest1(); }  // NOLINT
+
+void EscalationTest2() {
+  LockManager lock_mgr{};
+  TransactionManager txn_mgr{&lock_mgr};
+  table_oid_t oid = 0;
+  auto old_threshold = lock_escalation_threshold.load();
+  lock_escalation_threshold = 4;
+
+  /** Unlocked rows do not keep a lock request queue */
+  auto *txn0 = txn_mgr.Begin();
+  EXPECT_TRUE(lock_mgr.LockTable(txn0, LockManager::LockMode::INTENTION_SHARED, oid));
+  EXPECT_TRUE(lock_mgr.LockRow(txn0, LockManager::LockMode::SHARED, oid, RID{0, 0}));
+  EXPECT_EQ(1, lock_mgr.GetRowLockQueueCount());
+  EXPECT_TRUE(lock_mgr.UnlockRow(txn0, oid, RID{0, 0}));
+  EXPECT_EQ(0, lock_mgr.GetRowLockQueueCount());
+  txn_mgr.Commit(txn0);
+
+  auto *txn1 = txn_mgr.Begin();
+  EXPECT_TRUE(lock_mgr.LockTable(txn1, LockManager::LockMode::INTENTION_EXCLUSIVE, oid));
+  for (uint32_t slot = 0; slot < 5; slot++) {
+    EXPECT_TRUE(lock_mgr.LockRow(txn1, LockManager::LockMode::EXCLUSIVE, oid, RID{0, slot}));
+  }
+  EXPECT_EQ(1, lock_mgr.GetEscalationCount());
+  CheckTxnRowLockSize(txn1, oid, 0, 0);
+  /** The queues of the escalated rows are gone with their locks */
+  EXPECT_EQ(0, lock_mgr.GetRowLockQueueCount());
+
+  /** Unlocking an escalated row is valid and shrinks the transaction */
+  EXPECT_TRUE(lock_mgr.UnlockRow(txn1, oid, RID{0, 0}));
+  CheckShrinking(txn1);
+
+  /** A row that was never locked is not covered by the escalation */
+  EXPECT_THROW(lock_mgr.UnlockRow(txn1, oid, RID{0, 9}), TransactionAbortException);
+  CheckAborted(txn1);
+  txn_mgr.Abort(txn1);
+  CheckTableLockSizes(txn1, 0, 0, 0, 0, 0);
+  EXPECT_EQ(0, lock_mgr.GetRowLockQueueCount());
+
+  lock_escalation_threshold = old_threshold;
+  delete txn0;
+  delete txn1;
+}
+
+TEST(LockManagerTest, EscalationTest2) { EscalationTest2(); }  // NOLINT
+
 }  // namespace bustub
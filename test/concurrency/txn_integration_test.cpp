@@ -5,6 +5,7 @@
 #include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
+#include <future>  // NOLINT
 #include <memory>
 #include <random>
 #include <sstream>
@@ -15,6 +16,10 @@
 #include <vector>
 
 #include "common_checker.h"  // NOLINT
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -55,4 +60,148 @@ TEST(IsolationLevelTest, DISABLED_InsertTestA) {
                ExpectedOutcome::DirtyRead);
 }
 
+/** Holds every log write until the gate is opened. */
+class GatedLogDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void WriteLog(char *log_data, int size) override {
+    gate_.wait();
+    num_log_writes_++;
+  }
+
+  std::promise<void> open_;
+  std::shared_future<void> gate_{open_.get_future()};
+  std::atomic<int> num_log_writes_{0};
+};
+
+// NOLINTNEXTLINE
+TEST(CommitAbortTest, EarlyLockReleaseTest) {
+  GatedLogDiskManager disk_manager;
+  LogManager log_manager(&disk_manager);
+  LockManager lock_manager;
+  TransactionManager txn_manager(&lock_manager, &log_manager);
+  log_manager.RunFlushThread();
+
+  auto *holder = txn_manager.Begin();
+  ASSERT_TRUE(lock_manager.LockTable(holder, LockManager::LockMode::EXCLUSIVE, 0));
+  std::atomic<bool> committed{false};
+  std::thread committer([&] {
+    txn_manager.Commit(holder);
+    committed = true;
+  });
+
+  // The lock is released while the commit record is still waiting for the disk, and Commit has not returned.
+  auto *waiter = txn_manager.Begin();
+  ASSERT_TRUE(lock_manager.LockTable(waiter, LockManager::LockMode::EXCLUSIVE, 0));
+  auto commit_lsn = holder->GetPrevLSN();
+  EXPECT_FALSE(committed);
+  EXPECT_LT(log_manager.GetPersistentLSN(), commit_lsn);
+
+  disk_manager.open_.set_value();
+  committer.join();
+  EXPECT_EQ(TransactionState::COMMITTED, holder->GetState());
+  EXPECT_GE(log_manager.GetPersistentLSN(), commit_lsn);
+
+  txn_manager.Commit(waiter);
+  EXPECT_GE(log_manager.GetPersistentLSN(), waiter->GetPrevLSN());
+  log_manager.StopFlushThread();
+  delete holder;
+  delete waiter;
+}
+
+// NOLINTNEXTLINE
+TEST(CommitAbortTest, GroupCommitTest) {
+  const int num_txns = 16;
+  GatedLogDiskManager disk_manager;
+  LogManager log_manager(&disk_manager);
+  LockManager lock_manager;
+  TransactionManager txn_manager(&lock_manager, &log_manager);
+  log_manager.RunFlushThread();
+
+  std::vector<Transaction *> txns;
+  for (int i = 0; i < num_txns; i++) {
+    txns.emplace_back(txn_manager.Begin());
+  }
+  auto first_commit_lsn = log_manager.GetNextLSN();
+  std::vector<std::thread> committers;
+  for (auto *txn : txns) {
+    committers.emplace_back([&txn_manager, txn] { txn_manager.Commit(txn); });
+  }
+  // Wait for every commit record while the disk is held back.
+  while (log_manager.GetNextLSN() < first_commit_lsn + num_txns) {
+    std::this_thread::yield();
+  }
+  disk_manager.open_.set_value();
+  for (auto &committer : committers) {
+    committer.join();
+  }
+
+  // The committers waiting on the same flush share its disk write.
+  EXPECT_LT(disk_manager.num_log_writes_, num_txns);
+  for (auto *txn : txns) {
+    EXPECT_EQ(TransactionState::COMMITTED, txn->GetState());
+    EXPECT_GE(log_manager.GetPersistentLSN(), txn->GetPrevLSN());
+    delete txn;
+  }
+  log_manager.StopFlushThread();
+}
+
+// NOLINTNEXTLINE
+TEST(OptimisticTest, ReadValidationTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto txn_manager = std::make_unique<TransactionManager>(lock_manager.get());
+  TableHeap table(bpm.get());
+  Schema schema{{Column{"x", TypeId::INTEGER}}};
+  auto rid = *table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false},
+                                Tuple{{ValueFactory::GetIntegerValue(1)}, &schema});
+
+  // A read that nobody wrote to validates.
+  auto *reader = txn_manager->Begin();
+  reader->SetOptimistic(true);
+  reader->AppendTableReadRecord({0, rid, &table, table.GetTupleMeta(rid).version_});
+  txn_manager->Commit(reader);
+  EXPECT_EQ(TransactionState::COMMITTED, reader->GetState());
+  delete reader;
+
+  // A read overwritten before commit does not.
+  reader = txn_manager->Begin();
+  reader->SetOptimistic(true);
+  reader->AppendTableReadRecord({0, rid, &table, table.GetTupleMeta(rid).version_});
+  table.UpdateTupleInPlaceUnsafe(table.GetTupleMeta(rid), Tuple{{ValueFactory::GetIntegerValue(2)}, &schema}, rid);
+  EXPECT_THROW(txn_manager->Commit(reader), TransactionAbortException);
+  EXPECT_EQ(TransactionState::ABORTED, reader->GetState());
+  delete reader;
+
+  // Nor one whose tuple changed so many times that a 16-bit version would be back to the one read.
+  reader = txn_manager->Begin();
+  reader->SetOptimistic(true);
+  reader->AppendTableReadRecord({0, rid, &table, table.GetTupleMeta(rid).version_});
+  for (int i = 0; i < (1 << 16); i++) {
+    table.UpdateTupleMeta(table.GetTupleMeta(rid), rid);
+  }
+  EXPECT_THROW(txn_manager->Commit(reader), TransactionAbortException);
+  delete reader;
+
+  // Neither does a read of a tuple another transaction is still deleting.
+  auto *writer = txn_manager->Begin();
+  auto meta = table.GetTupleMeta(rid);
+  meta.delete_txn_id_ = writer->GetTransactionId();
+  meta.is_deleted_ = true;
+  table.UpdateTupleMeta(meta, rid);
+  reader = txn_manager->Begin();
+  reader->SetOptimistic(true);
+  reader->AppendTableReadRecord({0, rid, &table, table.GetTupleMeta(rid).version_});
+  EXPECT_THROW(txn_manager->Commit(reader), TransactionAbortException);
+  delete reader;
+
+  // Committing the writer clears its marker and makes the delete final.
+  EXPECT_FALSE(table.GetTupleMeta(rid).delete_committed_);
+  writer->AppendTableWriteRecord({0, rid, &table});
+  txn_manager->Commit(writer);
+  EXPECT_EQ(INVALID_TXN_ID, table.GetTupleMeta(rid).delete_txn_id_);
+  EXPECT_TRUE(table.GetTupleMeta(rid).delete_committed_);
+  delete writer;
+}
+
 }  // namespace bustub
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// plan_test_util.h
+//
+// Identification: test/include/plan_test_util.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** @return the optimized plan of query, as printed by `explain (o)` */
+inline auto Explain(BustubInstance *bustub, const std::string &query) -> std::string {
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true);
+  bustub->ExecuteSql("explain (o) " + query, writer);
+  return ss.str();
+}
+
+/** @return the result of query, with the columns separated by a space and the rows ended by a newline */
+inline auto Execute(BustubInstance *bustub, const std::string &query) -> std::string {
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true, " ");
+  bustub->ExecuteSql(query, writer);
+  return ss.str();
+}
+
+/** Insert num_rows rows (i, i % 10) into a table of two integer columns, without logging nor locking */
+inline void FillTable(BustubInstance *bustub, const std::string &table_name, int num_rows) {
+  auto *table_info = bustub->catalog_->GetTable(table_name);
+  for (int i = 0; i < num_rows; i++) {
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i % 10)}, &table_info->schema_};
+    table_info->table_->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple);
+  }
+}
+
+/** @return the lines of the plan, without the section header and the trailing padding of the writer */
+inline auto Lines(const std::string &plan) -> std::vector<std::string> {
+  std::vector<std::string> lines;
+  std::stringstream ss(plan);
+  for (std::string line; std::getline(ss, line);) {
+    line.erase(line.find_last_not_of(" \t") + 1);
+    if (!line.empty() && line.rfind("===", 0) != 0) {
+      lines.emplace_back(line);
+    }
+  }
+  return lines;
+}
+
+}  // namespace bustub
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_only_scan_test.cpp
+//
+// Identification: test/optimizer/index_only_scan_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "plan_test_util.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(IndexOnlyScanTest, IndexScanTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  auto writer = NoopWriter();
+  bustub->ExecuteSql("create table t(a int, b int, c int);", writer);
+  bustub->ExecuteSql("create index t_ab on t(a, b);", writer);
+
+  // Every column read is in the key: the scan outputs the key and never fetches the rows.
+  auto plan = Lines(Explain(bustub.get(), "select a, b from t where a = 1 and b > 2;"));
+  ASSERT_EQ(1, plan.size());
+  EXPECT_EQ("IndexScan { index_oid=0, key_prefix=[1], range=(2, +inf), index_only=true }", plan[0]);
+
+  // The residual filter is rewritten over the key columns.
+  plan = Lines(Explain(bustub.get(), "select b from t where a = 1 and b + 1 = 3;"));
+  ASSERT_EQ(2, plan.size());
+  EXPECT_EQ("Projection { exprs=[#0.1] }", plan[0]);
+  EXPECT_EQ("  IndexScan { index_oid=0, key_prefix=[1], filter=((#0.1+1)=3), index_only=true }", plan[1]);
+
+  // c is not in the key, the rows are fetched from the table.
+  plan = Lines(Explain(bustub.get(), "select a, c from t where a = 1;"));
+  ASSERT_EQ(2, plan.size());
+  EXPECT_EQ("Projection { exprs=[#0.0, #0.2] }", plan[0]);
+  EXPECT_EQ("  IndexScan { index_oid=0, key_prefix=[1] }", plan[1]);
+}
+
+// NOLINTNEXTLINE
+TEST(IndexOnlyScanTest, NestedIndexJoinTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  auto writer = NoopWriter();
+  bustub->ExecuteSql("create table small(x int, y int);", writer);
+  bustub->ExecuteSql("create table big(x int, y int);", writer);
+  bustub->ExecuteSql("create index big_x on big(x);", writer);
+  FillTable(bustub.get(), "small", 10);
+  FillTable(bustub.get(), "big", 10000);
+
+  // Only the key of the inner table is read, the probes return it from the index.
+  auto plan = Explain(bustub.get(), "select small.y, big.x from small, big where small.x = big.x;");
+  EXPECT_NE(std::string::npos, plan.find("NestedIndexJoin { type=Inner, key_predicate=#0.0, index=big_x")) << plan;
+  EXPECT_NE(std::string::npos, plan.find("index_only=true")) << plan;
+
+  // big.y is not in the key.
+  plan = Explain(bustub.get(), "select small.y, big.y from small, big where small.x = big.x;");
+  EXPECT_NE(std::string::npos, plan.find("NestedIndexJoin")) << plan;
+  EXPECT_EQ(std::string::npos, plan.find("index_only=true")) << plan;
+}
+
+// NOLINTNEXTLINE
+TEST(IndexOnlyScanTest, VarcharKeyTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  auto writer = NoopWriter();
+  bustub->ExecuteSql("create table t(a int, s varchar(32));", writer);
+  auto *table_info = bustub->catalog_->GetTable("t");
+  auto key_schema = Schema::CopySchema(&table_info->schema_, {1});
+  bustub->catalog_->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      nullptr, "t_s", "t", table_info->schema_, key_schema, {1}, 8, HashFunction<GenericKey<8>>{});
+
+  // The key keeps the first 8 bytes of the key tuple only, the string has to be read from the table.
+  auto plan = Lines(Explain(bustub.get(), "select s from (select * from t order by s);"));
+  ASSERT_EQ(2, plan.size());
+  EXPECT_EQ("  IndexScan { index_oid=0 }", plan[1]);
+}
+
+}  // namespace bustub
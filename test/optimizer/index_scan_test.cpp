@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_scan_test.cpp
+//
+// Identification: test/optimizer/index_scan_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "plan_test_util.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** Create t(a, b, c) with an index on (a, b), and rows a = i, b = i % 10, c = i % 100. */
+void CreateTable(BustubInstance *bustub, int num_rows) {
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true);
+  bustub->ExecuteSql("create table t(a int, b int, c int);", writer);
+  bustub->ExecuteSql("create index t_ab on t(a, b);", writer);
+  auto *table_info = bustub->catalog_->GetTable("t");
+  for (int i = 0; i < num_rows; i++) {
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i % 10),
+                 ValueFactory::GetIntegerValue(i % 100)},
+                &table_info->schema_};
+    table_info->table_->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple);
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(IndexScanTest, KeyRangeTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  CreateTable(bustub.get(), 1000);
+
+  // Equality on the first key column, a range on the second, the rest filters the fetched tuples.
+  auto plan = Explain(bustub.get(), "select * from t where a = 1 and 3 < b and c = 2;");
+  EXPECT_NE(std::string::npos, plan.find("IndexScan { index_oid=0, key_prefix=[1], range=(3, +inf), filter=(#0.2=2) }"))
+      << plan;
+  EXPECT_EQ(std::string::npos, plan.find("SeqScan")) << plan;
+
+  // Every key column fixed is a point lookup.
+  plan = Explain(bustub.get(), "select * from t where b = 2 and a = 1;");
+  EXPECT_NE(std::string::npos, plan.find("IndexScan { index_oid=0, key_prefix=[1, 2] }")) << plan;
+
+  // Without a condition on the first key column, the index cannot narrow the scan.
+  plan = Explain(bustub.get(), "select * from t where b = 2;");
+  EXPECT_NE(std::string::npos, plan.find("SeqScan { table=t }")) << plan;
+}
+
+// NOLINTNEXTLINE
+TEST(IndexScanTest, SelectivityTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  CreateTable(bustub.get(), 1000);
+
+  // Without statistics, a range is assumed to keep a third of the table: reading it all is cheaper.
+  auto plan = Explain(bustub.get(), "select * from t where a >= 990;");
+  EXPECT_NE(std::string::npos, plan.find("SeqScan { table=t }")) << plan;
+
+  // The histograms show the range keeps 1% of the rows.
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true);
+  bustub->ExecuteSql("analyze t;", writer);
+  plan = Explain(bustub.get(), "select * from t where a >= 990;");
+  EXPECT_NE(std::string::npos, plan.find("IndexScan { index_oid=0, range=[990, +inf) }")) << plan;
+
+  // A wide range still reads the whole table.
+  plan = Explain(bustub.get(), "select * from t where a < 800;");
+  EXPECT_NE(std::string::npos, plan.find("SeqScan { table=t }")) << plan;
+}
+
+}  // namespace bustub
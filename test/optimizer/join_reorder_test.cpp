@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_reorder_test.cpp
+//
+// Identification: test/optimizer/join_reorder_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "plan_test_util.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(JoinReorderTest, AvoidCrossProductTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+  // Written order joins the two 1m tables first, with no predicate between them.
+  auto plan = Explain(bustub.get(),
+                      "select * from __mock_t4_1m a, __mock_t5_1m b, __mock_t1 c "
+                      "where a.x = c.x and b.x = c.x and c.y > 10;");
+  EXPECT_EQ(std::string::npos, plan.find("NestedLoopJoin")) << plan;
+  EXPECT_EQ(2, [&] {
+    int count = 0;
+    for (auto pos = plan.find("HashJoin"); pos != std::string::npos; pos = plan.find("HashJoin", pos + 1)) {
+      count++;
+    }
+    return count;
+  }()) << plan;
+  // The filter on c is pushed below the joins.
+  EXPECT_NE(std::string::npos, plan.find("Filter { predicate=(#0.1>10) }")) << plan;
+}
+
+// NOLINTNEXTLINE
+TEST(JoinReorderTest, NestedIndexJoinTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true);
+  bustub->ExecuteSql("create table small(x int, y int);", writer);
+  bustub->ExecuteSql("create table big(x int, y int);", writer);
+  bustub->ExecuteSql("create index big_x on big(x);", writer);
+  FillTable(bustub.get(), "small", 10);
+  FillTable(bustub.get(), "big", 10000);
+
+  // A few probes into the index beat scanning the big table, whatever the written order.
+  for (const auto *query : {"select * from small, big where small.x = big.x;",
+                            "select * from big, small where big.x = small.x;"}) {
+    auto plan = Explain(bustub.get(), query);
+    EXPECT_NE(std::string::npos, plan.find("NestedIndexJoin { type=Inner, key_predicate=#0.0, index=big_x")) << plan;
+    EXPECT_NE(std::string::npos, plan.find("SeqScan { table=small }")) << plan;
+    EXPECT_EQ(std::string::npos, plan.find("SeqScan { table=big }")) << plan;
+  }
+
+  // Without an index on the join key, the small table builds the hash table.
+  auto plan = Explain(bustub.get(), "select * from small, big where small.y = big.y;");
+  ASSERT_NE(std::string::npos, plan.find("HashJoin")) << plan;
+  EXPECT_LT(plan.find("SeqScan { table=big }"), plan.find("SeqScan { table=small }")) << plan;
+}
+
+}  // namespace bustub
@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// limit_pushdown_test.cpp
+//
+// Identification: test/optimizer/limit_pushdown_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "plan_test_util.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LimitPushdownTest, ScanLimitTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  auto writer = NoopWriter();
+  bustub->ExecuteSql("create table t(a int, b int, c int);", writer);
+
+  // The limit stays on top. Its hint goes through the projection, and the filter moves into the scan, which stops
+  // after 3 matching rows.
+  auto plan = Lines(Explain(bustub.get(), "select a + 1 from t where c > 2 limit 3;"));
+  ASSERT_EQ(4, plan.size());
+  EXPECT_EQ("Limit { limit=3 }", plan[0]);
+  EXPECT_EQ("  Projection { exprs=[(#0.0+1)] }", plan[1]);
+  EXPECT_EQ("      SeqScan { table=t, filter=(#0.2>2), limit=3 }", plan[3]);
+
+  // Nested limits keep the smallest one.
+  plan = Lines(Explain(bustub.get(), "select * from (select * from t limit 10) limit 5;"));
+  ASSERT_EQ(2, plan.size());
+  EXPECT_EQ("Limit { limit=5 }", plan[0]);
+  EXPECT_EQ("  SeqScan { table=t, limit=5 }", plan[1]);
+
+  // Without an index to read the order from, a limit over a sort is a top N.
+  plan = Lines(Explain(bustub.get(), "select c from t order by c limit 2;"));
+  EXPECT_EQ("TopN { n=2, order_bys=[(Default, #0.0)]}", plan[0]);
+}
+
+// NOLINTNEXTLINE
+TEST(LimitPushdownTest, IndexOrderTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  auto writer = NoopWriter();
+  bustub->ExecuteSql("create table t(a int, b int, c int);", writer);
+  bustub->ExecuteSql("create index t_ab on t(a, b);", writer);
+
+  // The index returns the rows in order, the scan stops after the first 3.
+  auto plan = Lines(Explain(bustub.get(), "select * from t order by a, b limit 3;"));
+  ASSERT_EQ(2, plan.size());
+  EXPECT_EQ("Limit { limit=3 }", plan[0]);
+  EXPECT_EQ("  IndexScan { index_oid=0, limit=3 }", plan[1]);
+
+  // A prefix of the key columns is ordered too.
+  plan = Lines(Explain(bustub.get(), "select * from t order by a limit 3;"));
+  EXPECT_EQ("  IndexScan { index_oid=0, limit=3 }", plan[1]);
+
+  // With `a` fixed, a key range is ordered by `b`.
+  plan = Lines(Explain(bustub.get(), "select * from t where a = 1 order by b limit 4;"));
+  ASSERT_EQ(2, plan.size());
+  EXPECT_EQ("  IndexScan { index_oid=0, key_prefix=[1], limit=4 }", plan[1]);
+
+  // A filter over the index scan keeps its order.
+  plan = Lines(Explain(bustub.get(), "select * from t where c = 1 order by a, b;"));
+  ASSERT_EQ(2, plan.size());
+  EXPECT_EQ("Filter { predicate=(#0.2=1) }", plan[0]);
+  EXPECT_EQ("  IndexScan { index_oid=0 }", plan[1]);
+
+  // The index is not ordered by `b` alone, nor descending.
+  plan = Lines(Explain(bustub.get(), "select * from t order by b limit 3;"));
+  EXPECT_EQ("TopN { n=3, order_bys=[(Default, #0.1)]}", plan[0]);
+  plan = Lines(Explain(bustub.get(), "select * from t order by a desc limit 3;"));
+  EXPECT_EQ("TopN { n=3, order_bys=[(Descending, #0.0)]}", plan[0]);
+}
+
+}  // namespace bustub
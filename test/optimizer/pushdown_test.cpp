@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pushdown_test.cpp
+//
+// Identification: test/optimizer/pushdown_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "plan_test_util.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PushdownTest, PredicatePushdownTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+
+  // Through a subquery, and below an inner join to the side each conjunct reads.
+  auto plan = Lines(Explain(bustub.get(),
+                            "select * from (select x, y from __mock_t1) a, __mock_t7 b "
+                            "where a.x = b.v and a.y > 10 and b.v1 < 3;"));
+  ASSERT_EQ(6, plan.size());
+  EXPECT_EQ("HashJoin { type=Inner, left_key=[#0.0], right_key=[#1.0] }", plan[0]);
+  EXPECT_EQ("  Filter { predicate=(#0.1>10) }", plan[1]);
+  EXPECT_EQ("  Filter { predicate=(#0.1<3) }", plan[4]);
+
+  // Group key conjuncts of HAVING filter the rows before the aggregation, the others stay above it.
+  plan = Lines(Explain(bustub.get(), "select x, count(*) from __mock_t1 group by x having x > 3 and count(*) > 2;"));
+  ASSERT_EQ(6, plan.size());
+  EXPECT_EQ("  Filter { predicate=(#0.1>2) }", plan[1]);
+  EXPECT_EQ("      Filter { predicate=(#0.0>3) }", plan[3]);
+
+  // Left join: the preserved side gets the WHERE conjunct, the other side the ON conjunct, and a WHERE conjunct
+  // over the padded side stays above the join.
+  plan = Lines(Explain(bustub.get(),
+                       "select * from __mock_t4_1m a left join __mock_t1 c on a.x = c.x and c.y = 1 "
+                       "where a.y = 2 and c.z = 3;"));
+  ASSERT_EQ(6, plan.size());
+  EXPECT_EQ("Filter { predicate=(#0.4=3) }", plan[0]);
+  EXPECT_EQ("  HashJoin { type=Left, left_key=[#0.0], right_key=[#1.0] }", plan[1]);
+  EXPECT_EQ("    Filter { predicate=(#0.1=2) }", plan[2]);
+  EXPECT_EQ("    Filter { predicate=(#0.1=1) }", plan[4]);
+
+  // Without group keys, the aggregation returns a row even if nothing passes the filter.
+  plan = Lines(Explain(bustub.get(), "select * from (select count(*) as c from __mock_t1) where c > 0;"));
+  EXPECT_EQ("Filter { predicate=(#0.0>0) }", plan[0]);
+}
+
+// NOLINTNEXTLINE
+TEST(PushdownTest, ColumnPruningTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+
+  // Only z is read, the scan output is narrowed before the aggregation.
+  auto plan = Lines(Explain(bustub.get(), "select count(*) from __mock_t1 where z > 1;"));
+  ASSERT_EQ(4, plan.size());
+  EXPECT_EQ("Agg { types=[count_star], aggregates=[1], group_by=[] }", plan[0]);
+  EXPECT_EQ("  Filter { predicate=(#0.0>1) }", plan[1]);
+  EXPECT_EQ("    Projection { exprs=[#0.2] }", plan[2]);
+
+  // The join carries only the join keys and the selected column.
+  plan = Lines(Explain(bustub.get(), "select a.z from __mock_t1 a, __mock_t7 b where a.x = b.v;"));
+  ASSERT_EQ(6, plan.size());
+  EXPECT_EQ("Projection { exprs=[#0.1] }", plan[0]);
+  EXPECT_EQ("    Projection { exprs=[#0.0, #0.2] }", plan[2]);
+  EXPECT_EQ("    Projection { exprs=[#0.0] }", plan[4]);
+
+  // Unused aggregates are not computed.
+  plan = Lines(Explain(bustub.get(), "select s from (select x, sum(y) as s, max(z) as m from __mock_t1 group by x);"));
+  EXPECT_NE(std::string::npos, plan[1].find("types=[sum], aggregates=[#0.1]")) << plan[1];
+}
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// simplify_expressions_test.cpp
+//
+// Identification: test/optimizer/simplify_expressions_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "plan_test_util.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(SimplifyExpressionsTest, ConstantFoldingTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+
+  // Arithmetic over constants is computed once.
+  auto plan = Lines(Explain(bustub.get(), "select * from __mock_table_1 where colA = 1 + 2;"));
+  ASSERT_EQ(2, plan.size());
+  EXPECT_EQ("Filter { predicate=(#0.0=3) }", plan[0]);
+  EXPECT_EQ("3 300 \n", Execute(bustub.get(), "select * from __mock_table_1 where colA = 1 + 2;"));
+
+  // Neutral operands are dropped, and a filter that is always true with them.
+  plan = Lines(Explain(bustub.get(), "select * from __mock_table_1 where 1 = 1 and colA < 3;"));
+  EXPECT_EQ("Filter { predicate=(#0.0<3) }", plan[0]);
+  plan = Lines(Explain(bustub.get(), "select * from __mock_table_1 where colA > 1 or 2 > 1;"));
+  ASSERT_EQ(1, plan.size());
+  EXPECT_EQ("MockScan { table=__mock_table_1 }", plan[0]);
+
+  // A filter that is never true returns no row without scanning.
+  plan = Lines(Explain(bustub.get(), "select * from __mock_table_1 where 1 = 2 and colA < 3;"));
+  ASSERT_EQ(1, plan.size());
+  EXPECT_EQ("Values { rows=0 }", plan[0]);
+  EXPECT_EQ("", Execute(bustub.get(), "select * from __mock_table_1 where 1 = 2 and colA < 3;"));
+
+  // String functions over constants.
+  EXPECT_EQ("ABC 0-\U0001F4A9 \n",
+            Execute(bustub.get(), "select upper('abc'), lower(colF) from __mock_table_3 where colE < 1;"));
+}
+
+// NOLINTNEXTLINE
+TEST(SimplifyExpressionsTest, ShortCircuitOrderTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+
+  // The cheap equality is evaluated first, the string function only for the rows it keeps.
+  auto plan = Lines(Explain(bustub.get(), "select * from __mock_table_3 where lower(colF) = 'a' and colE = 3;"));
+  EXPECT_EQ("Filter { predicate=((#0.0=3)and(lower(#0.1)=a)) }", plan[0]);
+}
+
+// NOLINTNEXTLINE
+TEST(SimplifyExpressionsTest, CommonSubexpressionTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+
+  // lower(colF) is computed once per row, below the filter.
+  auto plan = Lines(Explain(bustub.get(), "select * from __mock_table_3 where lower(colF) = upper(lower(colF));"));
+  ASSERT_EQ(4, plan.size());
+  EXPECT_EQ("Projection { exprs=[#0.0, #0.1] }", plan[0]);
+  EXPECT_EQ("  Filter { predicate=(#0.2=upper(#0.2)) }", plan[1]);
+  EXPECT_EQ("    Projection { exprs=[#0.0, #0.1, lower(#0.1)] }", plan[2]);
+
+  // Also when the second occurrence may be skipped by OR, the first one is always evaluated.
+  plan = Lines(
+      Explain(bustub.get(), "select * from __mock_table_3 where lower(colF) = '1-a' or lower(colF) = '2-b';"));
+  ASSERT_EQ(4, plan.size());
+  EXPECT_EQ("Projection { exprs=[#0.0, #0.1] }", plan[0]);
+  EXPECT_EQ("  Filter { predicate=((#0.2=1-a)or(#0.2=2-b)) }", plan[1]);
+  EXPECT_EQ("    Projection { exprs=[#0.0, #0.1, lower(#0.1)] }", plan[2]);
+
+  // Not when every occurrence is under a short-circuited operand.
+  plan = Lines(Explain(bustub.get(),
+                       "select * from __mock_table_3 where colE = 3 and (lower(colF) = 'a' or lower(colF) = 'b');"));
+  ASSERT_EQ(2, plan.size());
+  EXPECT_EQ("Filter { predicate=((#0.0=3)and((lower(#0.1)=a)or(lower(#0.1)=b))) }", plan[0]);
+
+  // The same in a projection.
+  const auto *query = "select colA + colB, colA + colB + 1 from __mock_table_1 where colA < 3;";
+  plan = Lines(Explain(bustub.get(), query));
+  EXPECT_EQ("Projection { exprs=[#0.2, (#0.2+1)] }", plan[0]);
+  EXPECT_EQ("  Projection { exprs=[#0.0, #0.1, (#0.0+#0.1)] }", plan[1]);
+  EXPECT_EQ("0 1 \n101 102 \n202 203 \n", Execute(bustub.get(), query));
+}
+
+}  // namespace bustub
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// subquery_test.cpp
+//
+// Identification: test/optimizer/subquery_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "plan_test_util.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(SubqueryTest, SemiJoinTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  auto writer = NoopWriter();
+  bustub->ExecuteSql("create table t1 (a int, b int);", writer);
+  bustub->ExecuteSql("create table t2 (x int, y int);", writer);
+
+  // The correlated conjunct becomes the key of a semi join, the local one filters the subquery.
+  auto plan = Lines(Explain(bustub.get(), "select * from t1 where exists (select * from t2 where t2.x = t1.a "
+                                          "and t2.y > 3);"));
+  ASSERT_EQ(4, plan.size());
+  EXPECT_EQ("HashJoin { type=Semi, left_key=[#0.0], right_key=[#1.0] }", plan[0]);
+  EXPECT_EQ("  Filter { predicate=(#0.1>3) }", plan[2]);
+
+  // NOT EXISTS is an anti join on its correlated conjuncts.
+  plan = Lines(Explain(bustub.get(), "select * from t1 where b > 1 and not exists (select * from t2 where t2.x = t1.a "
+                                     "and t2.y = t1.b);"));
+  EXPECT_EQ("HashJoin { type=Anti, left_key=[#0.0, #0.1], right_key=[#1.0, #1.1] }", plan[0]);
+  EXPECT_EQ("  Filter { predicate=(#0.1>1) }", plan[1]);
+
+  // An uncorrelated IN subquery is planned on its own.
+  plan = Lines(Explain(bustub.get(), "select * from t1 where a in (select x + 1 from t2);"));
+  EXPECT_EQ("HashJoin { type=Semi, left_key=[#0.0], right_key=[#1.0] }", plan[0]);
+
+  // Without an equality there is no hash key, the semi join stays a nested loop join.
+  plan = Lines(Explain(bustub.get(), "select * from t1 where exists (select * from t2 where t2.x > t1.a);"));
+  EXPECT_EQ("NestedLoopJoin { type=Semi, predicate=(#1.0>#0.0) }", plan[0]);
+}
+
+// NOLINTNEXTLINE
+TEST(SubqueryTest, ScalarSubqueryTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  auto writer = NoopWriter();
+  bustub->ExecuteSql("create table t1 (a int, b int);", writer);
+  bustub->ExecuteSql("create table t2 (x int, y int);", writer);
+
+  // A correlated aggregate is grouped by its correlation key and joined on it.
+  auto plan = Lines(Explain(bustub.get(), "select a, (select max(y) from t2 where t2.x = t1.a) from t1;"));
+  EXPECT_EQ("  HashJoin { type=Left, left_key=[#0.0], right_key=[#1.0] }", plan[1]);
+  EXPECT_EQ("    Agg { types=[max], aggregates=[#0.1], group_by=[#0.0] }", plan[4]);
+
+  // An uncorrelated aggregate returns a single row, joined to every row.
+  plan = Lines(Explain(bustub.get(), "select * from t1 where b > (select max(y) from t2);"));
+  EXPECT_EQ("  Filter { predicate=(#0.1>#0.2) }", plan[1]);
+  EXPECT_EQ("    NestedLoopJoin { type=Left, predicate=true }", plan[2]);
+}
+
+// NOLINTNEXTLINE
+TEST(SubqueryTest, UnsupportedSubqueryTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  auto writer = NoopWriter();
+  bustub->ExecuteSql("create table t1 (a int, b int);", writer);
+  bustub->ExecuteSql("create table t2 (x int, y int);", writer);
+
+  // COUNT over no rows is 0, where the left join pads NULL.
+  EXPECT_THROW(Explain(bustub.get(), "select * from t1 where b > (select count(*) from t2 where t2.x = t1.a);"),
+               Exception);
+  // A scalar subquery that may return several rows.
+  EXPECT_THROW(Explain(bustub.get(), "select * from t1 where b = (select x from t2);"), Exception);
+  // EXISTS under OR cannot be a semi join.
+  EXPECT_THROW(Explain(bustub.get(), "select * from t1 where a = 1 or exists (select * from t2);"),
+               Exception);
+  // NOT IN is not an anti join: with a NULL in the subquery or as the argument the condition is NULL, and the row is
+  // filtered out.
+  EXPECT_THROW(Explain(bustub.get(), "select * from t1 where a not in (select x from t2);"), Exception);
+  EXPECT_THROW(Explain(bustub.get(), "select * from t1 where b > 1 and a not in (select x from t2 where t2.y = t1.b);"),
+               Exception);
+  // A subquery must return a single column.
+  EXPECT_THROW(Explain(bustub.get(), "select * from t1 where a in (select x, y from t2);"), Exception);
+}
+
+}  // namespace bustub
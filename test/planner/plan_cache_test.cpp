@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// plan_cache_test.cpp
+//
+// Identification: test/planner/plan_cache_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "plan_test_util.h"
+#include "planner/plan_cache.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PlanCacheTest, ParameterizeQueryTest) {
+  auto query = ParameterizeQuery("SELECT x FROM t  WHERE x = -10 AND y = 'a''b'; -- comment");
+  ASSERT_TRUE(query.has_value());
+  EXPECT_EQ("select x from t where x = $1 and y = $2", query->query_);
+  ASSERT_EQ(2, query->parameters_.size());
+  EXPECT_EQ(-10, query->parameters_[0].GetAs<int32_t>());
+  EXPECT_EQ("a'b", query->parameters_[1].ToString());
+
+  // Queries that only differ in their constants and spacing share a text.
+  EXPECT_EQ(query->query_, ParameterizeQuery("select x from t where x=3 and y='c'")->query_);
+
+  // A minus between two operands stays a binary minus.
+  query = ParameterizeQuery("select 3 - 2;");
+  ASSERT_TRUE(query.has_value());
+  EXPECT_EQ("select $1 - $2", query->query_);
+
+  // The planner needs the count of a LIMIT as a constant.
+  query = ParameterizeQuery("select * from t limit 10");
+  ASSERT_TRUE(query.has_value());
+  EXPECT_EQ("select * from t limit 10", query->query_);
+  EXPECT_TRUE(query->parameters_.empty());
+
+  EXPECT_FALSE(ParameterizeQuery("create table t(x int);").has_value());
+  EXPECT_FALSE(ParameterizeQuery("select 1; select 2;").has_value());
+  EXPECT_FALSE(ParameterizeQuery("select $1").has_value());
+}
+
+// NOLINTNEXTLINE
+TEST(PlanCacheTest, EvictionTest) {
+  PlanCache cache(2);
+  auto plan = std::make_shared<CachedPlan>();
+  cache.Put("a", {}, 0, plan);
+  cache.Put("b", {}, 0, plan);
+  cache.Put("b", {TypeId::INTEGER}, 0, plan);
+  EXPECT_EQ(2, cache.Size());
+
+  // The least recently used plan was evicted, and the types of the parameters are part of the key.
+  EXPECT_EQ(nullptr, cache.Get("a", {}, 0));
+  EXPECT_EQ(plan, cache.Get("b", {}, 0));
+  EXPECT_EQ(plan, cache.Get("b", {TypeId::INTEGER}, 0));
+
+  // A plan of an older catalog version is dropped.
+  EXPECT_EQ(nullptr, cache.Get("b", {}, 1));
+  EXPECT_EQ(1, cache.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(PlanCacheTest, AutoParameterizationTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+
+  EXPECT_EQ("3 \n", Execute(bustub.get(), "select 1 + 2;"));
+  EXPECT_EQ("7 \n", Execute(bustub.get(), "select 3 + 4;"));
+  EXPECT_EQ("-1 \n", Execute(bustub.get(), "select -5 + 4;"));
+  EXPECT_EQ(1, bustub->plan_cache_.Size());
+
+  EXPECT_EQ("300 \n", Execute(bustub.get(), "select colB from __mock_table_1 where colA = 3;"));
+  EXPECT_EQ("5000 \n", Execute(bustub.get(), "select colB from __mock_table_1 where colA = 50;"));
+  EXPECT_EQ(2, bustub->plan_cache_.Size());
+  const std::string query = "select colB from __mock_table_1 where colA = $1";
+  EXPECT_NE(nullptr, bustub->plan_cache_.Get(query, {TypeId::INTEGER}, bustub->catalog_->GetVersion()));
+
+  // Creating a table changes the catalog version: the stale plan is replaced when the query comes again.
+  Execute(bustub.get(), "create table t(x int);");
+  EXPECT_EQ("3 \n", Execute(bustub.get(), "select 1 + 2;"));
+  EXPECT_EQ(2, bustub->plan_cache_.Size());
+  EXPECT_EQ(nullptr, bustub->plan_cache_.Get(query, {TypeId::INTEGER}, bustub->catalog_->GetVersion()));
+}
+
+// NOLINTNEXTLINE
+TEST(PlanCacheTest, CustomPlanTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  auto writer = NoopWriter();
+  bustub->ExecuteSql("create table t(a int, b int);", writer);
+  bustub->ExecuteSql("create index t_a on t(a);", writer);
+  FillTable(bustub.get(), "t", 1000);
+  bustub->ExecuteSql("analyze t;", writer);
+
+  // The plan that runs is the one EXPLAIN shows: the optimizer sees the constants of each execution.
+  for (const auto *query : {"select * from t where a >= 990;", "select * from t where a >= 10;",
+                            "select * from t where b = 1 + 2;"}) {
+    auto plan = bustub->ExecutedPlan(query);
+    ASSERT_NE(nullptr, plan);
+    EXPECT_EQ(Lines(Explain(bustub.get(), query)), Lines(plan->ToString(false)));
+  }
+  // The histograms make a narrow range an index scan, a wide one a sequential scan.
+  EXPECT_EQ("IndexScan { index_oid=0, range=[990, +inf) }",
+            Lines(bustub->ExecutedPlan("select * from t where a >= 990;")->ToString(false))[0]);
+  EXPECT_EQ("Filter { predicate=(#0.0>=10) }",
+            Lines(bustub->ExecutedPlan("select * from t where a >= 10;")->ToString(false))[0]);
+  EXPECT_EQ("Filter { predicate=(#0.1=3) }",
+            Lines(bustub->ExecutedPlan("select * from t where b = 1 + 2;")->ToString(false))[0]);
+
+  // Only a plan that does not depend on the constants is reused as is.
+  auto version = bustub->catalog_->GetVersion();
+  auto cached = bustub->plan_cache_.Get("select * from t where a >= $1", {TypeId::INTEGER}, version);
+  ASSERT_NE(nullptr, cached);
+  EXPECT_EQ(nullptr, cached->generic_plan_);
+  ASSERT_NE(nullptr, bustub->ExecutedPlan("select b from t limit 3;"));
+  cached = bustub->plan_cache_.Get("select b from t limit 3", {}, version);
+  ASSERT_NE(nullptr, cached);
+  EXPECT_NE(nullptr, cached->generic_plan_);
+}
+
+// NOLINTNEXTLINE
+TEST(PlanCacheTest, PrepareExecuteTest) {
+  auto bustub = std::make_unique<BustubInstance>();
+
+  Execute(bustub.get(), "prepare add_one(int) as select $1 + 1;");
+  EXPECT_EQ("42 \n", Execute(bustub.get(), "execute add_one(41);"));
+  // Arguments are cast to the declared types.
+  EXPECT_EQ("6 \n", Execute(bustub.get(), "execute add_one('5');"));
+
+  Execute(bustub.get(), "prepare concat as select $1, $2;");
+  EXPECT_EQ("1 x \n", Execute(bustub.get(), "execute concat(1, 'x');"));
+
+  // Wrong argument counts and unknown statements are errors.
+  EXPECT_THROW(Execute(bustub.get(), "execute add_one(1, 2);"), Exception);
+  EXPECT_THROW(Execute(bustub.get(), "execute missing(1);"), Exception);
+}
+
+}  // namespace bustub
@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// spool_test.cpp
+//
+// Identification: test/planner/spool_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "execution/executor_context.h"
+#include "execution/executor_factory.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/spool_plan.h"
+#include "execution/plans/values_plan.h"
+#include "gtest/gtest.h"
+#include "plan_test_util.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto Count(const std::string &text, const std::string &pattern) -> size_t {
+  size_t count = 0;
+  for (auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+    count++;
+  }
+  return count;
+}
+
+auto IntValues(const SchemaRef &schema, const std::vector<int> &values) -> AbstractPlanNodeRef {
+  std::vector<std::vector<AbstractExpressionRef>> rows;
+  for (auto value : values) {
+    rows.push_back({std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(value))});
+  }
+  return std::make_shared<ValuesPlanNode>(schema, std::move(rows));
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(SpoolTest, SharedCTETest) {
+  auto bustub = std::make_unique<BustubInstance>();
+  auto writer = NoopWriter();
+  bustub->ExecuteSql("create table t1 (x int, y int);", writer);
+
+  // Both references read the same spool, the CTE is computed once.
+  auto plan = Explain(bustub.get(),
+                      "with t as (select x as p, y as q from t1 where x > 1) select * from t a, t b where a.p = b.q;");
+  EXPECT_EQ(2, Count(plan, "Spool { id=0 }")) << plan;
+
+  // A CTE referenced once is planned inline.
+  plan = Explain(bustub.get(), "with t as (select x as p, y as q from t1 where x > 1) select * from t where p = 3;");
+  EXPECT_EQ(0, Count(plan, "Spool")) << plan;
+
+  // Each CTE referenced several times gets its own spool.
+  plan = Explain(bustub.get(),
+                 "with t as (select x as p from t1), u as (select y as q from t1) "
+                 "select * from t a, t b, u c, u d where a.p = b.p and c.q = d.q;");
+  EXPECT_EQ(2, Count(plan, "Spool { id=0 }")) << plan;
+  EXPECT_EQ(2, Count(plan, "Spool { id=1 }")) << plan;
+
+  // A CTE with an aggregation is planned once.
+  plan = Explain(bustub.get(),
+                 "with m as (select x as p, max(y) as q from t1 group by x) select * from m a, m b where a.p = b.q;");
+  EXPECT_EQ(2, Count(plan, "Spool { id=0 }")) << plan;
+  EXPECT_EQ(2, Count(plan, "Agg")) << plan;
+}
+
+// NOLINTNEXTLINE
+TEST(SpoolTest, SpoolExecutorTest) {
+  auto exec_ctx = std::make_unique<ExecutorContext>(nullptr, nullptr, nullptr, nullptr, nullptr, false);
+  auto schema = std::make_shared<Schema>(std::vector<Column>{Column("x", TypeId::INTEGER)});
+
+  // The readers of a spool share the rows of the first one initialized, and rewind on every Init.
+  AbstractPlanNodeRef first_plan = std::make_shared<SpoolPlanNode>(schema, IntValues(schema, {1, 2, 3}), 0);
+  AbstractPlanNodeRef second_plan = std::make_shared<SpoolPlanNode>(schema, IntValues(schema, {4}), 0);
+  auto first = ExecutorFactory::CreateExecutor(exec_ctx.get(), first_plan);
+  auto second = ExecutorFactory::CreateExecutor(exec_ctx.get(), second_plan);
+  first->Init();
+  second->Init();
+  for (int pass = 0; pass < 2; pass++) {
+    second->Init();
+    std::vector<int> rows;
+    Tuple tuple;
+    RID rid;
+    while (second->Next(&tuple, &rid)) {
+      rows.emplace_back(tuple.GetValue(schema.get(), 0).GetAs<int32_t>());
+    }
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), rows);
+  }
+  EXPECT_EQ(3, exec_ctx->GetSpool(0).tuples_.size());
+}
+
+}  // namespace bustub
@@ -1,4 +1,7 @@
 #include <fmt/format.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <functional>
 #include <memory>
 #include <numeric>
@@ -47,6 +50,30 @@ TEST(TrieStoreTest, GuardTest) {
   ASSERT_EQ(**guard, "2333");
 }
 
+TEST(TrieStoreTest, BatchTest) {
+  auto store = TrieStore();
+  std::vector<std::pair<std::string, std::string>> entries;
+  for (uint32_t i = 0; i < 1000; i++) {
+    entries.emplace_back(fmt::format("{:#05}", i), fmt::format("value-{:#08}", i));
+  }
+  store.PutBatch(std::move(entries));
+
+  std::vector<std::string> keys;
+  for (uint32_t i = 0; i < 1000; i += 2) {
+    keys.push_back(fmt::format("{:#05}", i));
+  }
+  store.RemoveBatch(keys);
+
+  for (uint32_t i = 0; i < 1000; i++) {
+    auto guard = store.Get<std::string>(fmt::format("{:#05}", i));
+    if (i % 2 == 0) {
+      ASSERT_EQ(guard, std::nullopt);
+    } else {
+      ASSERT_EQ(**guard, fmt::format("value-{:#08}", i));
+    }
+  }
+}
+
 TEST(TrieStoreTest, MixedTest) {
   auto store = TrieStore();
   for (uint32_t i = 0; i < 23333; i++) {
@@ -121,4 +148,38 @@ TEST(TrieStoreTest, MixedConcurrentTest) {
   }
 }
 
+TEST(TrieStoreTest, EpochSlotsExhaustedTest) {
+  auto store = TrieStore();
+  store.Put<uint32_t>("a", 1);
+  std::vector<ValueGuard<uint32_t>> guards;
+  for (size_t i = 0; i < EpochManager::NUM_SLOTS; i++) {
+    guards.emplace_back(*store.Get<uint32_t>("a"));
+  }
+
+  // With no epoch slot left, readers fall back to the latest snapshot, which follows every version a writer
+  // publishes.
+  const uint32_t num_writes = 2000;
+  std::atomic<uint32_t> written{0};
+  std::thread writer([&store, &written] {
+    for (uint32_t i = 0; i < num_writes; i++) {
+      store.Put<uint32_t>(fmt::format("key-{}", i), i);
+      written = i + 1;
+    }
+  });
+  for (uint32_t seen = 0; seen < num_writes;) {
+    seen = written;
+    if (seen > 0) {
+      auto guard = store.Get<uint32_t>(fmt::format("key-{}", seen - 1));
+      ASSERT_NE(guard, std::nullopt);
+      ASSERT_EQ(**guard, seen - 1);
+    }
+    ASSERT_EQ(**store.Get<uint32_t>("a"), 1);
+  }
+  writer.join();
+
+  guards.clear();
+  store.Remove("a");
+  ASSERT_EQ(store.Get<uint32_t>("a"), std::nullopt);
+}
+
 }  // namespace bustub
@@ -1,6 +1,7 @@
 #include <fmt/format.h>
 #include <bitset>
 #include <functional>
+#include <map>
 #include <numeric>
 #include <optional>
 #include <random>
@@ -240,6 +241,114 @@ TEST(TrieTest, MixedTest) {
   }
 }
 
+TEST(TrieTest, WideFanoutTest) {
+  // Every byte value as the first character, inserted in a scrambled order, so that one node holds 256 children.
+  auto trie = Trie();
+  for (uint32_t i = 0; i < 256; i++) {
+    auto ch = static_cast<char>((i * 73) % 256);
+    trie = trie.Put<uint32_t>(std::string(1, ch) + "x", i);
+  }
+  for (uint32_t i = 0; i < 256; i++) {
+    auto ch = static_cast<char>((i * 73) % 256);
+    ASSERT_EQ(*trie.Get<uint32_t>(std::string(1, ch) + "x"), i);
+    ASSERT_EQ(trie.Get<uint32_t>(std::string(1, ch) + "y"), nullptr);
+  }
+  auto removed = trie.Remove(std::string(1, '\x80') + "x");
+  ASSERT_EQ(removed.Get<uint32_t>(std::string(1, '\x80') + "x"), nullptr);
+  ASSERT_NE(trie.Get<uint32_t>(std::string(1, '\x80') + "x"), nullptr);
+  ASSERT_NE(removed.Get<uint32_t>(std::string(1, '\x7f') + "x"), nullptr);
+}
+
+TEST(TrieTest, BatchTest) {
+  auto trie = Trie();
+  trie = trie.Put<uint32_t>("test", 1);
+  trie = trie.Put<uint32_t>("toast", 2);
+
+  std::vector<std::pair<std::string, uint32_t>> entries{
+      {"test", 10}, {"te", 11}, {"tea", 12}, {"", 13}, {"tea", 14}, {"team", 15}};
+  auto batch = trie.PutBatch(std::move(entries));
+  ASSERT_EQ(*batch.Get<uint32_t>("test"), 10);
+  ASSERT_EQ(*batch.Get<uint32_t>("te"), 11);
+  ASSERT_EQ(*batch.Get<uint32_t>("tea"), 14);
+  ASSERT_EQ(*batch.Get<uint32_t>(""), 13);
+  ASSERT_EQ(*batch.Get<uint32_t>("team"), 15);
+  ASSERT_EQ(*batch.Get<uint32_t>("toast"), 2);
+  // The original trie is unchanged.
+  ASSERT_EQ(*trie.Get<uint32_t>("test"), 1);
+  ASSERT_EQ(trie.Get<uint32_t>("tea"), nullptr);
+  ASSERT_EQ(trie.Get<uint32_t>(""), nullptr);
+
+  auto removed = batch.RemoveBatch({"tea", "test", "missing", "", "toast"});
+  ASSERT_EQ(removed.Get<uint32_t>("tea"), nullptr);
+  ASSERT_EQ(removed.Get<uint32_t>("test"), nullptr);
+  ASSERT_EQ(removed.Get<uint32_t>(""), nullptr);
+  ASSERT_EQ(removed.Get<uint32_t>("toast"), nullptr);
+  ASSERT_EQ(*removed.Get<uint32_t>("te"), 11);
+  ASSERT_EQ(*removed.Get<uint32_t>("team"), 15);
+  ASSERT_EQ(*batch.Get<uint32_t>("tea"), 14);
+
+  // Removing only missing keys returns the same trie.
+  auto same = removed.RemoveBatch({"missing", "t"});
+  ASSERT_EQ(same.Get<uint32_t>("te"), removed.Get<uint32_t>("te"));
+}
+
+TEST(TrieTest, CompressedPathTest) {
+  // Keys sharing long prefixes, so that inserts split compressed paths and removes merge them back.
+  auto trie = Trie();
+  trie = trie.Put<uint32_t>("compressed-path-a", 1);
+  trie = trie.Put<uint32_t>("compressed-path-b", 2);
+  trie = trie.Put<uint32_t>("compressed", 3);
+  trie = trie.Put<uint32_t>("comp", 4);
+  auto before_remove = trie;
+  ASSERT_EQ(*trie.Get<uint32_t>("compressed-path-a"), 1);
+  ASSERT_EQ(*trie.Get<uint32_t>("compressed-path-b"), 2);
+  ASSERT_EQ(*trie.Get<uint32_t>("compressed"), 3);
+  ASSERT_EQ(*trie.Get<uint32_t>("comp"), 4);
+  ASSERT_EQ(trie.Get<uint32_t>("compressed-path"), nullptr);
+  ASSERT_EQ(trie.Get<uint32_t>("compressed-path-c"), nullptr);
+  ASSERT_EQ(trie.Get<uint32_t>("compresses"), nullptr);
+  ASSERT_EQ(trie.Get<uint32_t>("co"), nullptr);
+
+  trie = trie.Remove("compressed-path-a");
+  trie = trie.Remove("compressed");
+  ASSERT_EQ(trie.Get<uint32_t>("compressed-path-a"), nullptr);
+  ASSERT_EQ(trie.Get<uint32_t>("compressed"), nullptr);
+  ASSERT_EQ(*trie.Get<uint32_t>("compressed-path-b"), 2);
+  ASSERT_EQ(*trie.Get<uint32_t>("comp"), 4);
+  trie = trie.Put<uint32_t>("compressed-path-a", 5);
+  ASSERT_EQ(*trie.Get<uint32_t>("compressed-path-a"), 5);
+  ASSERT_EQ(*before_remove.Get<uint32_t>("compressed-path-a"), 1);
+  ASSERT_EQ(*before_remove.Get<uint32_t>("compressed"), 3);
+
+  // Random operations on a small alphabet, checked against a map.
+  std::mt19937 gen(42);
+  std::map<std::string, uint32_t> expected{{"compressed-path-a", 5}, {"compressed-path-b", 2}, {"comp", 4}};
+  for (uint32_t round = 0; round < 2000; round++) {
+    std::string key(gen() % 12, 'a');
+    for (auto &ch : key) {
+      ch = static_cast<char>('a' + gen() % 3);
+    }
+    if (gen() % 3 == 0) {
+      trie = trie.Remove(key);
+      expected.erase(key);
+    } else {
+      trie = trie.Put<uint32_t>(key, round);
+      expected[key] = round;
+    }
+    if (round % 100 == 0) {
+      for (const auto &[k, v] : expected) {
+        ASSERT_EQ(*trie.Get<uint32_t>(k), v);
+      }
+    }
+  }
+  for (const auto &[k, v] : expected) {
+    ASSERT_EQ(*trie.Get<uint32_t>(k), v);
+    trie = trie.Remove(k);
+    ASSERT_EQ(trie.Get<uint32_t>(k), nullptr);
+  }
+  ASSERT_EQ(trie.Get<uint32_t>(""), nullptr);
+}
+
 TEST(TrieTest, PointerStability) {
   auto trie = Trie();
   trie = trie.Put<uint32_t>("test", 2333);
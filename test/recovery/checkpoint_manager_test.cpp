@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// checkpoint_manager_test.cpp
+//
+// Identification: test/recovery/checkpoint_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <future>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "recovery/checkpoint_manager.h"
+#include "recovery/log_manager.h"
+#include "recovery/log_record.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+namespace {
+
+/** Remembers how far the log was persistent when each page was written. */
+class RecordingDiskManager : public DiskManager {
+ public:
+  using DiskManager::DiskManager;
+
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    persistent_lsn_at_write_[page_id] = log_manager_->GetPersistentLSN();
+    DiskManager::WritePage(page_id, page_data);
+  }
+
+  LogManager *log_manager_{nullptr};
+  std::unordered_map<page_id_t, lsn_t> persistent_lsn_at_write_;
+};
+
+/** Holds every log write until open_ is set. */
+class GatedLogDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void WriteLog(char *log_data, int size) override { gate_.wait(); }
+
+  std::promise<void> open_;
+  std::shared_future<void> gate_{open_.get_future()};
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(CheckpointManagerTest, FuzzyCheckpointTest) {
+  const std::string db_name = "checkpoint_test.db";
+  const std::string log_name = "checkpoint_test.log";
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+  const int num_pages = 2 * CHECKPOINT_FLUSH_BATCH + 1;
+
+  auto *disk_manager = new RecordingDiskManager(db_name);
+  auto *log_manager = new LogManager(disk_manager);
+  disk_manager->log_manager_ = log_manager;
+  auto *bpm = new BufferPoolManager(num_pages + 1, disk_manager, 2, log_manager);
+  LockManager lock_manager;
+  TransactionManager txn_manager(&lock_manager, log_manager);
+  CheckpointManager checkpoint_manager(&txn_manager, log_manager, bpm);
+  log_manager->RunFlushThread();
+
+  auto *txn = txn_manager.Begin();
+  std::unordered_map<page_id_t, lsn_t> page_lsns;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  for (int i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    LogRecord record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::NEWPAGE, prev_page_id, page_id);
+    page_lsns[page_id] = log_manager->AppendLogRecord(&record);
+    txn->SetPrevLSN(page_lsns[page_id]);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    prev_page_id = page_id;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  checkpoint_manager.BeginCheckpoint();
+  checkpoint_manager.EndCheckpoint();
+  // The pages are written in batches with a pause between them.
+  EXPECT_GE(std::chrono::steady_clock::now() - start, 2 * checkpoint_flush_interval);
+  EXPECT_TRUE(bpm->GetDirtyPageTable().empty());
+
+  // Write-ahead logging: no page reaches the disk before the log record of its last change.
+  ASSERT_EQ(num_pages, disk_manager->persistent_lsn_at_write_.size());
+  for (const auto &[page_id, lsn] : page_lsns) {
+    EXPECT_GE(disk_manager->persistent_lsn_at_write_[page_id], lsn) << page_id;
+  }
+
+  // Every page is clean, but the transaction is still active: undo may need its records from the first one.
+  EXPECT_EQ(txn->GetFirstLSN(), log_manager->GetTruncatedLSN());
+
+  // Once it commits, nothing before the next checkpoint is needed.
+  txn_manager.Commit(txn);
+  checkpoint_manager.BeginCheckpoint();
+  auto begin_checkpoint_lsn = log_manager->GetNextLSN() - 2;
+  checkpoint_manager.EndCheckpoint();
+  EXPECT_EQ(begin_checkpoint_lsn, log_manager->GetTruncatedLSN());
+
+  log_manager->StopFlushThread();
+
+  // The first checkpoint logged the active transaction and every dirty page.
+  std::vector<char> log(LOG_BUFFER_SIZE);
+  ASSERT_TRUE(disk_manager->ReadLog(log.data(), LOG_BUFFER_SIZE, 0));
+  std::vector<LogRecord> checkpoints;
+  int offset = 0;
+  LogRecord record;
+  while (record.DeserializeFrom(log.data() + offset, LOG_BUFFER_SIZE - offset)) {
+    offset += record.GetSize();
+    if (record.GetLogRecordType() == LogRecordType::BEGIN_CHECKPOINT ||
+        record.GetLogRecordType() == LogRecordType::END_CHECKPOINT) {
+      checkpoints.emplace_back(record);
+    }
+  }
+  ASSERT_EQ(4, checkpoints.size());
+  EXPECT_EQ(LogRecordType::BEGIN_CHECKPOINT, checkpoints[0].GetLogRecordType());
+  ASSERT_EQ(LogRecordType::END_CHECKPOINT, checkpoints[1].GetLogRecordType());
+  EXPECT_EQ(checkpoints[0].GetLSN(), checkpoints[1].GetPrevLSN());
+  ASSERT_EQ(1, checkpoints[1].GetActiveTxnTable().size());
+  EXPECT_EQ(txn->GetTransactionId(), checkpoints[1].GetActiveTxnTable()[0].first);
+  EXPECT_EQ(num_pages, checkpoints[1].GetDirtyPageTable().size());
+  EXPECT_EQ(begin_checkpoint_lsn, checkpoints[2].GetLSN());
+  EXPECT_TRUE(checkpoints[3].GetActiveTxnTable().empty());
+  EXPECT_TRUE(checkpoints[3].GetDirtyPageTable().empty());
+
+  delete txn;
+  delete bpm;
+  delete log_manager;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(CheckpointManagerTest, LogWaitOutsideLatchTest) {
+  GatedLogDiskManager disk_manager;
+  LogManager log_manager(&disk_manager);
+  BufferPoolManager bpm(2, &disk_manager, 2, &log_manager);
+  log_manager.RunFlushThread();
+
+  page_id_t dirty_page_id;
+  page_id_t resident_page_id;
+  ASSERT_NE(nullptr, bpm.NewPage(&dirty_page_id));
+  LogRecord record(0, INVALID_LSN, LogRecordType::NEWPAGE, INVALID_PAGE_ID, dirty_page_id);
+  auto lsn = log_manager.AppendLogRecord(&record);
+  ASSERT_TRUE(bpm.UnpinPage(dirty_page_id, true));
+  ASSERT_NE(nullptr, bpm.NewPage(&resident_page_id));
+
+  // Evicting the dirty page waits for its log record, which cannot reach the disk yet.
+  std::atomic<bool> evicted{false};
+  std::thread evicter([&] {
+    page_id_t page_id;
+    evicted = bpm.NewPage(&page_id) != nullptr;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  // Meanwhile the pages in the pool can still be fetched.
+  auto fetch = std::async(std::launch::async, [&] {
+    auto *page = bpm.FetchPage(resident_page_id);
+    return page != nullptr && bpm.UnpinPage(resident_page_id, false);
+  });
+  auto fetched = fetch.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+  EXPECT_TRUE(fetched);
+  EXPECT_FALSE(evicted);
+  EXPECT_LT(log_manager.GetPersistentLSN(), lsn);
+
+  disk_manager.open_.set_value();
+  evicter.join();
+  EXPECT_TRUE(fetch.get());
+  EXPECT_TRUE(evicted);
+  EXPECT_GE(log_manager.GetPersistentLSN(), lsn);
+  log_manager.StopFlushThread();
+}
+
+}  // namespace bustub
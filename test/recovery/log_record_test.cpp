@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_record_test.cpp
+//
+// Identification: test/recovery/log_record_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "gtest/gtest.h"
+#include "recovery/log_manager.h"
+#include "recovery/log_record.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LogRecordTest, UpdateDeltaTest) {
+  Schema schema{{Column{"id", TypeId::INTEGER}, Column{"name", TypeId::VARCHAR, 64}, Column{"terrier", TypeId::INTEGER},
+                 Column{"padding", TypeId::VARCHAR, 256}}};
+  std::string padding(200, 'x');
+  Tuple old_tuple{{ValueFactory::GetIntegerValue(1), ValueFactory::GetVarcharValue("nft"),
+                   ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue(padding)},
+                  &schema};
+  Tuple new_tuple{{ValueFactory::GetIntegerValue(1), ValueFactory::GetVarcharValue("nft"),
+                   ValueFactory::GetIntegerValue(42), ValueFactory::GetVarcharValue(padding)},
+                  &schema};
+
+  DiskManagerUnlimitedMemory disk_manager;
+  LogManager log_manager(&disk_manager);
+  LogRecord record(3, INVALID_LSN, LogRecordType::UPDATE, RID{5, 2}, old_tuple, new_tuple);
+  auto lsn = log_manager.AppendLogRecord(&record);
+  auto size = record.GetSize();
+
+  // Changing one integer column only logs the bytes that differ, not both images of the row.
+  EXPECT_LT(size, 32);
+  EXPECT_LT(size, old_tuple.GetLength() / 4);
+
+  LogRecord decoded;
+  ASSERT_TRUE(decoded.DeserializeFrom(log_manager.GetLogBuffer(), size));
+  EXPECT_EQ(LogRecordType::UPDATE, decoded.GetLogRecordType());
+  EXPECT_EQ(lsn, decoded.GetLSN());
+  EXPECT_EQ(3, decoded.GetTxnId());
+  EXPECT_EQ(INVALID_LSN, decoded.GetPrevLSN());
+  EXPECT_EQ(RID(5, 2), decoded.GetUpdateRID());
+
+  auto redone = decoded.ApplyUpdate(old_tuple, true);
+  EXPECT_EQ(42, redone.GetValue(&schema, 2).GetAs<int32_t>());
+  EXPECT_EQ(padding, redone.GetValue(&schema, 3).ToString());
+  auto undone = decoded.ApplyUpdate(new_tuple, false);
+  EXPECT_EQ(0, undone.GetValue(&schema, 2).GetAs<int32_t>());
+
+  // A truncated record is rejected.
+  LogRecord truncated;
+  EXPECT_FALSE(truncated.DeserializeFrom(log_manager.GetLogBuffer(), size - 1));
+}
+
+// NOLINTNEXTLINE
+TEST(LogRecordTest, CompactHeaderTest) {
+  DiskManagerUnlimitedMemory disk_manager;
+  LogManager log_manager(&disk_manager);
+  LogRecord begin(1, INVALID_LSN, LogRecordType::BEGIN);
+  auto begin_lsn = log_manager.AppendLogRecord(&begin);
+  // size, lsn, txn id, prev lsn and type all fit in one byte each.
+  EXPECT_EQ(5, begin.GetSize());
+
+  LogRecord decoded;
+  ASSERT_TRUE(decoded.DeserializeFrom(log_manager.GetLogBuffer(), LOG_BUFFER_SIZE));
+  EXPECT_EQ(LogRecordType::BEGIN, decoded.GetLogRecordType());
+  EXPECT_EQ(INVALID_LSN, decoded.GetPrevLSN());
+
+  LogRecord checkpoint(INVALID_TXN_ID, begin_lsn, LogRecordType::END_CHECKPOINT, {{1, 90}, {2, 95}}, {{7, 80}});
+  log_manager.AppendLogRecord(&checkpoint);
+  ASSERT_TRUE(decoded.DeserializeFrom(log_manager.GetLogBuffer() + begin.GetSize(), checkpoint.GetSize()));
+  EXPECT_EQ(begin_lsn, decoded.GetPrevLSN());
+  EXPECT_EQ(INVALID_TXN_ID, decoded.GetTxnId());
+  ASSERT_EQ(2, decoded.GetActiveTxnTable().size());
+  EXPECT_EQ(95, decoded.GetActiveTxnTable()[1].second);
+  ASSERT_EQ(1, decoded.GetDirtyPageTable().size());
+  EXPECT_EQ(7, decoded.GetDirtyPageTable()[0].first);
+}
+
+// NOLINTNEXTLINE
+TEST(LogRecordTest, IdleLogManagerTest) {
+  DiskManagerUnlimitedMemory disk_manager;
+  LogManager running(&disk_manager);
+  running.RunFlushThread();
+  {
+    // Logging is enabled, but this log manager never started a flush thread: there is nothing to stop.
+    LogManager idle(&disk_manager);
+    idle.StopFlushThread();
+  }
+  EXPECT_TRUE(enable_logging);
+  running.StopFlushThread();
+  EXPECT_FALSE(enable_logging);
+}
+
+}  // namespace bustub
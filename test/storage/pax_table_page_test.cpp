@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_table_page_test.cpp
+//
+// Identification: test/storage/pax_table_page_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/page/pax_table_page.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PaxTablePageTest, TableHeapTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  Schema schema{{Column{"id", TypeId::INTEGER}, Column{"name", TypeId::VARCHAR, 64}, Column{"amount", TypeId::BIGINT},
+                 Column{"flag", TypeId::BOOLEAN}}};
+  TableHeap table(bpm.get(), schema, TableFormat::PAX);
+  ASSERT_EQ(TableFormat::PAX, table.GetFormat());
+
+  const int num_tuples = 1000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    auto name = i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                           : ValueFactory::GetVarcharValue(std::string(i % 40, 'a' + i % 26));
+    auto amount = i % 5 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT) : ValueFactory::GetBigIntValue(i * 3);
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), name, amount, ValueFactory::GetBooleanValue(i % 2 == 0)}, &schema};
+    auto rid = table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple);
+    ASSERT_TRUE(rid.has_value());
+    rids.push_back(*rid);
+  }
+  EXPECT_NE(rids.front().GetPageId(), rids.back().GetPageId());
+
+  table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[3]);
+  EXPECT_TRUE(table.GetTupleMeta(rids[3]).is_deleted_);
+  EXPECT_EQ(1, table.GetTupleMeta(rids[3]).version_);
+
+  int i = 0;
+  for (auto iter = table.MakeIterator(); !iter.IsEnd(); ++iter, i++) {
+    ASSERT_EQ(rids[i], iter.GetRID());
+    auto [meta, tuple] = iter.GetTuple();
+    EXPECT_EQ(i == 3, meta.is_deleted_);
+    EXPECT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    EXPECT_EQ(i % 7 == 0, tuple.GetValue(&schema, 1).IsNull());
+    if (i % 7 != 0) {
+      EXPECT_EQ(std::string(i % 40, 'a' + i % 26), tuple.GetValue(&schema, 1).ToString());
+    }
+
+    // Projected reads return only the requested columns, in the requested order.
+    auto [projected_meta, values] = iter.GetValues({2, 0});
+    ASSERT_EQ(2, values.size());
+    EXPECT_EQ(i, values[1].GetAs<int32_t>());
+    EXPECT_EQ(i % 5 == 0, values[0].IsNull());
+    if (i % 5 != 0) {
+      EXPECT_EQ(i * 3, values[0].GetAs<int64_t>());
+    }
+  }
+  EXPECT_EQ(num_tuples, i);
+}
+
+// NOLINTNEXTLINE
+TEST(PaxTablePageTest, LongVarcharTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  Schema schema{{Column{"id", TypeId::INTEGER}, Column{"text", TypeId::VARCHAR, 1024}}};
+  TableHeap table(bpm.get(), schema, TableFormat::PAX);
+
+  // Values longer than expected fill the varlen area before the slots run out, and spill to the next page.
+  std::vector<RID> rids;
+  for (int i = 0; i < 20; i++) {
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(900, 'x'))}, &schema};
+    rids.push_back(*table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple));
+  }
+  EXPECT_GE(rids.back().GetPageId() - rids.front().GetPageId(), 4);
+  for (int i = 0; i < 20; i++) {
+    auto [meta, tuple] = table.GetTuple(rids[i]);
+    EXPECT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    EXPECT_EQ(900, tuple.GetValue(&schema, 1).ToString().size());
+  }
+}
+
+}  // namespace bustub
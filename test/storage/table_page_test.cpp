@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_page_test.cpp
+//
+// Identification: test/storage/table_page_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/page/table_page.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto MakeTuple(const Schema &schema, int32_t id, size_t payload_size) -> Tuple {
+  return Tuple{{ValueFactory::GetIntegerValue(id), ValueFactory::GetVarcharValue(std::string(payload_size, 'x'))},
+               &schema};
+}
+
+auto GetId(const TablePage *page, const Schema &schema, uint16_t slot) -> int32_t {
+  return page->GetTuple(RID{0, slot}).second.GetValue(&schema, 0).GetAs<int32_t>();
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(TablePageTest, CompactionTest) {
+  alignas(8) char data[BUSTUB_PAGE_SIZE]{};
+  auto *page = reinterpret_cast<TablePage *>(data);
+  page->Init();
+  Schema schema{{Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 256}}};
+  TupleMeta live{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  uint16_t num_tuples = 0;
+  while (page->InsertTuple(live, MakeTuple(schema, num_tuples, 100)).has_value()) {
+    num_tuples++;
+  }
+  ASSERT_GT(num_tuples, 10);
+  EXPECT_LT(page->GetFreeSpace(), 200);
+
+  // Deletes that are not committed yet may be rolled back, their space is not reclaimed.
+  for (uint16_t slot = 0; slot < num_tuples; slot += 2) {
+    page->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, 1, true}, RID{0, slot});
+  }
+  EXPECT_EQ(0, page->GetReclaimableSpace());
+  EXPECT_FALSE(page->InsertTuple(live, MakeTuple(schema, num_tuples, 100)).has_value());
+
+  // Nor are deletes whose transaction id has been cleared, only the commit marker makes a delete final.
+  for (uint16_t slot = 0; slot < num_tuples; slot += 2) {
+    page->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, RID{0, slot});
+  }
+  EXPECT_EQ(0, page->GetReclaimableSpace());
+
+  // Once committed, the next insert compacts the page.
+  for (uint16_t slot = 0; slot < num_tuples; slot += 2) {
+    page->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true, true}, RID{0, slot});
+  }
+  EXPECT_GT(page->GetReclaimableSpace(), 100U * (num_tuples / 2));
+  auto slot = page->InsertTuple(live, MakeTuple(schema, num_tuples, 100));
+  ASSERT_TRUE(slot.has_value());
+  EXPECT_EQ(num_tuples, *slot);
+  EXPECT_EQ(0, page->GetReclaimableSpace());
+
+  // The RIDs of the remaining tuples still lead to them.
+  for (uint16_t slot = 1; slot < num_tuples; slot += 2) {
+    EXPECT_EQ(slot, GetId(page, schema, slot));
+  }
+  EXPECT_EQ(num_tuples, GetId(page, schema, num_tuples));
+  EXPECT_TRUE(page->GetTupleMeta(RID{0, 0}).is_deleted_);
+  EXPECT_EQ(0, page->GetTuple(RID{0, 0}).second.GetLength());
+}
+
+// NOLINTNEXTLINE
+TEST(TablePageTest, CompactThenRollbackTest) {
+  alignas(8) char data[BUSTUB_PAGE_SIZE]{};
+  auto *page = reinterpret_cast<TablePage *>(data);
+  page->Init();
+  Schema schema{{Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 256}}};
+  TupleMeta live{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  uint16_t num_tuples = 0;
+  while (page->InsertTuple(live, MakeTuple(schema, num_tuples, 100)).has_value()) {
+    num_tuples++;
+  }
+  ASSERT_GT(num_tuples, 4);
+
+  // Slot 0 is deleted by a committed transaction, slot 1 by one that is still running and does not record its id.
+  page->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true, true}, RID{0, 0});
+  page->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, RID{0, 1});
+  ASSERT_TRUE(page->InsertTuple(live, MakeTuple(schema, num_tuples, 100)).has_value());
+  EXPECT_EQ(0, page->GetTuple(RID{0, 0}).second.GetLength());
+
+  // The running transaction rolls back, its tuple survived the compaction.
+  page->UpdateTupleMeta(live, RID{0, 1});
+  EXPECT_FALSE(page->GetTupleMeta(RID{0, 1}).is_deleted_);
+  for (uint16_t slot = 1; slot <= num_tuples; slot++) {
+    EXPECT_EQ(slot, GetId(page, schema, slot));
+  }
+  EXPECT_EQ(100, page->GetTuple(RID{0, 1}).second.GetValue(&schema, 1).GetLength() - 1);
+
+  // A commit marker is dropped with the delete it belongs to.
+  page->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false, true}, RID{0, 2});
+  EXPECT_FALSE(page->GetTupleMeta(RID{0, 2}).delete_committed_);
+}
+
+// NOLINTNEXTLINE
+TEST(TablePageTest, UpdateTest) {
+  alignas(8) char data[BUSTUB_PAGE_SIZE]{};
+  auto *page = reinterpret_cast<TablePage *>(data);
+  page->Init();
+  Schema schema{{Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 2048}}};
+  TupleMeta live{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  ASSERT_EQ(0, page->InsertTuple(live, MakeTuple(schema, 0, 10)));
+  ASSERT_EQ(1, page->InsertTuple(live, MakeTuple(schema, 1, 10)));
+
+  // Grow into the free space, then shrink in place.
+  ASSERT_TRUE(page->UpdateTuple(live, MakeTuple(schema, 10, 1000), RID{0, 0}));
+  EXPECT_EQ(1000, page->GetTuple(RID{0, 0}).second.GetValue(&schema, 1).GetLength() - 1);
+  EXPECT_EQ(1, page->GetTupleMeta(RID{0, 0}).version_);
+  auto free_space = page->GetFreeSpace();
+  ASSERT_TRUE(page->UpdateTuple(live, MakeTuple(schema, 20, 500), RID{0, 0}));
+  EXPECT_EQ(free_space, page->GetFreeSpace());
+  EXPECT_GE(page->GetReclaimableSpace(), 500);
+
+  // Fill the page, growing the tuple now needs a compaction.
+  ASSERT_TRUE(page->InsertTuple(live, MakeTuple(schema, 2, 2000)).has_value());
+  ASSERT_LT(page->GetFreeSpace(), 1000);
+  ASSERT_TRUE(page->UpdateTuple(live, MakeTuple(schema, 30, 1500), RID{0, 0}));
+  EXPECT_EQ(30, GetId(page, schema, 0));
+  EXPECT_EQ(1, GetId(page, schema, 1));
+  EXPECT_EQ(2, GetId(page, schema, 2));
+  EXPECT_EQ(0, page->GetReclaimableSpace());
+
+  // There is no room left, nothing changes.
+  EXPECT_FALSE(page->UpdateTuple(live, MakeTuple(schema, 40, 2040), RID{0, 1}));
+  EXPECT_EQ(1, GetId(page, schema, 1));
+  EXPECT_EQ(0, page->GetTupleMeta(RID{0, 1}).version_);
+}
+
+}  // namespace bustub
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_view_test.cpp
+//
+// Identification: test/storage/tuple_view_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TupleViewTest, ScanFilterTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  Schema schema{{Column{"id", TypeId::INTEGER}, Column{"name", TypeId::VARCHAR, 32}, Column{"score", TypeId::BIGINT}}};
+  TableHeap table(bpm.get(), schema, TableFormat::ROW);
+
+  const int num_tuples = 1000;
+  for (int i = 0; i < num_tuples; i++) {
+    auto score = i % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT) : ValueFactory::GetBigIntValue(i);
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue("name" + std::to_string(i)), score},
+                &schema};
+    table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple);
+  }
+
+  // id + 1 > 900
+  auto one = std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(1));
+  auto id_plus_one = std::make_shared<ArithmeticExpression>(
+      std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER), one, ArithmeticType::Plus);
+  auto filter = std::make_shared<ComparisonExpression>(
+      id_plus_one, std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(900)),
+      ComparisonType::GreaterThan);
+
+  std::vector<Tuple> survivors;
+  for (auto iter = table.MakeIterator(); !iter.IsEnd(); ++iter) {
+    auto view = iter.GetTupleView();
+    auto id = view.GetAs<int32_t>(&schema, 0);
+    EXPECT_EQ(id % 10 == 0, view.IsNull(&schema, 2));
+    EXPECT_EQ("name" + std::to_string(id), view.GetValue(&schema, 1).ToString());
+    if (filter->EvaluateView(view, schema).GetAs<bool>()) {
+      survivors.emplace_back(view.ToTuple());
+    }
+  }
+
+  ASSERT_EQ(100, survivors.size());
+  for (const auto &tuple : survivors) {
+    auto [meta, stored] = table.GetTuple(tuple.GetRid());
+    ASSERT_EQ(stored.GetLength(), tuple.GetLength());
+    EXPECT_EQ(0, memcmp(stored.GetData(), tuple.GetData(), tuple.GetLength()));
+    EXPECT_GE(tuple.GetValue(&schema, 0).GetAs<int32_t>(), 900);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map_test.cpp
+//
+// Identification: test/storage/zone_map_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/zone_map.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto Compare(uint32_t col_idx, ComparisonType comp_type, int32_t constant) -> AbstractExpressionRef {
+  return std::make_shared<ComparisonExpression>(std::make_shared<ColumnValueExpression>(0, col_idx, TypeId::INTEGER),
+                                                std::make_shared<ConstantValueExpression>(
+                                                    ValueFactory::GetIntegerValue(constant)),
+                                                comp_type);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(ZoneMapTest, MayMatchTest) {
+  Schema schema{{Column{"ts", TypeId::INTEGER}, Column{"v", TypeId::INTEGER}}};
+  ZoneMap zone_map(schema.GetColumnCount());
+  for (int i = 10; i < 20; i++) {
+    zone_map.Update(schema, Tuple{{ValueFactory::GetIntegerValue(i),
+                                   ValueFactory::GetNullValueByType(TypeId::INTEGER)},
+                                  &schema});
+  }
+  EXPECT_EQ(10, zone_map.GetColumnZone(0).min_->GetAs<int32_t>());
+  EXPECT_EQ(19, zone_map.GetColumnZone(0).max_->GetAs<int32_t>());
+  EXPECT_EQ(10, zone_map.GetColumnZone(1).null_count_);
+
+  EXPECT_TRUE(zone_map.MayMatch(*Compare(0, ComparisonType::Equal, 15)));
+  EXPECT_FALSE(zone_map.MayMatch(*Compare(0, ComparisonType::Equal, 20)));
+  EXPECT_FALSE(zone_map.MayMatch(*Compare(0, ComparisonType::LessThan, 10)));
+  EXPECT_TRUE(zone_map.MayMatch(*Compare(0, ComparisonType::LessThanOrEqual, 10)));
+  EXPECT_FALSE(zone_map.MayMatch(*Compare(0, ComparisonType::GreaterThan, 19)));
+  EXPECT_TRUE(zone_map.MayMatch(*Compare(0, ComparisonType::NotEqual, 19)));
+  // The column only holds nulls, no comparison on it can be true.
+  EXPECT_FALSE(zone_map.MayMatch(*Compare(1, ComparisonType::NotEqual, 0)));
+
+  // `5 < ts` is `ts > 5`.
+  ComparisonExpression flipped(std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(25)),
+                               std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER),
+                               ComparisonType::LessThan);
+  EXPECT_FALSE(zone_map.MayMatch(flipped));
+
+  LogicExpression both(Compare(0, ComparisonType::GreaterThan, 12), Compare(0, ComparisonType::LessThan, 5),
+                       LogicType::And);
+  EXPECT_FALSE(zone_map.MayMatch(both));
+  LogicExpression either(Compare(0, ComparisonType::GreaterThan, 12), Compare(0, ComparisonType::LessThan, 5),
+                         LogicType::Or);
+  EXPECT_TRUE(zone_map.MayMatch(either));
+}
+
+// NOLINTNEXTLINE
+TEST(ZoneMapTest, ScanSkippingTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  Schema schema{{Column{"ts", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64}}};
+  TableHeap table(bpm.get(), schema, TableFormat::ROW);
+
+  // A time-ordered, append-only table.
+  const int num_tuples = 5000;
+  std::set<page_id_t> all_pages;
+  for (int i = 0; i < num_tuples; i++) {
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue("some payload")}, &schema};
+    all_pages.insert(table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple)->GetPageId());
+  }
+  ASSERT_GT(all_pages.size(), 10);
+
+  auto filter = std::make_shared<LogicExpression>(Compare(0, ComparisonType::GreaterThanOrEqual, 2000),
+                                                  Compare(0, ComparisonType::LessThan, 2100), LogicType::And);
+  auto check_scan = [&](TableIterator iter) {
+    std::set<page_id_t> visited;
+    int matches = 0;
+    for (; !iter.IsEnd(); ++iter) {
+      visited.insert(iter.GetRID().GetPageId());
+      auto [meta, tuple] = iter.GetTuple();
+      if (filter->Evaluate(&tuple, schema).GetAs<bool>()) {
+        matches++;
+      }
+    }
+    EXPECT_EQ(100, matches);
+    EXPECT_LE(visited.size(), 3);
+  };
+  check_scan(table.MakeIterator(filter.get()));
+  check_scan(table.MakeEagerIterator(filter.get()));
+
+  // Nothing matches, so nothing is fetched.
+  auto none = Compare(0, ComparisonType::GreaterThan, num_tuples);
+  EXPECT_TRUE(table.MakeIterator(none.get()).IsEnd());
+}
+
+}  // namespace bustub
@@ -21,8 +21,39 @@
 #include "logging/common.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TupleTest, NullBitmapTest) {
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 32}, Column{"c", TypeId::BIGINT},
+                 Column{"d", TypeId::VARCHAR, 32}, Column{"e", TypeId::BOOLEAN}}};
+  Tuple tuple{{ValueFactory::GetIntegerValue(42), ValueFactory::GetNullValueByType(TypeId::VARCHAR),
+               ValueFactory::GetNullValueByType(TypeId::BIGINT), ValueFactory::GetVarcharValue("terrier"),
+               ValueFactory::GetBooleanValue(true)},
+              &schema};
+
+  // Fixed-size part, one byte of null bitmap, and "terrier" with its terminator: no length prefix, no null payload.
+  EXPECT_EQ(schema.GetLength() + 1 + 8, tuple.GetLength());
+
+  EXPECT_FALSE(tuple.IsNull(&schema, 0));
+  EXPECT_TRUE(tuple.IsNull(&schema, 1));
+  EXPECT_TRUE(tuple.IsNull(&schema, 2));
+  EXPECT_FALSE(tuple.IsNull(&schema, 3));
+  EXPECT_TRUE(tuple.GetValue(&schema, 1).IsNull());
+  EXPECT_TRUE(tuple.GetValue(&schema, 2).IsNull());
+  EXPECT_EQ("terrier", tuple.GetValue(&schema, 3).ToString());
+  EXPECT_EQ(42, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+  EXPECT_EQ(42, tuple.GetAs<int32_t>(&schema, 0));
+  EXPECT_EQ(1, tuple.GetAs<int8_t>(&schema, 4));
+
+  // Key tuples keep the columns at the schema offsets.
+  Schema key_schema{{Column{"a", TypeId::INTEGER}, Column{"c", TypeId::BIGINT}}};
+  auto key = tuple.KeyFromTuple(schema, key_schema, {0, 2});
+  EXPECT_EQ(42, Tuple::ValueAt(key.GetData(), &key_schema, 0).GetAs<int32_t>());
+  EXPECT_TRUE(Tuple::ValueAt(key.GetData(), &key_schema, 1).IsNull());
+}
 // NOLINTNEXTLINE
 TEST(TupleTest, DISABLED_TableHeapTest) {
   // test1: parse create sql statement
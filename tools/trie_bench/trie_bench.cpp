@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "fmt/format.h"
+#include "primer/trie_store.h"
+
+static const uint32_t NUM_KEYS = 10000;
+
+void FillStore(bustub::TrieStore *store) {
+  for (uint32_t i = 0; i < NUM_KEYS; i++) {
+    store->Put<uint32_t>(fmt::format("key-{:#08}", i), i);
+  }
+}
+
+/** Measures the read throughput of 1, 2, 4... reader threads. */
+void ReadScaling(uint32_t max_threads, uint32_t reads_per_thread) {
+  auto store = bustub::TrieStore();
+  FillStore(&store);
+  std::vector<std::string> keys;
+  keys.reserve(NUM_KEYS);
+  for (uint32_t i = 0; i < NUM_KEYS; i++) {
+    keys.push_back(fmt::format("key-{:#08}", i));
+  }
+
+  for (uint32_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([&store, &keys, tid, reads_per_thread] {
+        for (uint32_t i = 0; i < reads_per_thread; i++) {
+          auto idx = (i * 7 + tid) % keys.size();
+          auto guard = store.Get<uint32_t>(keys[idx]);
+          if (!guard.has_value() || **guard != idx) {
+            fmt::print(stderr, "[error] wrong value for {}\n", keys[idx]);
+            std::terminate();
+          }
+        }
+      });
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    fmt::print("{} reader thread(s): {:.2f} Mops/s\n", num_threads,
+               static_cast<double>(num_threads * reads_per_thread) / std::max<int64_t>(elapsed.count(), 1));
+  }
+}
+
+/** Measures the latency of every Get while a writer rewrites long keys as fast as it can. */
+void ReadLatencyUnderWrite(uint32_t num_reads) {
+  auto store = bustub::TrieStore();
+  FillStore(&store);
+
+  std::atomic<bool> stop{false};
+  std::thread writer([&store, &stop] {
+    std::string padding(256, 'x');
+    for (uint32_t i = 0; !stop; i++) {
+      store.Put<std::string>(fmt::format("write-{}-{}", i % 1000, padding), padding);
+    }
+  });
+
+  std::vector<int64_t> latency_ns;
+  latency_ns.reserve(num_reads);
+  for (uint32_t i = 0; i < num_reads; i++) {
+    auto key = fmt::format("key-{:#08}", i % NUM_KEYS);
+    auto start = std::chrono::steady_clock::now();
+    auto guard = store.Get<uint32_t>(key);
+    auto end = std::chrono::steady_clock::now();
+    latency_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+  }
+  stop = true;
+  writer.join();
+
+  std::sort(latency_ns.begin(), latency_ns.end());
+  fmt::print("Get latency under write load: p50={}ns p99={}ns p99.9={}ns max={}ns\n",
+             latency_ns[latency_ns.size() / 2], latency_ns[latency_ns.size() * 99 / 100],
+             latency_ns[latency_ns.size() * 999 / 1000], latency_ns.back());
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-trie-bench");
+  program.add_argument("--threads").help("run the read scaling bench with up to n reader threads");
+  program.add_argument("--reads").help("number of reads per thread");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint32_t max_threads = 4;
+  if (program.present("--threads")) {
+    max_threads = std::stoi(program.get("--threads"));
+  }
+
+  uint32_t reads = 200000;
+  if (program.present("--reads")) {
+    reads = std::stoi(program.get("--reads"));
+  }
+
+  fmt::print(stderr, "[info] keys={}, max_threads={}, reads={}\n", NUM_KEYS, max_threads, reads);
+  ReadScaling(max_threads, reads);
+  ReadLatencyUnderWrite(reads);
+  return 0;
+}